@@ -0,0 +1,6 @@
+#version 120
+
+// Particle fragment shader - passes the per-vertex speed color through
+void main() {
+    gl_FragColor = gl_Color;
+}
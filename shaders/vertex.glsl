@@ -0,0 +1,8 @@
+#version 120
+
+// Particle vertex shader. GLSL 1.20 keeps it usable on the legacy
+// (compatibility) contexts the renderer creates on macOS.
+void main() {
+    gl_Position = gl_ModelViewProjectionMatrix * gl_Vertex;
+    gl_FrontColor = gl_Color;
+}
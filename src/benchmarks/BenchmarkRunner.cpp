@@ -0,0 +1,1342 @@
+#include "BenchmarkRunner.h"
+#include "DifferentialValidator.h"
+#include "Roofline.h"
+#include "Scenarios.h"
+#include "../optimization/RadixSort.h"
+#include "../physics/BatchedWorldEngine.h"
+#include "../physics/DeterministicPhysicsEngine.h"
+#include "../physics/Dsmc.h"
+#include "../physics/EventDrivenEngine.h"
+#include "../physics/FlipFluid.h"
+#include "../physics/LangevinThermostat.h"
+#include "../physics/LatticeBoltzmann.h"
+#include "../physics/MultipleTimeStepping.h"
+#include "../physics/LennardJones.h"
+#include "../physics/PhysicsEngine.h"
+#include "../physics/SignedDistanceField.h"
+#include "../physics/SpringNetwork.h"
+#include "../utils/CounterRNG.h"
+#include "../utils/PerformanceProfiler.h"
+#include "../utils/ThreadPool.h"
+#include "../utils/TscClock.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <new>
+#include <random>
+#include <thread>
+
+namespace {
+
+double elapsedMs(std::chrono::high_resolution_clock::time_point start) {
+    auto now = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<double, std::milli>(now - start).count();
+}
+
+// Times RadixSorter::sortPairs against std::sort on (key, payload) records
+template <typename Key>
+bool benchmarkRadixSize(size_t count, const char* keyLabel) {
+    std::mt19937_64 generator(12345 + count);
+    std::vector<Key> keys(count);
+    std::vector<uint32_t> values(count);
+    for (size_t i = 0; i < count; ++i) {
+        keys[i] = static_cast<Key>(generator());
+        values[i] = static_cast<uint32_t>(i);
+    }
+
+    struct Record {
+        Key key;
+        uint32_t value;
+    };
+    std::vector<Record> records(count);
+    for (size_t i = 0; i < count; ++i) {
+        records[i] = {keys[i], values[i]};
+    }
+
+    RadixSorter<Key, uint32_t> sorter;
+    auto start = std::chrono::high_resolution_clock::now();
+    sorter.sortPairs(keys, values);
+    double radixMs = elapsedMs(start);
+
+    start = std::chrono::high_resolution_clock::now();
+    std::sort(records.begin(), records.end(), [](const Record& a, const Record& b) { return a.key < b.key; });
+    double stdMs = elapsedMs(start);
+
+    // Keys must match std::sort exactly; payloads must still belong to their keys
+    bool correct = true;
+    for (size_t i = 0; i < count && correct; ++i) {
+        correct = keys[i] == records[i].key && (i == 0 || keys[i - 1] <= keys[i]);
+    }
+
+    std::cout << std::setw(6) << keyLabel
+              << std::setw(12) << count
+              << std::setw(14) << std::fixed << std::setprecision(2) << radixMs
+              << std::setw(14) << stdMs
+              << std::setw(12) << (count / (radixMs * 1e3))
+              << std::setw(10) << std::setprecision(2) << (stdMs / radixMs) << "x"
+              << (correct ? "" : "  MISMATCH") << std::endl;
+    return correct;
+}
+
+// Average cost of one PROFILE_SCOPE in ns. Scopes run in batches with a flush
+// in between (outside the timed region), as they would across frames.
+double measureScopeCost(PerformanceProfiler* profiler, size_t iterations) {
+    const size_t batch = 1000;
+    double totalNs = 0.0;
+    for (size_t done = 0; done < iterations; done += batch) {
+        auto start = std::chrono::high_resolution_clock::now();
+        for (size_t i = 0; i < batch; ++i) {
+            PROFILE_SCOPE(profiler, "timer_bench_scope");
+        }
+        totalNs += elapsedMs(start) * 1e6;
+        if (profiler) profiler->flush();
+    }
+    return totalNs / iterations;
+}
+
+// Reference static collision pass: every particle tested against every wall
+// capsule, with the same response as SignedDistanceField::collide
+size_t collideSegments(ParticleSystem& system, const std::vector<SignedDistanceField::Segment>& segments, float damping) {
+    size_t contacts = 0;
+    for (auto& particle : system.getParticles()) {
+        bool touched = false;
+        for (const auto& segment : segments) {
+            glm::vec2 ab = segment.b - segment.a;
+            float lengthSq = glm::dot(ab, ab);
+            float t = lengthSq > 0.0f ? glm::clamp(glm::dot(particle.position - segment.a, ab) / lengthSq, 0.0f, 1.0f) : 0.0f;
+            glm::vec2 offset = particle.position - (segment.a + ab * t);
+            float length = glm::length(offset);
+            float penetration = segment.halfThickness + particle.radius - length;
+            if (penetration <= 0.0f || length == 0.0f) continue;
+            touched = true;
+
+            glm::vec2 normal = offset / length;
+            particle.position += normal * penetration;
+            float velAlongNormal = glm::dot(particle.velocity, normal);
+            if (velAlongNormal < 0.0f) {
+                particle.velocity -= (1.0f + damping) * velAlongNormal * normal;
+            }
+        }
+        if (touched) contacts++;
+    }
+    return contacts;
+}
+
+} // namespace
+
+BenchmarkRunner::BenchmarkRunner() {
+}
+
+int BenchmarkRunner::run(const std::string& name, const std::vector<std::string>& args) {
+    if (name == "radix") return runRadixSort(args);
+    if (name == "determinism") return runDeterminism(args);
+    if (name == "lj") return runLennardJones(args);
+    if (name == "worlds") return runBatchedWorlds(args);
+    if (name == "timer") return runTimer(args);
+    if (name == "scenarios") return runScenarios(args);
+    if (name == "roofline") return runRoofline(args);
+    if (name == "validate") return runValidation(args);
+    if (name == "sdf") return runStaticField(args);
+    if (name == "springs") return runSprings(args);
+    if (name == "flip") return runFlipFluid(args);
+    if (name == "edmd") return runEventDriven(args);
+    if (name == "dsmc") return runDsmc(args);
+    if (name == "langevin") return runLangevin(args);
+    if (name == "lbm") return runLatticeBoltzmann(args);
+    if (name == "respa") return runMultipleTimeStepping(args);
+    if (name == "filters") return runCollisionFilters(args);
+
+    std::cerr << "Unknown benchmark: " << name << std::endl;
+    printUsage();
+    return 1;
+}
+
+void BenchmarkRunner::printUsage() const {
+    std::cout << "Benchmarks (--bench <name> [args]):" << std::endl;
+    std::cout << "  radix [max_elements]    LSD radix sort vs std::sort, 10^4 up to max (default 10^8)" << std::endl;
+    std::cout << "  determinism [n] [steps] Fixed-point run; compare the printed hash across machines" << std::endl;
+    std::cout << "  lj [n] [steps]          Lennard-Jones MD (gas, liquid, dense), pair interactions per second" << std::endl;
+    std::cout << "  worlds [w] [n] [steps]  Batched small worlds vs one PhysicsEngine per world, world-steps per second" << std::endl;
+    std::cout << "  scenarios [name]        Golden production-like scenarios with reference metrics (default: all)" << std::endl;
+    std::cout << "  roofline [n] [steps]    Machine peak GB/s and GFLOP/s vs each PhysicsEngine kernel (default 10^6, 20)" << std::endl;
+    std::cout << "  validate [cases] [n] [steps]  Optimized paths vs their brute-force reference: correctness and speedup" << std::endl;
+    std::cout << "  sdf [n] [walls]         Distance-field static collisions vs a test per wall segment (default 10^6, 256)" << std::endl;
+    std::cout << "  springs [side] [steps]  Stiff cloth at 1/60 s: implicit Euler + PCG vs explicit substepping (default 100, 120)" << std::endl;
+    std::cout << "  flip [n] [steps]        FLIP dam break: multigrid vs Jacobi preconditioned pressure solve (default 10^6, 30)" << std::endl;
+    std::cout << "  edmd [n] [frames]       Dilute hard-disk gas: event-driven vs time-stepped at 1/60 s and 1/960 s (default 10^5, 120)" << std::endl;
+    std::cout << "  dsmc [n] [steps]        Rarefied gas by DSMC: phase timings, collision rate vs theory, thread-count determinism (default 10^7, 20)" << std::endl;
+    std::cout << "  langevin [n] [steps]    Gaussian noise (std::normal_distribution vs SIMD counter-based) and thermostat temperature (default 10^6, 200)" << std::endl;
+    std::cout << "  lbm [side] [steps]      D2Q9 lattice Boltzmann: bandwidth vs STREAM, Poiseuille error, coupling momentum (default 2048, 50)" << std::endl;
+    std::cout << "  respa [n] [steps]       Multiple time stepping: all-pairs gravity every k steps, cost and energy drift vs k (default 4000, 480)" << std::endl;
+    std::cout << "  filters [n] [steps]     Collision groups/masks: 10% solids, 90% tracers that skip each other or collide with nothing (default 200000, 20)" << std::endl;
+    std::cout << "  timer [iterations]      Clock read and PROFILE_SCOPE cost, chrono vs TSC timer source" << std::endl;
+}
+
+int BenchmarkRunner::runRadixSort(const std::vector<std::string>& args) {
+    size_t maxElements = parseSize(args, 0, 100000000);
+
+    std::cout << "=== Radix Sort Benchmark (" << ThreadPool::shared().getThreadCount() << " threads) ===" << std::endl;
+    std::cout << std::setw(6) << "key" << std::setw(12) << "elements" << std::setw(14) << "radix ms"
+              << std::setw(14) << "std::sort ms" << std::setw(12) << "Mkeys/s" << std::setw(11) << "speedup" << std::endl;
+
+    bool allCorrect = true;
+    for (size_t count = 10000; count <= maxElements; count *= 10) {
+        try {
+            allCorrect &= benchmarkRadixSize<uint32_t>(count, "u32");
+            allCorrect &= benchmarkRadixSize<uint64_t>(count, "u64");
+        } catch (const std::bad_alloc&) {
+            std::cout << "Skipping " << count << " elements and above: not enough memory" << std::endl;
+            break;
+        }
+    }
+
+    return allCorrect ? 0 : 1;
+}
+
+int BenchmarkRunner::runDeterminism(const std::vector<std::string>& args) {
+    size_t particleCount = parseSize(args, 0, 2000);
+    size_t steps = parseSize(args, 1, 1000);
+
+    // Initial state comes straight from integer RNG output (mt19937_64 is fully
+    // specified by the standard), so no float conversion is involved at all
+    DeterministicPhysicsEngine engine;
+    engine.setTimeStep(1.0f / 60.0f);
+    engine.setGravity(glm::vec2(0.0f, -9.81f));
+    engine.setCollisionDamping(0.8f);
+    engine.setBounds(glm::vec2(-100.0f, -100.0f), glm::vec2(100.0f, 100.0f));
+
+    std::mt19937_64 generator(20240601);
+    auto uniformRaw = [&generator](int64_t minValue, int64_t maxValue) {
+        uint64_t range = static_cast<uint64_t>(maxValue - minValue);
+        return minValue + static_cast<int64_t>(generator() % range);
+    };
+    for (size_t i = 0; i < particleCount; ++i) {
+        engine.addParticle(uniformRaw(FixedPoint::fromInt(-95), FixedPoint::fromInt(95)),
+                           uniformRaw(FixedPoint::fromInt(-95), FixedPoint::fromInt(95)),
+                           uniformRaw(FixedPoint::fromInt(-5), FixedPoint::fromInt(5)),
+                           uniformRaw(FixedPoint::fromInt(-5), FixedPoint::fromInt(5)),
+                           uniformRaw(FixedPoint::ONE / 2, FixedPoint::fromInt(2)),
+                           uniformRaw(FixedPoint::ONE / 2, FixedPoint::ONE * 3 / 2));
+    }
+
+    auto start = std::chrono::high_resolution_clock::now();
+    for (size_t step = 0; step < steps; ++step) {
+        engine.step();
+    }
+    double totalMs = elapsedMs(start);
+
+    std::cout << "=== Determinism Check ===" << std::endl;
+    std::cout << "Particles: " << particleCount << ", steps: " << steps << std::endl;
+    std::cout << "Step time: " << std::fixed << std::setprecision(3) << (totalMs / std::max<size_t>(1, steps)) << " ms" << std::endl;
+    std::cout << "State hash: 0x" << std::hex << std::setw(16) << std::setfill('0') << engine.computeStateHash()
+              << std::dec << std::setfill(' ') << std::endl;
+    std::cout << "Identical hashes on two machines mean bitwise-identical trajectories." << std::endl;
+    return 0;
+}
+
+int BenchmarkRunner::runLennardJones(const std::vector<std::string>& args) {
+    size_t particleCount = parseSize(args, 0, 100000);
+    size_t steps = parseSize(args, 1, 200);
+
+    // Reduced LJ units, cutoff 2.5 sigma, skin 0.3 sigma, dt 0.005 tau: the
+    // usual LJ-liquid benchmark settings, run in 2D at three densities
+    struct Workload {
+        const char* name;
+        float density;
+        float temperature;
+    };
+    const Workload workloads[] = {
+        {"gas", 0.10f, 2.0f},
+        {"liquid", 0.70f, 1.0f},
+        {"dense", 0.90f, 0.5f},
+    };
+
+    std::cout << "=== Lennard-Jones MD Benchmark (" << ThreadPool::shared().getThreadCount() << " threads) ===" << std::endl;
+    std::cout << "Particles: " << particleCount << ", steps: " << steps << ", rc = 2.5, skin = 0.3, dt = 0.005" << std::endl;
+    std::cout << std::setw(8) << "system" << std::setw(10) << "density" << std::setw(12) << "ms/step"
+              << std::setw(14) << "Mpairs/s" << std::setw(14) << "pairs/atom" << std::setw(10) << "rebuilds"
+              << std::setw(14) << "energy drift" << std::endl;
+
+    for (const Workload& workload : workloads) {
+        LennardJonesEngine engine;
+        engine.setPotential(1.0f, 1.0f, 2.5f);
+        engine.setSkin(0.3f);
+        engine.setTimeStep(0.005f);
+        engine.createLattice(particleCount, workload.density, workload.temperature, 2024);
+
+        // Settle the lattice before measuring
+        for (int i = 0; i < 20; ++i) engine.step();
+        double initialEnergy = engine.getTotalEnergy();
+        size_t initialBuilds = engine.getNeighborListBuildCount();
+
+        size_t pairs = 0;
+        auto start = std::chrono::high_resolution_clock::now();
+        for (size_t step = 0; step < steps; ++step) {
+            engine.step();
+            pairs += engine.getNeighborPairCount();
+        }
+        double totalMs = elapsedMs(start);
+        double drift = std::abs(engine.getTotalEnergy() - initialEnergy) / std::max(std::abs(initialEnergy), 1e-12);
+
+        std::cout << std::setw(8) << workload.name
+                  << std::setw(10) << std::fixed << std::setprecision(2) << workload.density
+                  << std::setw(12) << std::setprecision(3) << (totalMs / std::max<size_t>(1, steps))
+                  << std::setw(14) << std::setprecision(1) << (pairs / (totalMs * 1e3))
+                  << std::setw(14) << std::setprecision(1) << (static_cast<double>(engine.getNeighborPairCount()) / particleCount)
+                  << std::setw(10) << (engine.getNeighborListBuildCount() - initialBuilds)
+                  << std::setw(14) << std::scientific << std::setprecision(2) << drift
+                  << std::defaultfloat << std::endl;
+    }
+
+    return 0;
+}
+
+int BenchmarkRunner::runBatchedWorlds(const std::vector<std::string>& args) {
+    size_t worldCount = parseSize(args, 0, 4096);
+    size_t particlesPerWorld = parseSize(args, 1, 32);
+    size_t steps = parseSize(args, 2, 1000);
+    const float timeStep = 1.0f / 60.0f;
+    const glm::vec2 minBounds(-10.0f, -10.0f);
+    const glm::vec2 maxBounds(10.0f, 10.0f);
+
+    BatchedWorldEngine batched(worldCount, particlesPerWorld);
+    batched.setTimeStep(timeStep);
+    batched.setBounds(minBounds, maxBounds);
+    batched.reset(7);
+
+    // Reference: the same initial state as one ParticleSystem + brute-force engine per world
+    std::vector<ParticleSystem> systems(worldCount);
+    for (size_t w = 0; w < worldCount; ++w) {
+        for (size_t p = 0; p < particlesPerWorld; ++p) {
+            size_t index = p * worldCount + w;
+            Particle particle(glm::vec2(batched.getPositionsX()[index], batched.getPositionsY()[index]), batched.getMasses()[index]);
+            particle.velocity = glm::vec2(batched.getVelocitiesX()[index], batched.getVelocitiesY()[index]);
+            particle.radius = batched.getRadii()[index];
+            systems[w].addParticle(particle);
+        }
+    }
+    PhysicsEngine engine;
+    engine.setBroadPhase(CollisionBroadPhase::BruteForce);
+
+    std::cout << "=== Batched Worlds Benchmark (" << ThreadPool::shared().getThreadCount() << " threads) ===" << std::endl;
+    std::cout << "Worlds: " << worldCount << ", particles/world: " << particlesPerWorld << ", steps: " << steps << std::endl;
+
+    auto start = std::chrono::high_resolution_clock::now();
+    size_t loopContacts = 0;
+    for (size_t step = 0; step < steps; ++step) {
+        for (ParticleSystem& system : systems) {
+            engine.applyBoundaryConstraints(system, minBounds, maxBounds);
+            engine.integrateParticles(system, timeStep);
+            loopContacts += engine.getLastContactCount();
+        }
+    }
+    double loopMs = elapsedMs(start);
+
+    start = std::chrono::high_resolution_clock::now();
+    size_t batchedContacts = 0;
+    for (size_t step = 0; step < steps; ++step) {
+        batched.step();
+        batchedContacts += batched.getLastContactCount();
+    }
+    double batchedMs = elapsedMs(start);
+
+    // Both engines apply the same model; rounding differs slightly in the collision
+    // normal and the trajectories are chaotic, so expect agreement only for short runs
+    float maxError = 0.0f;
+    for (size_t w = 0; w < worldCount; ++w) {
+        const auto& particles = systems[w].getParticles();
+        for (size_t p = 0; p < particlesPerWorld; ++p) {
+            size_t index = p * worldCount + w;
+            glm::vec2 batchedPosition(batched.getPositionsX()[index], batched.getPositionsY()[index]);
+            maxError = std::max(maxError, glm::length(batchedPosition - particles[p].position));
+        }
+    }
+
+    double worldSteps = static_cast<double>(worldCount) * steps;
+    std::cout << std::setw(14) << "engine" << std::setw(12) << "total ms" << std::setw(18) << "Mworld-steps/s"
+              << std::setw(14) << "contacts" << std::endl;
+    std::cout << std::setw(14) << "per-world" << std::setw(12) << std::fixed << std::setprecision(1) << loopMs
+              << std::setw(18) << std::setprecision(3) << (worldSteps / (loopMs * 1e3))
+              << std::setw(14) << loopContacts << std::endl;
+    std::cout << std::setw(14) << "batched" << std::setw(12) << std::setprecision(1) << batchedMs
+              << std::setw(18) << std::setprecision(3) << (worldSteps / (batchedMs * 1e3))
+              << std::setw(14) << batchedContacts << std::endl;
+    std::cout << "Speedup: " << std::setprecision(2) << (loopMs / batchedMs) << "x" << std::endl;
+    std::cout << "Max position difference after " << steps << " steps: " << std::scientific << std::setprecision(2)
+              << maxError << std::defaultfloat << std::endl;
+    return 0;
+}
+
+int BenchmarkRunner::runTimer(const std::vector<std::string>& args) {
+    size_t iterations = std::max<size_t>(1000, parseSize(args, 0, 1000000));
+
+    std::cout << "=== Timer Source Benchmark ===" << std::endl;
+    std::cout << "Invariant TSC: " << (TscClock::isInvariant() ? "yes" : "no");
+    if (TscClock::isAvailable()) {
+        std::cout << ", calibrated at " << std::fixed << std::setprecision(3) << TscClock::getTicksPerSecond() / 1e9 << " GHz";
+    }
+    std::cout << std::endl;
+
+    // Raw clock reads
+    volatile uint64_t sink = 0;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (size_t i = 0; i < iterations; ++i) {
+        sink = sink + static_cast<uint64_t>(std::chrono::high_resolution_clock::now().time_since_epoch().count());
+    }
+    double chronoReadNs = elapsedMs(start) * 1e6 / iterations;
+
+    start = std::chrono::high_resolution_clock::now();
+    for (size_t i = 0; i < iterations; ++i) {
+        sink = sink + TscClock::now();
+    }
+    double tscReadNs = elapsedMs(start) * 1e6 / iterations;
+
+    std::cout << std::setw(24) << "measurement" << std::setw(14) << "chrono ns" << std::setw(14) << "tsc ns" << std::endl;
+    std::cout << std::setw(24) << "clock read" << std::setw(14) << std::fixed << std::setprecision(1) << chronoReadNs
+              << std::setw(14) << tscReadNs << std::endl;
+
+    // Whole scope: two clock reads plus the ring push (null profiler = loop cost only)
+    double baselineNs = measureScopeCost(nullptr, iterations);
+    PerformanceProfiler chronoProfiler;
+    double chronoScopeNs = measureScopeCost(&chronoProfiler, iterations);
+    PerformanceProfiler tscProfiler;
+    bool tscUsable = tscProfiler.setTimerSource(PerformanceProfiler::TimerSource::Tsc);
+    double tscScopeNs = tscUsable ? measureScopeCost(&tscProfiler, iterations) : 0.0;
+
+    std::cout << std::setw(24) << "PROFILE_SCOPE" << std::setw(14) << (chronoScopeNs - baselineNs)
+              << std::setw(14);
+    if (tscUsable) {
+        std::cout << (tscScopeNs - baselineNs);
+    } else {
+        std::cout << "n/a";
+    }
+    std::cout << std::endl;
+
+    // Agreement with the system clock over a known interval
+    if (tscUsable) {
+        uint64_t tscStart = TscClock::now();
+        start = std::chrono::high_resolution_clock::now();
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        uint64_t tscEnd = TscClock::now();
+        double chronoMs = elapsedMs(start);
+        double tscMs = TscClock::ticksToMilliseconds(tscEnd - tscStart);
+        std::cout << "50 ms sleep: chrono " << std::setprecision(3) << chronoMs << " ms, tsc " << tscMs
+                  << " ms (" << std::setprecision(2) << (tscMs - chronoMs) / chronoMs * 1e6 << " ppm)" << std::endl;
+    }
+
+    return 0;
+}
+
+int BenchmarkRunner::runScenarios(const std::vector<std::string>& args) {
+    std::vector<std::string> names = ScenarioSuite::getScenarioNames();
+    if (!args.empty() && args[0] != "all") {
+        if (std::find(names.begin(), names.end(), args[0]) == names.end()) {
+            std::cerr << "Unknown scenario: " << args[0] << " (available:";
+            for (const std::string& name : names) std::cerr << " " << name;
+            std::cerr << ")" << std::endl;
+            return 1;
+        }
+        names.assign(1, args[0]);
+    }
+
+    std::cout << "=== Scenario Suite (" << ThreadPool::shared().getThreadCount() << " threads) ===" << std::endl;
+    std::cout << std::setw(20) << "scenario" << std::setw(10) << "particles" << std::setw(8) << "steps"
+              << std::setw(11) << "ms/step" << std::setw(14) << "Mparticle/s" << std::setw(14) << "contacts/step"
+              << std::setw(12) << "KE/particle" << std::setw(10) << "COM y" << "  reference" << std::endl;
+
+    ScenarioSuite suite;
+    bool allWithinTolerance = true;
+    for (const std::string& name : names) {
+        ScenarioSuite::Result result;
+        suite.run(name, result);
+        const ScenarioSuite::Metrics& m = result.metrics;
+        allWithinTolerance &= result.withinTolerance;
+
+        std::cout << std::setw(20) << result.name << std::setw(10) << m.particleCount << std::setw(8) << result.steps
+                  << std::setw(11) << std::fixed << std::setprecision(3) << m.msPerStep
+                  << std::setw(14) << std::setprecision(2) << (m.particleCount / (m.msPerStep * 1e3))
+                  << std::setw(14) << std::setprecision(1) << m.contactsPerStep
+                  << std::setw(12) << std::setprecision(3) << m.kineticEnergy
+                  << std::setw(10) << std::setprecision(2) << m.centerOfMassY
+                  << "  " << (result.withinTolerance ? "ok" : "DRIFT") << std::endl;
+        if (!result.withinTolerance) {
+            const ScenarioSuite::Reference& r = result.reference;
+            std::cout << std::setw(20) << "expected" << std::setw(10) << r.particleCount << std::setw(47) << r.contactsPerStep
+                      << std::setw(12) << std::setprecision(3) << r.kineticEnergy << std::setw(10) << std::setprecision(2)
+                      << r.centerOfMassY << "  (+/- " << std::setprecision(0) << r.tolerance * 100.0 << "%)" << std::endl;
+        }
+    }
+
+    if (!allWithinTolerance) {
+        std::cout << "Metrics outside tolerance: the physics changed, so timings are not comparable." << std::endl;
+    }
+    return allWithinTolerance ? 0 : 1;
+}
+
+int BenchmarkRunner::runRoofline(const std::vector<std::string>& args) {
+    size_t particleCount = parseSize(args, 0, 1000000);
+    size_t steps = std::max<size_t>(1, parseSize(args, 1, 20));
+
+    std::vector<RooflineAnalyzer::Peaks> roofs;
+    roofs.push_back(RooflineAnalyzer::measurePeaks(false));
+    if (ThreadPool::shared().getThreadCount() > 1) {
+        roofs.push_back(RooflineAnalyzer::measurePeaks(true));
+    }
+
+    std::cout << "=== Roofline (" << particleCount << " particles, " << steps << " steps) ===" << std::endl;
+    std::cout << "Machine peaks (LLC " << (roofs[0].llcBytes >> 20) << " MB):" << std::endl;
+    for (const RooflineAnalyzer::Peaks& peaks : roofs) {
+        std::cout << std::setw(4) << peaks.threads << " thread(s): DRAM " << std::fixed << std::setprecision(1)
+                  << peaks.dramBandwidthGBs << " GB/s, LLC " << peaks.cacheBandwidthGBs << " GB/s, "
+                  << peaks.gflops << " GFLOP/s, ridge " << std::setprecision(2)
+                  << peaks.gflops / peaks.dramBandwidthGBs << " FLOP/B (DRAM) / "
+                  << peaks.gflops / peaks.cacheBandwidthGBs << " FLOP/B (LLC)" << std::endl;
+    }
+
+    std::vector<RooflineAnalyzer::Kernel> kernels = RooflineAnalyzer::measureKernels(particleCount, steps);
+
+    // Each kernel is held to the bandwidth probed at its own footprint, so the roof
+    // comes from whichever cache level (or DRAM) that footprint streams from
+    std::map<std::pair<size_t, bool>, double> bandwidthByFootprint;
+    auto bandwidthFor = [&](const RooflineAnalyzer::Kernel& kernel) {
+        std::pair<size_t, bool> key(static_cast<size_t>(kernel.workingSetBytes), kernel.parallel && roofs.size() > 1);
+        auto found = bandwidthByFootprint.find(key);
+        if (found != bandwidthByFootprint.end()) return found->second;
+        double bandwidth = RooflineAnalyzer::measureBandwidthGBs(key.first, key.second);
+        bandwidthByFootprint[key] = bandwidth;
+        return bandwidth;
+    };
+
+    std::cout << std::setw(26) << "kernel" << std::setw(10) << "ms/step" << std::setw(9) << "MB"
+              << std::setw(9) << "GB/s" << std::setw(9) << "roof" << std::setw(10) << "GFLOP/s" << std::setw(9) << "FLOP/B"
+              << std::setw(10) << "% roof" << "  bound" << std::endl;
+    size_t modelErrors = 0;
+    for (const RooflineAnalyzer::Kernel& kernel : kernels) {
+        const RooflineAnalyzer::Peaks& peaks = kernel.parallel ? roofs.back() : roofs.front();
+        const double bandwidth = bandwidthFor(kernel);
+        const double seconds = kernel.msPerStep * 1e-3;
+        const double achievedGBs = seconds > 0.0 ? kernel.bytesPerStep / seconds * 1e-9 : 0.0;
+        const double achievedGflops = seconds > 0.0 ? kernel.flopsPerStep / seconds * 1e-9 : 0.0;
+        const double intensity = kernel.flopsPerStep / kernel.bytesPerStep;
+
+        // Attainable = min(peak FLOP/s, intensity x peak bandwidth)
+        const bool bandwidthBound = intensity * bandwidth < peaks.gflops;
+        const double attainable = bandwidthBound ? intensity * bandwidth : peaks.gflops;
+        const double percent = 100.0 * achievedGflops / attainable;
+
+        std::cout << std::setw(26) << kernel.name << std::setw(10) << std::setprecision(3) << kernel.msPerStep
+                  << std::setw(9) << std::setprecision(1) << kernel.workingSetBytes / 1048576.0
+                  << std::setw(9) << achievedGBs << std::setw(9) << bandwidth
+                  << std::setw(10) << std::setprecision(2) << achievedGflops
+                  << std::setw(9) << std::setprecision(2) << intensity;
+        // Nothing runs above a measured roof: the kernel's byte or FLOP model overcounts
+        if (percent > 100.0) {
+            std::cout << "  MODEL ERROR (" << std::setprecision(0) << percent << "% of roof)";
+            modelErrors++;
+        } else {
+            std::cout << std::setw(9) << std::setprecision(1) << percent << "%"
+                      << "  " << (bandwidthBound ? "bandwidth" : "compute");
+        }
+        std::cout << (kernel.parallel ? " (all threads)" : "") << std::endl;
+    }
+    std::cout << "Bytes and FLOPs are modelled per kernel (see Roofline.cpp); % roof is achieved / attainable at that intensity." << std::endl;
+    if (modelErrors > 0) {
+        std::cout << modelErrors << " kernel(s) exceed their roof: their traffic model counts bytes that stay in cache"
+                  << " (e.g. records still resident from the previous pass), so they have no valid roofline position." << std::endl;
+    }
+    return 0;
+}
+
+int BenchmarkRunner::runValidation(const std::vector<std::string>& args) {
+    size_t caseCount = parseSize(args, 0, 6);
+    size_t particleCount = parseSize(args, 1, 2000);
+    size_t steps = std::max<size_t>(1, parseSize(args, 2, 30));
+
+    DifferentialValidator validator(20240917);
+    const DifferentialValidator::Tolerance& tolerance = validator.getTolerance();
+    std::cout << "=== Differential Validation (" << ThreadPool::shared().getThreadCount() << " threads) ===" << std::endl;
+    std::cout << caseCount << " randomized cases, up to " << particleCount << " particles, " << steps
+              << " lockstep steps. Tolerances: position " << tolerance.position << ", velocity " << tolerance.velocity
+              << " (relative), unexplained contacts " << tolerance.contactMismatch * 100.0 << "%, order-explained "
+              << tolerance.explainedMismatch * 100.0 << "% of order-dependent contacts, momentum/energy "
+              << tolerance.aggregate * 100.0 << "%" << std::endl;
+    std::cout << std::setw(19) << "path" << std::setw(38) << "case" << std::setw(8) << "n"
+              << std::setw(12) << "candidates" << std::setw(10) << "mismatch" << std::setw(10) << "contacts"
+              << std::setw(15) << "mism/expl/unex" << std::setw(10) << "expl use" << std::setw(10) << "pos err"
+              << std::setw(10) << "vel err" << std::setw(10) << "aggr err" << std::setw(9) << "speedup" << "  result" << std::endl;
+
+    bool allPassed = true;
+    for (const DifferentialValidator::Report& report : validator.run(caseCount, particleCount, steps)) {
+        allPassed &= report.passed;
+        // Share of the order-explained bound this run used, so drift shows up before it fails
+        const double explainedUse = report.orderDependentContacts > 0
+            ? static_cast<double>(report.explainedMismatches) / report.orderDependentContacts / tolerance.explainedMismatch
+            : 0.0;
+        std::cout << std::setw(19) << report.path << std::setw(38) << report.scenario << std::setw(8) << report.particles
+                  << std::setw(12) << report.referenceCandidates << std::setw(10) << report.candidateMismatches
+                  << std::setw(10) << report.referenceContacts << std::setw(7) << report.contactMismatches
+                  << "/" << std::left << std::setw(7) << (std::to_string(report.explainedMismatches) + "/"
+                  + std::to_string(report.unexplainedMismatches)) << std::right
+                  << std::fixed << std::setprecision(0) << std::setw(9) << 100.0 * explainedUse << "%"
+                  << std::scientific << std::setprecision(1)
+                  << std::setw(10) << report.maxPositionError << std::setw(10) << report.maxVelocityError
+                  << std::setw(10) << report.maxAggregateError
+                  << std::fixed << std::setprecision(2) << std::setw(8) << report.referenceMs / report.optimizedMs << "x"
+                  << "  " << (report.passed ? "PASS" : "FAIL") << std::endl;
+    }
+
+    std::cout << (allPassed ? "All optimized paths match their reference." : "Optimized paths diverge from their reference.") << std::endl;
+    return allPassed ? 0 : 1;
+}
+
+size_t BenchmarkRunner::parseSize(const std::vector<std::string>& args, size_t index, size_t defaultValue) {
+    if (index >= args.size()) return defaultValue;
+    try {
+        // Accept scientific notation such as 1e6
+        return static_cast<size_t>(std::stod(args[index]));
+    } catch (const std::exception&) {
+        std::cerr << "Invalid size '" << args[index] << "', using " << defaultValue << std::endl;
+        return defaultValue;
+    }
+}
+
+int BenchmarkRunner::runStaticField(const std::vector<std::string>& args) {
+    size_t particleCount = parseSize(args, 0, 1000000);
+    size_t wallCount = std::max<size_t>(1, parseSize(args, 1, 256));
+    const glm::vec2 minBounds(-100.0f, -100.0f);
+    const glm::vec2 maxBounds(100.0f, 100.0f);
+    const float damping = 0.8f;
+    const int passes = 5;
+
+    // Random short walls: a maze-like clutter of capsules
+    std::mt19937 generator(2024);
+    std::uniform_real_distribution<float> coordinate(-95.0f, 95.0f);
+    std::uniform_real_distribution<float> angle(0.0f, 2.0f * static_cast<float>(M_PI));
+    std::uniform_real_distribution<float> length(5.0f, 20.0f);
+    SignedDistanceField field;
+    for (size_t w = 0; w < wallCount; ++w) {
+        glm::vec2 a(coordinate(generator), coordinate(generator));
+        float theta = angle(generator);
+        field.addSegment(a, a + length(generator) * glm::vec2(std::cos(theta), std::sin(theta)), 0.5f);
+    }
+
+    auto start = std::chrono::high_resolution_clock::now();
+    if (!field.build(minBounds, maxBounds, 0.25f, 2.0f)) {
+        return 1;
+    }
+    double buildMs = elapsedMs(start);
+
+    ParticleSystem reference;
+    std::uniform_real_distribution<float> velocity(-5.0f, 5.0f);
+    for (size_t i = 0; i < particleCount; ++i) {
+        Particle particle(glm::vec2(coordinate(generator), coordinate(generator)), 1.0f);
+        particle.velocity = glm::vec2(velocity(generator), velocity(generator));
+        particle.radius = 0.5f;
+        reference.addParticle(particle);
+    }
+    ParticleSystem optimized = reference;
+
+    std::cout << "=== SDF Static Collision Benchmark (" << ThreadPool::shared().getThreadCount() << " threads) ===" << std::endl;
+    std::cout << "Particles: " << particleCount << ", walls: " << wallCount << ", field: " << field.getNodesX() << "x"
+              << field.getNodesY() << " nodes built in " << std::fixed << std::setprecision(1) << buildMs << " ms" << std::endl;
+
+    // One pass each on identical states: the contact sets should agree up to
+    // the bilinear rounding near wall ends and crossings
+    size_t referenceContacts = collideSegments(reference, field.getSegments(), damping);
+    size_t fieldContacts = field.collide(optimized, damping);
+    double meanDisplacement = 0.0;
+    for (size_t i = 0; i < particleCount; ++i) {
+        meanDisplacement += glm::length(reference.getParticles()[i].position - optimized.getParticles()[i].position);
+    }
+    meanDisplacement /= std::max<size_t>(1, particleCount);
+
+    start = std::chrono::high_resolution_clock::now();
+    for (int pass = 0; pass < passes; ++pass) {
+        collideSegments(reference, field.getSegments(), damping);
+    }
+    double segmentMs = elapsedMs(start) / passes;
+
+    start = std::chrono::high_resolution_clock::now();
+    for (int pass = 0; pass < passes; ++pass) {
+        field.collide(optimized, damping);
+    }
+    double fieldMs = elapsedMs(start) / passes;
+
+    std::cout << std::setw(14) << "method" << std::setw(12) << "ms/pass" << std::setw(16) << "Mparticles/s"
+              << std::setw(12) << "contacts" << std::endl;
+    std::cout << std::setw(14) << "per-segment" << std::setw(12) << std::setprecision(2) << segmentMs
+              << std::setw(16) << (particleCount / (segmentMs * 1e3)) << std::setw(12) << referenceContacts << std::endl;
+    std::cout << std::setw(14) << "sdf" << std::setw(12) << fieldMs
+              << std::setw(16) << (particleCount / (fieldMs * 1e3)) << std::setw(12) << fieldContacts << std::endl;
+    std::cout << "Speedup: " << std::setprecision(1) << (segmentMs / fieldMs) << "x" << std::endl;
+    std::cout << "Mean position difference after the first pass: " << std::scientific << std::setprecision(2)
+              << meanDisplacement << std::defaultfloat << std::endl;
+    return 0;
+}
+
+int BenchmarkRunner::runSprings(const std::vector<std::string>& args) {
+    const int side = static_cast<int>(std::max<size_t>(2, parseSize(args, 0, 100)));
+    const size_t steps = parseSize(args, 1, 120);
+    const float frameStep = 1.0f / 60.0f;
+    const float stiffness = 100000.0f;
+    const float damping = 1.0f;
+    const float mass = 0.05f;
+
+    std::cout << "=== Stiff Spring Network Benchmark (" << ThreadPool::shared().getThreadCount() << " threads) ===" << std::endl;
+
+    SpringNetwork implicitCloth;
+    implicitCloth.createCloth(side, side, 1.0f, mass, stiffness, damping);
+    implicitCloth.setTimeStep(frameStep);
+    std::cout << "Cloth: " << side << "x" << side << " particles, " << implicitCloth.getSpringCount()
+              << " springs, k = " << stiffness << ", " << steps << " steps of " << frameStep << " s" << std::endl;
+
+    auto start = std::chrono::high_resolution_clock::now();
+    size_t iterations = 0;
+    float worstResidual = 0.0f;
+    for (size_t step = 0; step < steps; ++step) {
+        implicitCloth.step();
+        iterations += implicitCloth.getLastIterationCount();
+        worstResidual = std::max(worstResidual, implicitCloth.getLastResidual());
+    }
+    double implicitMs = elapsedMs(start);
+
+    std::cout << std::setw(22) << "integrator" << std::setw(12) << "ms/frame" << std::setw(14) << "max strain"
+              << std::setw(10) << "stable" << std::endl;
+    std::cout << std::setw(22) << "implicit Euler + PCG" << std::setw(12) << std::fixed << std::setprecision(2)
+              << implicitMs / steps << std::setw(14) << std::setprecision(4) << implicitCloth.getMaxStrain()
+              << std::setw(10) << (implicitCloth.isFinite() ? "yes" : "NO") << std::endl;
+
+    // Explicit integration of the same cloth: double the substeps per frame
+    // until it survives the whole run
+    for (int substeps = 1; substeps <= 1024; substeps *= 2) {
+        SpringNetwork explicitCloth;
+        explicitCloth.createCloth(side, side, 1.0f, mass, stiffness, damping);
+        explicitCloth.setTimeStep(frameStep / substeps);
+
+        start = std::chrono::high_resolution_clock::now();
+        for (size_t step = 0; step < steps * substeps; ++step) {
+            explicitCloth.stepExplicit();
+        }
+        double explicitMs = elapsedMs(start);
+
+        float strain = explicitCloth.getMaxStrain();
+        bool stable = explicitCloth.isFinite() && strain < 1.0f;
+        std::string label = "explicit x" + std::to_string(substeps);
+        std::cout << std::setw(22) << label << std::setw(12) << std::setprecision(2) << explicitMs / steps
+                  << std::setw(14) << std::setprecision(4) << strain << std::setw(10) << (stable ? "yes" : "NO") << std::endl;
+        if (stable) break;
+    }
+
+    std::cout << "PCG iterations per frame: " << std::setprecision(1) << static_cast<double>(iterations) / steps
+              << ", worst relative residual: " << std::scientific << std::setprecision(2) << worstResidual
+              << std::defaultfloat << std::endl;
+    return 0;
+}
+
+int BenchmarkRunner::runFlipFluid(const std::vector<std::string>& args) {
+    size_t particleCount = std::max<size_t>(16, parseSize(args, 0, 1000000));
+    size_t steps = parseSize(args, 1, 30);
+    const glm::vec2 minBounds(-100.0f, -100.0f);
+    const glm::vec2 maxBounds(100.0f, 100.0f);
+    const float timeStep = 1.0f / 60.0f;
+
+    // Dam break: a block over 40% x 60% of the box, four particles per cell
+    const float blockWidth = 0.4f * (maxBounds.x - minBounds.x);
+    const float blockHeight = 0.6f * (maxBounds.y - minBounds.y);
+    const float spacing = std::sqrt(blockWidth * blockHeight / particleCount);
+    const float cellSize = 2.0f * spacing;
+    const int columns = std::max(1, static_cast<int>(blockWidth / spacing));
+    const int rows = std::max(1, static_cast<int>(particleCount / columns));
+
+    ParticleSystem initial;
+    std::mt19937 generator(99);
+    std::uniform_real_distribution<float> jitter(0.0f, 1.0f);
+    for (int row = 0; row < rows; ++row) {
+        for (int column = 0; column < columns; ++column) {
+            Particle particle(minBounds + glm::vec2(column + jitter(generator), row + jitter(generator)) * spacing, 1.0f);
+            particle.radius = 0.5f * spacing;
+            initial.addParticle(particle);
+        }
+    }
+
+    std::cout << "=== FLIP Fluid Benchmark (" << ThreadPool::shared().getThreadCount() << " threads) ===" << std::endl;
+    std::cout << "Particles: " << initial.getParticles().size() << ", steps: " << steps << std::endl;
+    std::cout << std::setw(12) << "pressure" << std::setw(8) << "grid" << std::setw(8) << "levels"
+              << std::setw(12) << "ms/step" << std::setw(16) << "pressure ms" << std::setw(12) << "CG iters"
+              << std::setw(14) << "max div" << std::endl;
+
+    double pressureMs[2] = {0.0, 0.0};
+    for (int useMultigrid = 1; useMultigrid >= 0; --useMultigrid) {
+        ParticleSystem system = initial;
+        PerformanceProfiler profiler;
+        FlipFluidSolver solver;
+        if (!solver.setDomain(minBounds, maxBounds, cellSize)) {
+            return 1;
+        }
+        solver.setUseMultigrid(useMultigrid != 0);
+        solver.setSolverTolerance(1e-4f, 2000); // let Jacobi converge too
+        solver.setProfiler(&profiler);
+
+        size_t iterations = 0;
+        float maxDivergence = 0.0f;
+        auto start = std::chrono::high_resolution_clock::now();
+        for (size_t step = 0; step < steps; ++step) {
+            solver.step(system, timeStep);
+            iterations += solver.getLastIterationCount();
+            maxDivergence = std::max(maxDivergence, solver.getMaxDivergence());
+        }
+        double totalMs = elapsedMs(start);
+        profiler.flush();
+        pressureMs[useMultigrid] = profiler.getProfileData("flip_pressure").avgTime;
+
+        std::string grid = std::to_string(solver.getCellsX()) + "^2";
+        std::cout << std::setw(12) << (useMultigrid ? "multigrid" : "jacobi") << std::setw(8) << grid
+                  << std::setw(8) << (useMultigrid ? solver.getLevelCount() : 1)
+                  << std::setw(12) << std::fixed << std::setprecision(2) << totalMs / std::max<size_t>(1, steps)
+                  << std::setw(16) << pressureMs[useMultigrid]
+                  << std::setw(12) << std::setprecision(1) << static_cast<double>(iterations) / std::max<size_t>(1, steps)
+                  << std::setw(14) << std::scientific << std::setprecision(2) << maxDivergence << std::defaultfloat << std::endl;
+    }
+    std::cout << "Pressure solve speedup: " << std::fixed << std::setprecision(2)
+              << (pressureMs[0] / std::max(1e-9, pressureMs[1])) << "x" << std::defaultfloat << std::endl;
+    return 0;
+}
+
+int BenchmarkRunner::runEventDriven(const std::vector<std::string>& args) {
+    size_t particleCount = std::max<size_t>(2, parseSize(args, 0, 100000));
+    size_t frames = parseSize(args, 1, 120);
+    const float frameTime = 1.0f / 60.0f;
+    const float radius = 0.5f;
+
+    // Dilute gas: 2% area fraction, fast enough to cross a diameter in a frame
+    const float areaFraction = 0.02f;
+    const float halfSide = 0.5f * std::sqrt(particleCount * 3.14159265f * radius * radius / areaFraction);
+    const glm::vec2 minBounds(-halfSide, -halfSide);
+    const glm::vec2 maxBounds(halfSide, halfSide);
+
+    ParticleSystem initial;
+    std::mt19937 generator(7);
+    std::uniform_real_distribution<float> position(-halfSide + radius, halfSide - radius);
+    std::normal_distribution<float> velocity(0.0f, 40.0f);
+    for (size_t i = 0; i < particleCount; ++i) {
+        Particle particle(glm::vec2(position(generator), position(generator)), 1.0f);
+        particle.velocity = glm::vec2(velocity(generator), velocity(generator));
+        particle.radius = radius;
+        initial.addParticle(particle);
+    }
+    auto kineticEnergy = [](const ParticleSystem& system) {
+        double sum = 0.0;
+        for (const auto& particle : system.getParticles()) {
+            sum += 0.5 * particle.mass * glm::dot(particle.velocity, particle.velocity);
+        }
+        return sum;
+    };
+    const double initialEnergy = kineticEnergy(initial);
+
+    std::cout << "=== Event-Driven Hard Disks Benchmark ===" << std::endl;
+    std::cout << "Particles: " << particleCount << ", box: " << 2.0f * halfSide << "^2, area fraction: "
+              << areaFraction << ", simulated: " << frames * frameTime << " s" << std::endl;
+    std::cout << std::setw(16) << "method" << std::setw(12) << "ms/frame" << std::setw(14) << "collisions"
+              << std::setw(14) << "events/s" << std::setw(14) << "energy drift" << std::endl;
+
+    // Time stepped: collisions are the contacts seen per step (a slow pair may
+    // count in several steps, a fast one in none)
+    double steppedMs[2] = {0.0, 0.0};
+    const int substepCounts[2] = {1, 16};
+    for (int run = 0; run < 2; ++run) {
+        ParticleSystem system = initial;
+        PhysicsEngine engine;
+        engine.setBroadPhase(CollisionBroadPhase::CellList);
+        engine.setGravity(glm::vec2(0.0f, 0.0f));
+        engine.setAirResistance(0.0f);
+        engine.setCollisionDamping(1.0f);
+
+        const float timeStep = frameTime / substepCounts[run];
+        size_t contacts = 0;
+        auto start = std::chrono::high_resolution_clock::now();
+        for (size_t frame = 0; frame < frames; ++frame) {
+            for (int substep = 0; substep < substepCounts[run]; ++substep) {
+                engine.applyBoundaryConstraints(system, minBounds, maxBounds);
+                engine.integrateParticles(system, timeStep);
+                contacts += engine.getLastContactCount();
+            }
+        }
+        steppedMs[run] = elapsedMs(start);
+
+        std::string label = "step 1/" + std::to_string(60 * substepCounts[run]);
+        std::cout << std::setw(16) << label << std::setw(12) << std::fixed << std::setprecision(2)
+                  << steppedMs[run] / std::max<size_t>(1, frames) << std::setw(14) << contacts << std::setw(14) << "-"
+                  << std::setw(13) << std::setprecision(3) << 100.0 * (kineticEnergy(system) / initialEnergy - 1.0) << "%"
+                  << std::defaultfloat << std::endl;
+    }
+
+    EventDrivenEngine engine;
+    engine.setBounds(minBounds, maxBounds);
+    engine.loadFrom(initial);
+    auto start = std::chrono::high_resolution_clock::now();
+    for (size_t frame = 0; frame < frames; ++frame) {
+        engine.advance(frameTime);
+    }
+    double eventMs = elapsedMs(start);
+    uint64_t events = engine.getCollisionCount() + engine.getWallCount() + engine.getCellCrossingCount();
+    ParticleSystem result = initial;
+    engine.storeTo(result);
+    std::cout << std::setw(16) << "event-driven" << std::setw(12) << std::fixed << std::setprecision(2)
+              << eventMs / std::max<size_t>(1, frames) << std::setw(14) << engine.getCollisionCount()
+              << std::setw(14) << std::setprecision(0) << events / std::max(1e-9, eventMs * 1e-3)
+              << std::setw(13) << std::setprecision(3) << 100.0 * (kineticEnergy(result) / initialEnergy - 1.0) << "%"
+              << std::defaultfloat << std::endl;
+    std::cout << "Events: " << engine.getCollisionCount() << " collisions, " << engine.getWallCount() << " wall, "
+              << engine.getCellCrossingCount() << " cell crossings, " << engine.getStaleEventCount() << " stale dropped" << std::endl;
+    std::cout << "Speedup vs step 1/60: " << std::fixed << std::setprecision(2) << steppedMs[0] / std::max(1e-9, eventMs)
+              << "x, vs step 1/960: " << steppedMs[1] / std::max(1e-9, eventMs) << "x" << std::defaultfloat << std::endl;
+    return 0;
+}
+
+int BenchmarkRunner::runDsmc(const std::vector<std::string>& args) {
+    size_t particleCount = std::max<size_t>(16, parseSize(args, 0, 10000000));
+    size_t steps = std::max<size_t>(1, parseSize(args, 1, 20));
+
+    // About 10 particles per unit cell, mean free path of 2 cells, and a
+    // quarter cell of travel per step at the thermal speed
+    const float thermalSpeed = 1.0f;
+    const float halfSide = 0.5f * std::sqrt(particleCount / 10.0f);
+    const float diameter = 0.035f;
+    const float timeStep = 0.25f;
+
+    auto makeEngine = [&](DsmcEngine& engine, size_t count) {
+        engine.setDomain(glm::vec2(-halfSide, -halfSide), glm::vec2(halfSide, halfSide), 1.0f);
+        engine.setDiameter(diameter);
+        engine.setTimeStep(timeStep);
+        engine.setSeed(2024);
+        engine.createUniform(count, thermalSpeed);
+    };
+
+    PerformanceProfiler profiler;
+    DsmcEngine engine;
+    engine.setProfiler(&profiler);
+    makeEngine(engine, particleCount);
+    const double initialEnergy = engine.getKineticEnergy();
+
+    std::cout << "=== DSMC Benchmark (" << ThreadPool::shared().getThreadCount() << " threads) ===" << std::endl;
+    std::cout << "Particles: " << particleCount << ", cells: " << engine.getCellCount()
+              << ", mean free path: " << engine.getMeanFreePath() << " cells, steps: " << steps << std::endl;
+
+    uint64_t collisions = 0, candidates = 0;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (size_t step = 0; step < steps; ++step) {
+        engine.step();
+        collisions += engine.getLastCollisionCount();
+        candidates += engine.getLastCandidateCount();
+    }
+    double totalMs = elapsedMs(start);
+    profiler.flush();
+
+    std::cout << std::setw(12) << "ms/step" << std::setw(10) << "move" << std::setw(10) << "sort"
+              << std::setw(10) << "collide" << std::setw(16) << "particles/s" << std::endl;
+    std::cout << std::setw(12) << std::fixed << std::setprecision(2) << totalMs / steps
+              << std::setw(10) << profiler.getProfileData("dsmc_move").avgTime
+              << std::setw(10) << profiler.getProfileData("dsmc_sort").avgTime
+              << std::setw(10) << profiler.getProfileData("dsmc_collide").avgTime
+              << std::setw(16) << std::scientific << std::setprecision(2) << particleCount * steps / (totalMs * 1e-3)
+              << std::defaultfloat << std::endl;
+
+    // Hard disks in equilibrium: each collides n d <g> times per unit time,
+    // with <g> = sqrt(pi) times the per-axis thermal speed
+    const double density = particleCount / (4.0 * halfSide * halfSide);
+    const double expected = 0.5 * particleCount * density * diameter * std::sqrt(3.14159265) * thermalSpeed * timeStep;
+    glm::dvec2 momentum = engine.getMomentum();
+    std::cout << "Collisions/step: " << collisions / steps << " (theory " << static_cast<uint64_t>(expected)
+              << "), acceptance " << std::fixed << std::setprecision(3)
+              << static_cast<double>(collisions) / std::max<uint64_t>(1, candidates) << std::endl;
+    std::cout << "Energy drift: " << std::scientific << std::setprecision(2) << (engine.getKineticEnergy() / initialEnergy - 1.0)
+              << ", momentum per particle: (" << momentum.x / particleCount << ", " << momentum.y / particleCount << ")"
+              << std::defaultfloat << std::endl;
+
+    // Same run on pools of 1 and 4 threads: per-(step, cell) random streams and
+    // a stable sort make the states bitwise identical
+    const size_t checkCount = std::min<size_t>(particleCount, 200000);
+    const size_t checkSteps = std::min<size_t>(steps, 5);
+    uint64_t checksums[2] = {0, 0};
+    const size_t threadCounts[2] = {1, 4};
+    for (int run = 0; run < 2; ++run) {
+        ThreadPool pool(threadCounts[run]);
+        DsmcEngine check(&pool);
+        makeEngine(check, checkCount);
+        for (size_t step = 0; step < checkSteps; ++step) {
+            check.step();
+        }
+        ParticleSystem state;
+        for (size_t i = 0; i < checkCount; ++i) {
+            state.addParticle(Particle(glm::vec2(0.0f, 0.0f), 1.0f));
+        }
+        check.storeTo(state);
+        uint64_t hash = 14695981039346656037ULL;
+        for (const auto& particle : state.getParticles()) {
+            const float values[4] = {particle.position.x, particle.position.y, particle.velocity.x, particle.velocity.y};
+            for (float value : values) {
+                uint32_t bits;
+                std::memcpy(&bits, &value, sizeof(bits));
+                hash = (hash ^ bits) * 1099511628211ULL;
+            }
+        }
+        checksums[run] = hash;
+    }
+    std::cout << "Determinism (1 vs 4 threads, " << checkCount << " particles): "
+              << (checksums[0] == checksums[1] ? "identical" : "MISMATCH") << std::endl;
+    return checksums[0] == checksums[1] ? 0 : 1;
+}
+
+int BenchmarkRunner::runLangevin(const std::vector<std::string>& args) {
+    size_t particleCount = std::max<size_t>(16, parseSize(args, 0, 1000000));
+    size_t steps = std::max<size_t>(1, parseSize(args, 1, 200));
+    const size_t normalCount = 2 * particleCount;
+
+    std::cout << "=== Langevin Thermostat Benchmark (" << ThreadPool::shared().getThreadCount() << " threads) ===" << std::endl;
+    std::cout << "Gaussian noise, " << normalCount << " normals (single thread):" << std::endl;
+    std::cout << std::setw(28) << "generator" << std::setw(12) << "ns/normal" << std::setw(10) << "mean"
+              << std::setw(10) << "variance" << std::setw(10) << "kurtosis" << std::endl;
+
+    std::vector<float> normals(normalCount + CounterRNG::BATCH_SIZE);
+    auto report = [&](const char* name, double ms) {
+        double sum = 0.0, sumSq = 0.0, sumFourth = 0.0;
+        for (size_t i = 0; i < normalCount; ++i) {
+            double value = normals[i];
+            sum += value;
+            sumSq += value * value;
+            sumFourth += value * value * value * value;
+        }
+        double mean = sum / normalCount;
+        double variance = sumSq / normalCount - mean * mean;
+        std::cout << std::setw(28) << name << std::setw(12) << std::fixed << std::setprecision(2) << ms * 1e6 / normalCount
+                  << std::setw(10) << std::setprecision(4) << mean << std::setw(10) << variance
+                  << std::setw(10) << sumFourth / normalCount / (variance * variance) << std::defaultfloat << std::endl;
+        return ms;
+    };
+
+    // Sequential engine: one shared stream, not reproducible per particle in parallel
+    std::mt19937 engine(1);
+    std::normal_distribution<float> normal(0.0f, 1.0f);
+    auto start = std::chrono::high_resolution_clock::now();
+    for (size_t i = 0; i < normalCount; ++i) {
+        normals[i] = normal(engine);
+    }
+    double referenceMs = report("mt19937 + normal_dist", elapsedMs(start));
+
+    // Counter-based, one particle at a time with libm Box-Muller
+    start = std::chrono::high_resolution_clock::now();
+    for (size_t i = 0; i < particleCount; ++i) {
+        const uint32_t counter[4] = {static_cast<uint32_t>(i), 0, 0, 0};
+        const uint32_t key[2] = {1, 0};
+        CounterRNG::Block block = CounterRNG::philox(counter, key);
+        float radius = std::sqrt(-2.0f * std::log(((block.value[0] >> 8) + 1) * (1.0f / 16777216.0f)));
+        float angle = 6.28318531f * (block.value[1] >> 8) * (1.0f / 16777216.0f);
+        normals[2 * i] = radius * std::cos(angle);
+        normals[2 * i + 1] = radius * std::sin(angle);
+    }
+    report("Philox scalar + libm", elapsedMs(start));
+
+    start = std::chrono::high_resolution_clock::now();
+    for (size_t first = 0; first < particleCount; first += CounterRNG::BATCH_SIZE) {
+        float noiseX[CounterRNG::BATCH_SIZE], noiseY[CounterRNG::BATCH_SIZE];
+        CounterRNG::gaussianBatch(1, 0, static_cast<uint32_t>(first), noiseX, noiseY);
+        for (int lane = 0; lane < CounterRNG::BATCH_SIZE; ++lane) {
+            normals[2 * (first + lane)] = noiseX[lane];
+            normals[2 * (first + lane) + 1] = noiseY[lane];
+        }
+    }
+    double batchMs = report("Philox SIMD batch", elapsedMs(start));
+    std::cout << "SIMD batch speedup vs normal_distribution: " << std::fixed << std::setprecision(2)
+              << referenceMs / std::max(1e-9, batchMs) << "x" << std::defaultfloat << std::endl;
+
+    // Free particles (masses 0.5 - 2) relaxing from rest to kT = 1
+    const float temperature = 1.0f;
+    const float timeStep = 0.01f;
+    auto makeSystem = [](size_t count) {
+        ParticleSystem system;
+        for (size_t i = 0; i < count; ++i) {
+            system.addParticle(Particle(glm::vec2(0.0f, 0.0f), 0.5f + 1.5f * (i % 101) / 100.0f));
+        }
+        return system;
+    };
+    auto measuredTemperature = [](const ParticleSystem& system) {
+        double sum = 0.0;
+        for (const auto& particle : system.getParticles()) {
+            sum += particle.mass * glm::dot(particle.velocity, particle.velocity);
+        }
+        return sum / (2.0 * system.getParticles().size()); // kT = <m v^2> per axis
+    };
+
+    ParticleSystem system = makeSystem(particleCount);
+    PerformanceProfiler profiler;
+    LangevinThermostat thermostat;
+    thermostat.setTemperature(temperature);
+    thermostat.setFriction(5.0f);
+    thermostat.setProfiler(&profiler);
+    for (size_t step = 0; step < steps; ++step) {
+        thermostat.apply(system, timeStep);
+        system.update(timeStep);
+    }
+    profiler.flush();
+    std::cout << "Thermostat: " << particleCount << " particles, friction 5, " << steps << " steps of " << timeStep
+              << ": " << std::fixed << std::setprecision(3) << profiler.getProfileData("langevin").avgTime
+              << " ms/step, kT = " << std::setprecision(4) << measuredTemperature(system) << " (target " << temperature << ")"
+              << std::defaultfloat << std::endl;
+
+    // Same seed on pools of 1 and 4 threads gives identical velocities
+    const size_t checkCount = std::min<size_t>(particleCount, 100000);
+    ParticleSystem states[2] = {makeSystem(checkCount), makeSystem(checkCount)};
+    const size_t threadCounts[2] = {1, 4};
+    for (int run = 0; run < 2; ++run) {
+        ThreadPool pool(threadCounts[run]);
+        LangevinThermostat check(&pool);
+        check.setSeed(7);
+        for (int step = 0; step < 5; ++step) {
+            check.apply(states[run], timeStep);
+        }
+    }
+    bool identical = true;
+    for (size_t i = 0; i < checkCount; ++i) {
+        const auto& a = states[0].getParticles()[i].velocity;
+        const auto& b = states[1].getParticles()[i].velocity;
+        identical = identical && std::memcmp(&a, &b, sizeof(a)) == 0;
+    }
+    std::cout << "Determinism (1 vs 4 threads, " << checkCount << " particles): " << (identical ? "identical" : "MISMATCH") << std::endl;
+    return identical ? 0 : 1;
+}
+
+int BenchmarkRunner::runLatticeBoltzmann(const std::vector<std::string>& args) {
+    const int side = static_cast<int>(std::max<size_t>(16, parseSize(args, 0, 2048)));
+    const int steps = static_cast<int>(std::max<size_t>(1, parseSize(args, 1, 50)));
+
+    // Lattice units throughout: cell size, lattice time step and density 1
+    auto makeSolver = [](LatticeBoltzmannSolver& solver, int cellsX, int cellsY, float viscosity) {
+        solver.setLatticeTimeStep(1.0f);
+        solver.setDensity(1.0f);
+        solver.setViscosity(viscosity);
+        return solver.setDomain(glm::vec2(0.0f, 0.0f), glm::vec2(static_cast<float>(cellsX), static_cast<float>(cellsY)), 1.0f);
+    };
+
+    std::cout << "=== Lattice Boltzmann Benchmark (" << ThreadPool::shared().getThreadCount() << " threads) ===" << std::endl;
+    bool passed = true;
+
+    // Throughput of the fused stream-collide pass on a driven channel
+    {
+        LatticeBoltzmannSolver solver;
+        if (!makeSolver(solver, side, side, 0.1f)) {
+            return 1;
+        }
+        solver.setBodyForce(glm::vec2(1e-6f, 0.0f));
+        solver.stepLattice(2); // first touch
+        auto start = std::chrono::high_resolution_clock::now();
+        solver.stepLattice(steps);
+        double ms = elapsedMs(start);
+
+        double cells = static_cast<double>(side) * side;
+        double mlups = cells * steps / (ms * 1e3);
+        double gbs = mlups * 1e6 * LatticeBoltzmannSolver::getBytesPerCellUpdate() / 1e9;
+        RooflineAnalyzer::Peaks peaks = RooflineAnalyzer::measurePeaks(true);
+        std::cout << "Lattice " << side << "^2 (" << std::fixed << std::setprecision(0)
+                  << cells * 2 * 9 * sizeof(float) / (1024.0 * 1024.0) << " MB of populations), " << steps << " steps" << std::endl;
+        std::cout << std::setw(12) << "ms/step" << std::setw(10) << "MLUPS" << std::setw(12) << "GB/s"
+                  << std::setw(14) << "STREAM GB/s" << std::setw(12) << "of peak" << std::endl;
+        std::cout << std::setw(12) << std::setprecision(2) << ms / steps << std::setw(10) << std::setprecision(1) << mlups
+                  << std::setw(12) << gbs << std::setw(14) << peaks.dramBandwidthGBs
+                  << std::setw(11) << std::setprecision(0) << 100.0 * gbs / peaks.dramBandwidthGBs << "%" << std::defaultfloat << std::endl;
+    }
+
+    // Poiseuille channel: steady profile against u(y) = g y (H - y) / (2 nu),
+    // y measured from the half-way walls. Deviation storage reaches ~3e-4 at
+    // -O2 and -O3 alike; absolute float populations were at 7e-3 to 2e-2.
+    {
+        const double tolerance = 2e-3;
+        const int width = 8, height = 32;
+        const float viscosity = 1.0f / 6.0f; // tau = 1
+        const float gravity = 1e-6f;
+        LatticeBoltzmannSolver solver;
+        makeSolver(solver, width, height, viscosity);
+        solver.setBodyForce(glm::vec2(gravity, 0.0f));
+        solver.stepLattice(30000);
+        double maxError = 0.0, peak = 0.0;
+        for (int row = 0; row < height; ++row) {
+            float y = row + 0.5f;
+            double exact = gravity * y * (height - y) / (2.0 * viscosity);
+            double simulated = solver.sampleVelocity(glm::vec2(width * 0.5f, y)).x;
+            maxError = std::max(maxError, std::abs(simulated - exact));
+            peak = std::max(peak, exact);
+        }
+        const bool withinTolerance = maxError <= tolerance * peak;
+        passed &= withinTolerance;
+        std::cout << "Poiseuille " << width << "x" << height << ", tau 1: max error " << std::scientific << std::setprecision(2)
+                  << maxError / peak << " of the peak velocity (tolerance " << tolerance << ") "
+                  << (withinTolerance ? "PASS" : "FAIL") << std::defaultfloat << std::endl;
+    }
+
+    // Two-way coupling: particles moving through fluid at rest hand their
+    // momentum to the lattice
+    {
+        LatticeBoltzmannSolver solver;
+        makeSolver(solver, 256, 128, 0.1f);
+        solver.setDragCoefficient(0.05f);
+        ParticleSystem system;
+        std::mt19937 generator(5);
+        std::uniform_real_distribution<float> x(10.0f, 246.0f), y(10.0f, 118.0f);
+        for (int i = 0; i < 10000; ++i) {
+            Particle particle(glm::vec2(x(generator), y(generator)), 1.0f);
+            particle.velocity = glm::vec2(0.01f, 0.005f);
+            particle.radius = 0.5f;
+            system.addParticle(particle);
+        }
+        auto particleMomentum = [&]() {
+            glm::dvec2 sum(0.0, 0.0);
+            for (const auto& particle : system.getParticles()) {
+                sum += glm::dvec2(particle.velocity) * static_cast<double>(particle.mass);
+            }
+            return sum;
+        };
+        glm::dvec2 before = particleMomentum() + solver.getFluidMomentum();
+        for (int step = 0; step < 20; ++step) {
+            solver.step(system, 1.0f);
+        }
+        glm::dvec2 particles = particleMomentum();
+        glm::dvec2 after = particles + solver.getFluidMomentum();
+        std::cout << "Coupling, 10^4 particles, 20 steps: particles kept " << std::fixed << std::setprecision(1)
+                  << 100.0 * particles.x / before.x << "% of their momentum, total momentum drift "
+                  << std::scientific << std::setprecision(2) << glm::length(after - before) / glm::length(before)
+                  << std::defaultfloat << std::endl;
+    }
+    return passed ? 0 : 1;
+}
+
+int BenchmarkRunner::runMultipleTimeStepping(const std::vector<std::string>& args) {
+    const size_t particleCount = std::max<size_t>(16, parseSize(args, 0, 4000));
+    const size_t steps = std::max<size_t>(16, parseSize(args, 1, 480));
+    const float timeStep = 1.0f / 120.0f;
+
+    // Self-gravitating disk of radius 100 in near-rigid rotation. Bodies are
+    // nearly point-like (few contacts, and those elastic) and there is no
+    // uniform gravity, so the drift measures the slow-force integration
+    const float strength = 1.0f;
+    const float diskRadius = 100.0f;
+    ParticleSystem initial;
+    std::mt19937 generator(11);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    const float angularSpeed = 0.8f * std::sqrt(strength * particleCount / (diskRadius * diskRadius * diskRadius));
+    for (size_t i = 0; i < particleCount; ++i) {
+        float radius = diskRadius * std::sqrt(unit(generator));
+        float angle = 6.28318531f * unit(generator);
+        glm::vec2 position(radius * std::cos(angle), radius * std::sin(angle));
+        Particle particle(position, 1.0f);
+        particle.velocity = angularSpeed * glm::vec2(-position.y, position.x);
+        particle.radius = 0.1f;
+        initial.addParticle(particle);
+    }
+
+    std::cout << "=== Multiple Time Stepping Benchmark (" << ThreadPool::shared().getThreadCount() << " threads) ===" << std::endl;
+    std::cout << particleCount << " particles, all-pairs softened gravity as the slow force, "
+              << steps << " steps of " << std::setprecision(4) << timeStep << " s" << std::endl;
+    std::cout << std::setw(6) << "k" << std::setw(12) << "ms/step" << std::setw(10) << "speedup" << std::setw(12) << "slow evals"
+              << std::setw(16) << "max |dE|/|E0|" << std::setw(14) << "final dE/|E0|" << std::endl;
+
+    SoftenedGravity gravity;
+    gravity.setStrength(strength);
+    gravity.setSoftening(2.0f);
+    double referenceMs = 0.0;
+    for (int interval : {1, 2, 4, 8, 16, 32, 64}) {
+        ParticleSystem system = initial;
+        PhysicsEngine engine;
+        engine.setGravity(glm::vec2(0.0f, 0.0f));
+        engine.setAirResistance(0.0f);
+        engine.setCollisionDamping(1.0f);
+        engine.setBroadPhase(CollisionBroadPhase::CellList);
+        MultipleTimeStepIntegrator integrator;
+        integrator.addSlowForce([&](const ParticleSystem& s, std::vector<glm::vec2>& forces) {
+            return gravity.compute(s, forces);
+        });
+        integrator.setInterval(interval);
+
+        auto start = std::chrono::high_resolution_clock::now();
+        for (size_t step = 0; step < steps; ++step) {
+            integrator.step(system, engine, timeStep);
+        }
+        double ms = elapsedMs(start) / steps;
+        if (interval == 1) {
+            referenceMs = ms;
+        }
+        std::cout << std::setw(6) << interval << std::setw(12) << std::fixed << std::setprecision(3) << ms
+                  << std::setw(9) << std::setprecision(2) << referenceMs / ms << "x"
+                  << std::setw(12) << integrator.getSlowEvaluationCount()
+                  << std::setw(16) << std::scientific << std::setprecision(2) << integrator.getMaxEnergyDrift()
+                  << std::setw(14) << integrator.getEnergyDrift() << std::defaultfloat << std::endl;
+    }
+    return 0;
+}
+
+int BenchmarkRunner::runCollisionFilters(const std::vector<std::string>& args) {
+    const size_t particleCount = std::max<size_t>(16, parseSize(args, 0, 200000));
+    const size_t steps = std::max<size_t>(1, parseSize(args, 1, 20));
+
+    // 10% solids colliding with everything, 90% tracers; area fraction 0.3
+    const uint32_t solidGroup = 1u, tracerGroup = 2u;
+    const float radius = 0.5f;
+    const float halfSide = 0.5f * std::sqrt(particleCount * 3.14159265f * radius * radius / 0.3f);
+    std::vector<Particle> particles;
+    std::mt19937 generator(3);
+    std::uniform_real_distribution<float> position(-halfSide, halfSide);
+    std::normal_distribution<float> velocity(0.0f, 5.0f);
+    for (size_t i = 0; i < particleCount; ++i) {
+        Particle particle(glm::vec2(position(generator), position(generator)), 1.0f);
+        particle.velocity = glm::vec2(velocity(generator), velocity(generator));
+        particle.radius = radius;
+        particles.push_back(particle);
+    }
+
+    std::cout << "=== Collision Filter Benchmark (" << ThreadPool::shared().getThreadCount() << " threads) ===" << std::endl;
+    std::cout << particleCount << " particles (10% solids, 90% tracers), cell list, " << steps << " steps" << std::endl;
+    std::cout << std::setw(26) << "tracers" << std::setw(12) << "ms/step" << std::setw(14) << "pair tests"
+              << std::setw(14) << "filtered" << std::setw(12) << "contacts" << std::endl;
+
+    struct Setup {
+        const char* name;
+        bool filtered;
+        uint32_t tracerGroup, tracerMask;
+    };
+    const Setup setups[] = {
+        {"collide (no filters)", false, 0u, 0u},
+        {"skip tracers", true, tracerGroup, solidGroup},
+        {"collide with nothing", true, 0u, 0u},
+    };
+    for (const Setup& setup : setups) {
+        ParticleSystem system;
+        for (size_t i = 0; i < particleCount; ++i) {
+            if (!setup.filtered) {
+                system.addParticle(particles[i]);
+            } else if (i % 10 == 0) {
+                system.addParticle(particles[i], solidGroup, solidGroup | tracerGroup);
+            } else {
+                system.addParticle(particles[i], setup.tracerGroup, setup.tracerMask);
+            }
+        }
+        PhysicsEngine engine;
+        engine.setBroadPhase(CollisionBroadPhase::CellList);
+        engine.handleCollisions(system, 1.0f); // warm-up: buffers and first touch
+
+        size_t pairTests = 0, filtered = 0, contacts = 0;
+        auto start = std::chrono::high_resolution_clock::now();
+        for (size_t step = 0; step < steps; ++step) {
+            engine.handleCollisions(system, 1.0f);
+            pairTests += engine.getLastPairTestCount();
+            filtered += engine.getLastFilteredPairCount();
+            contacts += engine.getLastContactCount();
+        }
+        double ms = elapsedMs(start) / steps;
+        std::cout << std::setw(26) << setup.name << std::setw(12) << std::fixed << std::setprecision(3) << ms
+                  << std::setw(14) << pairTests / steps << std::setw(14) << filtered / steps
+                  << std::setw(12) << contacts / steps << std::defaultfloat << std::endl;
+    }
+    return 0;
+}
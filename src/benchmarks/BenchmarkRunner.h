@@ -0,0 +1,41 @@
+#ifndef BENCHMARK_RUNNER_H
+#define BENCHMARK_RUNNER_H
+
+#include <string>
+#include <vector>
+
+// Headless benchmarks, selected with `particle_simulator --bench <name> [args]`.
+// None of them open a window, so they run in containers and on CI machines.
+class BenchmarkRunner {
+public:
+    BenchmarkRunner();
+
+    // Returns the process exit code
+    int run(const std::string& name, const std::vector<std::string>& args);
+    void printUsage() const;
+
+private:
+    // Individual benchmarks
+    int runRadixSort(const std::vector<std::string>& args);
+    int runDeterminism(const std::vector<std::string>& args);
+    int runLennardJones(const std::vector<std::string>& args);
+    int runBatchedWorlds(const std::vector<std::string>& args);
+    int runTimer(const std::vector<std::string>& args);
+    int runScenarios(const std::vector<std::string>& args);
+    int runRoofline(const std::vector<std::string>& args);
+    int runValidation(const std::vector<std::string>& args);
+    int runStaticField(const std::vector<std::string>& args);
+    int runSprings(const std::vector<std::string>& args);
+    int runFlipFluid(const std::vector<std::string>& args);
+    int runEventDriven(const std::vector<std::string>& args);
+    int runDsmc(const std::vector<std::string>& args);
+    int runLangevin(const std::vector<std::string>& args);
+    int runLatticeBoltzmann(const std::vector<std::string>& args);
+    int runMultipleTimeStepping(const std::vector<std::string>& args);
+    int runCollisionFilters(const std::vector<std::string>& args);
+
+    // Helpers
+    static size_t parseSize(const std::vector<std::string>& args, size_t index, size_t defaultValue);
+};
+
+#endif // BENCHMARK_RUNNER_H
@@ -0,0 +1,460 @@
+#include "DifferentialValidator.h"
+#include "../optimization/UniformGrid.h"
+#include "../physics/BatchedWorldEngine.h"
+#include "../physics/PhysicsEngine.h"
+#include "../utils/ThreadPool.h"
+#include <algorithm>
+#include <cfloat>
+#include <chrono>
+#include <cmath>
+#include <iterator>
+#include <random>
+#include <sstream>
+
+namespace {
+
+using Clock = std::chrono::high_resolution_clock;
+
+double elapsedMs(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+// One randomized case: density, radius spread, speed, gravity and where the box sits
+struct RandomCase {
+    std::string description;
+    uint64_t seed;
+    size_t particleCount;
+    float areaFraction;
+    float minRadius, maxRadius;
+    bool bimodal;      // 10% of particles four times larger
+    float speed;
+    bool gravity;
+    glm::vec2 center;  // far from the origin in some cases (float spacing ~1e-3)
+};
+
+RandomCase makeCase(std::mt19937_64& generator, size_t maxParticles) {
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    RandomCase c;
+    c.seed = generator();
+    c.particleCount = std::max<size_t>(2, static_cast<size_t>(maxParticles * (0.5f + 0.5f * unit(generator))));
+    c.areaFraction = 0.02f + 0.38f * unit(generator);
+    c.minRadius = 0.2f + 0.6f * unit(generator);
+    c.maxRadius = c.minRadius * (1.0f + 2.0f * unit(generator));
+    c.bimodal = unit(generator) < 0.3f;
+    c.speed = 20.0f * unit(generator);
+    c.gravity = unit(generator) < 0.5f;
+    c.center = unit(generator) < 0.3f ? glm::vec2(1.0e4f, -5.0e3f) : glm::vec2(0.0f);
+
+    std::ostringstream description;
+    description << "phi=" << static_cast<int>(c.areaFraction * 100.0f + 0.5f) << "% r="
+                << std::fixed;
+    description.precision(2);
+    description << c.minRadius << "-" << c.maxRadius << (c.bimodal ? " bimodal" : "")
+                << (c.gravity ? " g" : "") << (c.center.x != 0.0f ? " far" : "");
+    c.description = description.str();
+    return c;
+}
+
+// Box half extent for count particles at the case's area fraction (uses the
+// expected radius, so every world of a batch gets the same bounds)
+float halfExtent(const RandomCase& c, size_t count) {
+    float meanRadius = 0.5f * (c.minRadius + c.maxRadius) * (c.bimodal ? 1.3f : 1.0f);
+    float area = count * 3.14159265f * meanRadius * meanRadius / c.areaFraction;
+    return std::max(0.5f * std::sqrt(area), 16.0f * c.maxRadius); // room for the largest bimodal particle
+}
+
+std::vector<Particle> makeParticles(const RandomCase& c, size_t count, uint64_t seed) {
+    std::mt19937_64 generator(seed);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    const float extent = halfExtent(c, count);
+
+    std::vector<Particle> particles;
+    particles.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        float radius = c.minRadius + (c.maxRadius - c.minRadius) * unit(generator);
+        if (c.bimodal && unit(generator) < 0.1f) radius *= 4.0f;
+        float margin = std::min(radius, extent);
+        glm::vec2 position = c.center + glm::vec2((2.0f * unit(generator) - 1.0f) * (extent - margin),
+                                                  (2.0f * unit(generator) - 1.0f) * (extent - margin));
+        Particle particle(position, radius * radius);
+        particle.velocity = c.speed * glm::vec2(2.0f * unit(generator) - 1.0f, 2.0f * unit(generator) - 1.0f);
+        particle.radius = radius;
+        particles.push_back(particle);
+    }
+    return particles;
+}
+
+float relativeError(float reference, float value, float scale) {
+    return std::abs(value - reference) / std::max(scale, std::abs(reference));
+}
+
+// Largest relative momentum / kinetic energy difference between two systems
+double aggregateError(const std::vector<Particle>& reference, const std::vector<Particle>& optimized) {
+    double momentumX[2] = {0.0, 0.0}, momentumY[2] = {0.0, 0.0}, momentumScale = 0.0;
+    double kinetic[2] = {0.0, 0.0};
+    const std::vector<Particle>* systems[2] = {&reference, &optimized};
+    for (int s = 0; s < 2; ++s) {
+        for (const Particle& p : *systems[s]) {
+            momentumX[s] += p.mass * p.velocity.x;
+            momentumY[s] += p.mass * p.velocity.y;
+            kinetic[s] += 0.5 * p.mass * glm::dot(p.velocity, p.velocity);
+            if (s == 0) momentumScale += p.mass * glm::length(p.velocity);
+        }
+    }
+    double momentumError = std::hypot(momentumX[1] - momentumX[0], momentumY[1] - momentumY[0]) / std::max(momentumScale, 1e-12);
+    double energyError = std::abs(kinetic[1] - kinetic[0]) / std::max(kinetic[0], 1e-12);
+    return std::max(momentumError, energyError);
+}
+
+// True when the pair starts further than the rounding band from touching, so
+// every path must agree on whether it overlaps
+bool clearOfTouching(const Particle& a, const Particle& b, float roundingBand) {
+    double distance = std::hypot(static_cast<double>(b.position.x) - a.position.x,
+                                 static_cast<double>(b.position.y) - a.position.y);
+    return std::abs(distance - (a.radius + b.radius)) > roundingBand;
+}
+
+// Candidate sets (pairs overlapping at the step's starting positions) do not
+// depend on resolution order, so they must match exactly. Only pairs within
+// rounding distance of touching may differ.
+void compareCandidates(PhysicsEngine::ContactLog reference, PhysicsEngine::ContactLog optimized,
+                       const std::vector<Particle>& before, float roundingBand, DifferentialValidator::Report& report) {
+    std::sort(reference.begin(), reference.end());
+    std::sort(optimized.begin(), optimized.end());
+    PhysicsEngine::ContactLog difference;
+    std::set_symmetric_difference(reference.begin(), reference.end(), optimized.begin(), optimized.end(),
+                                  std::back_inserter(difference));
+    report.referenceCandidates += reference.size();
+    report.candidateMismatches += difference.size();
+    for (const auto& pair : difference) {
+        report.unexplainedMismatches += clearOfTouching(before[pair.first], before[pair.second], roundingBand);
+    }
+}
+
+// Compares two logs of resolved contacts: adds their symmetric difference to
+// the report and marks the particles whose step did not depend on contact
+// order: no contact in either run, or the same single contact with a partner
+// that has no other. A difference is explained when a particle of the pair had
+// other contacts (earlier resolutions moved it); between two otherwise isolated
+// particles only a pair within rounding distance of touching may differ.
+void compareContacts(PhysicsEngine::ContactLog reference, PhysicsEngine::ContactLog optimized,
+                     const std::vector<Particle>& before, float roundingBand,
+                     std::vector<char>& orderIndependent, DifferentialValidator::Report& report) {
+    const size_t count = before.size();
+    std::sort(reference.begin(), reference.end());
+    std::sort(optimized.begin(), optimized.end());
+    PhysicsEngine::ContactLog difference;
+    std::set_symmetric_difference(reference.begin(), reference.end(), optimized.begin(), optimized.end(),
+                                  std::back_inserter(difference));
+
+    std::vector<uint32_t> contacts(count, 0), optimizedContacts(count, 0), partner(count, 0);
+    for (const auto& contact : reference) {
+        contacts[contact.first]++;
+        contacts[contact.second]++;
+        partner[contact.first] = contact.second;
+        partner[contact.second] = contact.first;
+    }
+    for (const auto& contact : optimized) {
+        optimizedContacts[contact.first]++;
+        optimizedContacts[contact.second]++;
+    }
+    for (const auto& contact : reference) {
+        report.orderDependentContacts += contacts[contact.first] > 1 || contacts[contact.second] > 1;
+    }
+
+    std::vector<char> mismatched(count, 0);
+    for (const auto& contact : difference) {
+        mismatched[contact.first] = mismatched[contact.second] = 1;
+        // The pair itself is in exactly one of the runs
+        bool firstIsolated = contacts[contact.first] + optimizedContacts[contact.first] == 1;
+        bool secondIsolated = contacts[contact.second] + optimizedContacts[contact.second] == 1;
+        if (!firstIsolated || !secondIsolated) {
+            report.explainedMismatches++;
+        } else {
+            report.unexplainedMismatches += clearOfTouching(before[contact.first], before[contact.second], roundingBand);
+        }
+    }
+    report.contactMismatches += difference.size();
+
+    orderIndependent.assign(count, 0);
+    for (size_t i = 0; i < count; ++i) {
+        if (mismatched[i]) continue;
+        orderIndependent[i] = contacts[i] == 0 || (contacts[i] == 1 && contacts[partner[i]] == 1 && !mismatched[partner[i]]);
+    }
+}
+
+// Velocity errors are relative to the case's speed scale: an impulse error
+// follows the pair's relative speed, not the (possibly tiny) component it lands on
+void compareParticle(const Particle& reference, const Particle& optimized, float speedScale, DifferentialValidator::Report& report) {
+    report.maxPositionError = std::max({report.maxPositionError,
+                                        relativeError(reference.position.x, optimized.position.x, 1.0f),
+                                        relativeError(reference.position.y, optimized.position.y, 1.0f)});
+    report.maxVelocityError = std::max({report.maxVelocityError,
+                                        relativeError(reference.velocity.x, optimized.velocity.x, speedScale),
+                                        relativeError(reference.velocity.y, optimized.velocity.y, speedScale)});
+    report.comparedParticles++;
+}
+
+// Float spacing of the case's coordinates. Distances and collision normals come
+// from coordinate differences, so their rounding grows with the distance from
+// the origin.
+float coordinateEpsilon(const RandomCase& c, float extent) {
+    return FLT_EPSILON * (std::max(std::abs(c.center.x), std::abs(c.center.y)) + extent);
+}
+
+DifferentialValidator::Report makeReport(const char* path, const RandomCase& c, size_t particles, size_t steps,
+                                         float extent, const DifferentialValidator::Tolerance& tolerance) {
+    DifferentialValidator::Report report = {};
+    report.path = path;
+    report.scenario = c.description;
+    report.particles = particles;
+    report.steps = steps;
+    report.velocityTolerance = tolerance.velocity + 8.0f * coordinateEpsilon(c, extent) / c.minRadius;
+    return report;
+}
+
+double fraction(size_t count, size_t total) {
+    return total > 0 ? static_cast<double>(count) / total : static_cast<double>(count);
+}
+
+bool withinTolerance(const DifferentialValidator::Report& report, const DifferentialValidator::Tolerance& tolerance) {
+    return fraction(report.unexplainedMismatches, report.referenceCandidates + report.referenceContacts) <= tolerance.contactMismatch
+        && fraction(report.explainedMismatches, report.orderDependentContacts) <= tolerance.explainedMismatch
+        && report.maxPositionError <= tolerance.position
+        && report.maxVelocityError <= report.velocityTolerance
+        && report.maxAggregateError <= tolerance.aggregate;
+}
+
+void configure(PhysicsEngine& engine, const RandomCase& c, CollisionBroadPhase broadPhase) {
+    engine.setGravity(c.gravity ? glm::vec2(0.0f, -9.81f) : glm::vec2(0.0f));
+    engine.setAirResistance(0.01f);
+    engine.setCollisionDamping(0.8f);
+    engine.setBroadPhase(broadPhase);
+}
+
+// Cell list with the tiled narrow phase against the all-pairs loop
+DifferentialValidator::Report validateCellList(const RandomCase& c, size_t steps, const DifferentialValidator::Tolerance& tolerance) {
+    const float deltaTime = 1.0f / 60.0f;
+    const float extent = halfExtent(c, c.particleCount);
+    const glm::vec2 minBounds = c.center - extent, maxBounds = c.center + extent;
+
+    PhysicsEngine reference, optimized;
+    configure(reference, c, CollisionBroadPhase::BruteForce);
+    configure(optimized, c, CollisionBroadPhase::CellList);
+    PhysicsEngine::ContactLog referenceContacts, optimizedContacts, referenceCandidates, optimizedCandidates;
+    reference.setContactLog(&referenceContacts);
+    optimized.setContactLog(&optimizedContacts);
+
+    ParticleSystem referenceSystem, optimizedSystem;
+    for (const Particle& particle : makeParticles(c, c.particleCount, c.seed)) {
+        referenceSystem.addParticle(particle);
+    }
+
+    DifferentialValidator::Report report = makeReport("cell_list", c, c.particleCount, steps, extent, tolerance);
+    const float roundingBand = 8.0f * coordinateEpsilon(c, extent);
+    const float speedScale = std::max(1.0f, c.speed);
+    std::vector<char> orderIndependent;
+    std::vector<Particle> before;
+    for (size_t step = 0; step < steps; ++step) {
+        // Boundaries are the same code on both sides, so they run once, untimed
+        reference.applyBoundaryConstraints(referenceSystem, minBounds, maxBounds);
+        before = referenceSystem.getParticles();
+        optimizedSystem.getParticles() = before;
+
+        auto start = Clock::now();
+        reference.integrateParticles(referenceSystem, deltaTime);
+        report.referenceMs += elapsedMs(start);
+
+        start = Clock::now();
+        optimized.integrateParticles(optimizedSystem, deltaTime);
+        report.optimizedMs += elapsedMs(start);
+
+        // Candidate sets come from an untimed rerun from the same state, so the
+        // extra overlap test stays out of the measured step
+        referenceSystem.getParticles() = before;
+        optimizedSystem.getParticles() = before;
+        reference.setContactLog(nullptr);
+        optimized.setContactLog(nullptr);
+        reference.setCandidateLog(&referenceCandidates);
+        optimized.setCandidateLog(&optimizedCandidates);
+        reference.integrateParticles(referenceSystem, deltaTime);
+        optimized.integrateParticles(optimizedSystem, deltaTime);
+        reference.setCandidateLog(nullptr);
+        optimized.setCandidateLog(nullptr);
+        reference.setContactLog(&referenceContacts);
+        optimized.setContactLog(&optimizedContacts);
+        compareCandidates(referenceCandidates, optimizedCandidates, before, roundingBand, report);
+
+        const auto& expected = referenceSystem.getParticles();
+        const auto& actual = optimizedSystem.getParticles();
+        report.referenceContacts += referenceContacts.size();
+        compareContacts(referenceContacts, optimizedContacts, before, roundingBand, orderIndependent, report);
+        for (size_t i = 0; i < expected.size(); ++i) {
+            if (orderIndependent[i]) compareParticle(expected[i], actual[i], speedScale, report);
+        }
+        report.maxAggregateError = std::max(report.maxAggregateError, aggregateError(expected, actual));
+    }
+    report.passed = withinTolerance(report, tolerance);
+    return report;
+}
+
+// Lockstep batch of small worlds against one brute-force engine per world. The
+// batched kernel visits pairs in the same order, so every particle is compared.
+DifferentialValidator::Report validateBatchedWorlds(const RandomCase& c, size_t steps, const DifferentialValidator::Tolerance& tolerance) {
+    const size_t worldCount = 64;
+    const size_t perWorld = std::min<size_t>(std::max<size_t>(c.particleCount / worldCount, 4), 48);
+    const float deltaTime = 1.0f / 60.0f;
+    const float extent = halfExtent(c, perWorld);
+    const glm::vec2 minBounds = c.center - extent, maxBounds = c.center + extent;
+
+    PhysicsEngine reference;
+    configure(reference, c, CollisionBroadPhase::BruteForce);
+    BatchedWorldEngine batched(worldCount, perWorld);
+    batched.setTimeStep(deltaTime);
+    batched.setGravity(c.gravity ? glm::vec2(0.0f, -9.81f) : glm::vec2(0.0f));
+    batched.setAirResistance(0.01f);
+    batched.setCollisionDamping(0.8f);
+    batched.setBounds(minBounds, maxBounds);
+
+    std::vector<ParticleSystem> systems(worldCount);
+    for (size_t w = 0; w < worldCount; ++w) {
+        std::vector<Particle> particles = makeParticles(c, perWorld, c.seed + w);
+        for (size_t p = 0; p < perWorld; ++p) {
+            systems[w].addParticle(particles[p]);
+            batched.setParticle(w, p, particles[p].position, particles[p].velocity, particles[p].mass, particles[p].radius);
+        }
+    }
+
+    DifferentialValidator::Report report = makeReport("batched_worlds", c, worldCount * perWorld, steps, extent, tolerance);
+    const float speedScale = std::max(1.0f, c.speed);
+    std::vector<Particle> batchedState;
+    for (size_t step = 0; step < steps; ++step) {
+        for (size_t w = 0; w < worldCount; ++w) {
+            const auto& particles = systems[w].getParticles();
+            for (size_t p = 0; p < perWorld; ++p) {
+                size_t index = p * worldCount + w;
+                batched.getPositionsX()[index] = particles[p].position.x;
+                batched.getPositionsY()[index] = particles[p].position.y;
+                batched.getVelocitiesX()[index] = particles[p].velocity.x;
+                batched.getVelocitiesY()[index] = particles[p].velocity.y;
+            }
+        }
+
+        size_t referenceContacts = 0;
+        auto start = Clock::now();
+        for (ParticleSystem& system : systems) {
+            reference.applyBoundaryConstraints(system, minBounds, maxBounds);
+            reference.integrateParticles(system, deltaTime);
+            referenceContacts += reference.getLastContactCount();
+        }
+        report.referenceMs += elapsedMs(start);
+
+        start = Clock::now();
+        batched.step();
+        report.optimizedMs += elapsedMs(start);
+
+        // Only counts are available from the batch. Pair order is the same, so
+        // any difference is unexplained.
+        size_t batchedContacts = batched.getLastContactCount();
+        size_t difference = std::max(referenceContacts, batchedContacts) - std::min(referenceContacts, batchedContacts);
+        report.referenceContacts += referenceContacts;
+        report.contactMismatches += difference;
+        report.unexplainedMismatches += difference;
+        for (size_t w = 0; w < worldCount; ++w) {
+            const auto& particles = systems[w].getParticles();
+            batchedState = particles;
+            for (size_t p = 0; p < perWorld; ++p) {
+                size_t index = p * worldCount + w;
+                batchedState[p].position = glm::vec2(batched.getPositionsX()[index], batched.getPositionsY()[index]);
+                batchedState[p].velocity = glm::vec2(batched.getVelocitiesX()[index], batched.getVelocitiesY()[index]);
+                compareParticle(particles[p], batchedState[p], speedScale, report);
+            }
+            report.maxAggregateError = std::max(report.maxAggregateError, aggregateError(particles, batchedState));
+        }
+    }
+    report.passed = withinTolerance(report, tolerance);
+    return report;
+}
+
+// Parallel counting sort against a one-thread build: the result must be identical
+DifferentialValidator::Report validateGridBuild(const RandomCase& c, size_t steps, const DifferentialValidator::Tolerance& tolerance) {
+    // Enough particles that every pool thread gets a chunk
+    ThreadPool parallelPool(std::max<size_t>(4, ThreadPool::shared().getThreadCount()));
+    ThreadPool serialPool(1);
+    const size_t count = std::max<size_t>(c.particleCount, 8192 * parallelPool.getThreadCount());
+
+    std::vector<Particle> particles = makeParticles(c, count, c.seed);
+    std::vector<float> x(count), y(count);
+    float maxRadius = 0.0f;
+    for (size_t i = 0; i < count; ++i) {
+        x[i] = particles[i].position.x - c.center.x;
+        y[i] = particles[i].position.y - c.center.y;
+        maxRadius = std::max(maxRadius, particles[i].radius);
+    }
+
+    UniformGrid reference(&serialPool), optimized(&parallelPool);
+    DifferentialValidator::Report report = makeReport("grid_build_threads", c, count, steps, 0.0f, tolerance);
+    for (size_t step = 0; step < steps; ++step) {
+        auto start = Clock::now();
+        reference.build(x.data(), y.data(), count, 2.0f * maxRadius);
+        report.referenceMs += elapsedMs(start);
+
+        start = Clock::now();
+        optimized.build(x.data(), y.data(), count, 2.0f * maxRadius);
+        report.optimizedMs += elapsedMs(start);
+
+        // Any differing slot is a mismatch; an exact match is the contract
+        const auto& expected = reference.getSortedIndices();
+        const auto& actual = optimized.getSortedIndices();
+        report.referenceContacts += count;
+        for (size_t i = 0; i < count; ++i) {
+            report.contactMismatches += expected[i] != actual[i];
+        }
+        if (reference.getCellOffsets() != optimized.getCellOffsets() || reference.getCellKeys() != optimized.getCellKeys()) {
+            report.contactMismatches++;
+        }
+        report.unexplainedMismatches = report.contactMismatches;
+        report.comparedParticles += count;
+    }
+    report.passed = report.contactMismatches == 0 && withinTolerance(report, tolerance);
+    return report;
+}
+
+struct ValidationPath {
+    const char* name;
+    DifferentialValidator::Report (*validate)(const RandomCase& c, size_t steps, const DifferentialValidator::Tolerance& tolerance);
+};
+
+const ValidationPath PATHS[] = {
+    {"cell_list", validateCellList},
+    {"batched_worlds", validateBatchedWorlds},
+    {"grid_build_threads", validateGridBuild},
+};
+
+} // namespace
+
+DifferentialValidator::DifferentialValidator(uint64_t seed)
+    : m_seed(seed) {
+    // Float rounding differs between paths (cell-local coordinates, reciprocal
+    // vs division); an actual bug moves values by orders of magnitude more
+    m_tolerance.position = 1e-4f;
+    m_tolerance.velocity = 1e-3f;
+    m_tolerance.contactMismatch = 0.0;
+    // Order-explained differences are 9-25% of the order-dependent contacts in
+    // 24 randomized cases (2% to 38% area fraction, 30 steps); the table
+    // prints how much of this bound each run used
+    m_tolerance.explainedMismatch = 0.30;
+    m_tolerance.aggregate = 0.02;
+}
+
+std::vector<DifferentialValidator::Report> DifferentialValidator::run(size_t caseCount, size_t particleCount, size_t steps) const {
+    std::mt19937_64 generator(m_seed);
+    std::vector<Report> reports;
+    for (size_t i = 0; i < caseCount; ++i) {
+        RandomCase c = makeCase(generator, particleCount);
+        for (const ValidationPath& path : PATHS) {
+            reports.push_back(path.validate(c, steps, m_tolerance));
+        }
+    }
+    return reports;
+}
@@ -0,0 +1,78 @@
+#ifndef DIFFERENTIAL_VALIDATOR_H
+#define DIFFERENTIAL_VALIDATOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Runs every optimized physics path side by side with its reference on
+// randomized cases and reports correctness together with the speedup, so an
+// optimization comes with evidence that it still computes the same thing.
+//
+// Paths and their references:
+//   cell_list           PhysicsEngine CellList   vs  PhysicsEngine BruteForce
+//   batched_worlds      BatchedWorldEngine       vs  one brute-force PhysicsEngine per world
+//   grid_build_threads  UniformGrid on the pool  vs  UniformGrid on one thread (must be identical)
+//
+// The engines run in lockstep: before every step the optimized state is reset
+// to the reference state, so chaotic divergence never accumulates and each
+// step is compared on its own. The candidate set (pairs overlapping at the
+// positions the step starts from) does not depend on visiting order, so it is
+// compared exactly; only pairs within rounding distance of touching may differ.
+// Contacts resolved sequentially do depend on the order, so per-particle states
+// are only compared exactly (within float tolerance) for particles whose step
+// is order-independent: no contact, or a single contact whose partner has no
+// other. Everything else is covered by system aggregates (momentum, energy)
+// and by the resolved contact sets: a contact resolved by only one path is
+// explained when either particle had other contacts that step (earlier
+// resolutions moved it). Explained differences are bounded as a fraction of
+// those order-dependent contacts, which keeps the bound flat across densities.
+//
+// New fast paths get an entry in the path table in DifferentialValidator.cpp.
+class DifferentialValidator {
+public:
+    struct Tolerance {
+        float position;          // relative to max(1, |reference|), per component
+        float velocity;          // relative to max(case speed, |reference|), per component
+        double contactMismatch;  // unexplained differences / (reference candidates + contacts)
+        double explainedMismatch; // order-explained contact differences / order-dependent reference contacts
+        double aggregate;        // relative momentum and kinetic energy error
+    };
+
+    struct Report {
+        std::string path;
+        std::string scenario;     // short description of the randomized case
+        size_t particles;
+        size_t steps;
+        size_t referenceCandidates;    // pairs overlapping before resolution
+        size_t candidateMismatches;    // symmetric difference of the candidate sets
+        size_t referenceContacts;
+        size_t orderDependentContacts; // reference contacts where a particle had other contacts
+        size_t contactMismatches;      // symmetric difference of the resolved contact sets
+        size_t explainedMismatches;    // contact differences where a particle had other contacts
+        size_t unexplainedMismatches;  // all other differences not within rounding of touching
+        size_t comparedParticles; // order-independent particle-steps checked exactly
+        float maxPositionError;   // relative, as in Tolerance
+        float maxVelocityError;
+        float velocityTolerance;  // base tolerance plus float spacing at the case's coordinates
+        double maxAggregateError;
+        double referenceMs;
+        double optimizedMs;
+        bool passed;
+    };
+
+    explicit DifferentialValidator(uint64_t seed);
+
+    void setTolerance(const Tolerance& tolerance) { m_tolerance = tolerance; }
+    const Tolerance& getTolerance() const { return m_tolerance; }
+
+    // caseCount randomized cases of up to particleCount particles, steps each, on every path
+    std::vector<Report> run(size_t caseCount, size_t particleCount, size_t steps) const;
+
+private:
+    uint64_t m_seed;
+    Tolerance m_tolerance;
+};
+
+#endif // DIFFERENTIAL_VALIDATOR_H
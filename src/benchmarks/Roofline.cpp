@@ -0,0 +1,282 @@
+#include "Roofline.h"
+#include "../physics/PhysicsEngine.h"
+#include "../utils/PerformanceProfiler.h"
+#include "../utils/ThreadPool.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <memory>
+#include <random>
+#include <unistd.h>
+
+namespace {
+
+using Clock = std::chrono::high_resolution_clock;
+
+double elapsedSeconds(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// glibc reports 0 for the cache sizes in many VMs; sysfs usually still has them
+size_t detectLlcBytes() {
+#ifdef _SC_LEVEL3_CACHE_SIZE
+    long size = sysconf(_SC_LEVEL3_CACHE_SIZE);
+    if (size > 0) return static_cast<size_t>(size);
+#endif
+    std::ifstream file("/sys/devices/system/cpu/cpu0/cache/index3/size"); // e.g. "32768K"
+    size_t kilobytes = 0;
+    if (file >> kilobytes && kilobytes > 0) return kilobytes * 1024;
+    return 32u << 20;
+}
+
+size_t physicalMemoryBytes() {
+    long pages = sysconf(_SC_PHYS_PAGES);
+    long pageSize = sysconf(_SC_PAGESIZE);
+    return pages > 0 && pageSize > 0 ? static_cast<size_t>(pages) * pageSize : size_t(1) << 30;
+}
+
+// Runs fn over [0, count) on the calling thread or split across the shared pool
+void forEachChunk(size_t count, bool allThreads, const ThreadPool::RangeFunction& fn) {
+    if (allThreads) {
+        ThreadPool::shared().parallelFor(0, count, fn, 1 << 16);
+    } else {
+        fn(0, count, 0);
+    }
+}
+
+void triad(float* __restrict a, const float* __restrict b, const float* __restrict c, float scalar, size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+        a[i] = b[i] + scalar * c[i];
+    }
+}
+
+void scaleInPlace(float* __restrict a, float scalar, float offset, size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+        a[i] = a[i] * scalar + offset;
+    }
+}
+
+// Best of five samples of sweep(begin, end) over [0, count). Small (cache-resident)
+// arrays are swept several times per sample so each sample lasts long enough to time.
+template <typename Sweep>
+double bestSweepGBs(size_t count, double bytesPerElement, bool allThreads, const Sweep& sweep) {
+    const double sweepBytes = bytesPerElement * count;
+    const size_t sweeps = std::max<size_t>(1, static_cast<size_t>((256.0 * (1 << 20)) / sweepBytes));
+    double best = 0.0;
+    for (int sample = 0; sample < 5; ++sample) {
+        auto start = Clock::now();
+        forEachChunk(count, allThreads, [&](size_t begin, size_t end, size_t) {
+            for (size_t pass = 0; pass < sweeps; ++pass) {
+                sweep(begin, end);
+            }
+        });
+        best = std::max(best, sweepBytes * sweeps / elapsedSeconds(start) * 1e-9);
+    }
+    return best;
+}
+
+// Triad bandwidth. Counts 16 bytes per element: STREAM's 12 plus the
+// write-allocate read of a[], which the kernel models include too (a pass that
+// updates a record pays for reading and writing its line). Arrays are first
+// touched by the threads that later sweep them.
+double measureTriadGBs(size_t count, bool allThreads) {
+    std::unique_ptr<float[]> a(new float[count]);
+    std::unique_ptr<float[]> b(new float[count]);
+    std::unique_ptr<float[]> c(new float[count]);
+    forEachChunk(count, allThreads, [&](size_t begin, size_t end, size_t) {
+        std::fill(a.get() + begin, a.get() + end, 0.0f);
+        std::fill(b.get() + begin, b.get() + end, 1.0f);
+        std::fill(c.get() + begin, c.get() + end, 2.0f);
+    });
+
+    double best = bestSweepGBs(count, 16.0, allThreads, [&](size_t begin, size_t end) {
+        triad(a.get(), b.get(), c.get(), 3.0f, begin, end);
+    });
+
+    volatile float sink = a[count / 2];
+    (void)sink;
+    return best;
+}
+
+// In-place read-modify-write stream: 8 bytes per element, the access pattern of
+// the per-particle passes (gravity, drag, integration) that update one array of records
+double measureReadModifyWriteGBs(size_t count, bool allThreads) {
+    std::unique_ptr<float[]> a(new float[count]);
+    forEachChunk(count, allThreads, [&](size_t begin, size_t end, size_t) {
+        std::fill(a.get() + begin, a.get() + end, 1.0f);
+    });
+
+    double best = bestSweepGBs(count, 8.0, allThreads, [&](size_t begin, size_t end) {
+        scaleInPlace(a.get(), 0.999999f, 1e-6f, begin, end);
+    });
+
+    volatile float sink = a[count / 2];
+    (void)sink;
+    return best;
+}
+
+// Independent multiply-add chains: enough of them to cover FMA latency on
+// every vector port, so the loop runs at the core's arithmetic throughput
+const int FMA_CHAINS = 64;
+
+float runMultiplyAddChains(size_t iterations) {
+    float acc[FMA_CHAINS];
+    for (int k = 0; k < FMA_CHAINS; ++k) {
+        acc[k] = 1.0f + k * 1e-3f;
+    }
+    for (size_t it = 0; it < iterations; ++it) {
+        for (int k = 0; k < FMA_CHAINS; ++k) {
+            acc[k] = acc[k] * 0.999999f + 1e-6f;
+        }
+    }
+    float sum = 0.0f;
+    for (int k = 0; k < FMA_CHAINS; ++k) {
+        sum += acc[k];
+    }
+    return sum;
+}
+
+double measureGflops(bool allThreads) {
+    const size_t iterations = 4000000;
+    const size_t threads = allThreads ? ThreadPool::shared().getThreadCount() : 1;
+    std::vector<float> sinks(threads);
+
+    double best = 0.0;
+    for (int sample = 0; sample < 3; ++sample) {
+        auto start = Clock::now();
+        forEachChunk(threads, allThreads, [&](size_t begin, size_t end, size_t) {
+            for (size_t t = begin; t < end; ++t) {
+                sinks[t] = runMultiplyAddChains(iterations);
+            }
+        });
+        best = std::max(best, 2.0 * FMA_CHAINS * iterations * threads / elapsedSeconds(start) * 1e-9);
+    }
+
+    volatile float sink = sinks[0];
+    (void)sink;
+    return best;
+}
+
+// Per-kernel cost model for the float engine. S is sizeof(Particle), the AoS
+// record every pass walks; the cell-list SoA copies are 4-byte columns.
+const double PARTICLE_BYTES = sizeof(Particle);
+const double GRAVITY_FLOPS = 6;          // g * m, / m, +=
+const double AIR_FLOPS = 20;             // length, normalize, k * v^2, / m, +=
+const double BOUNDARY_FLOPS = 4;         // position +/- radius per wall
+const double INTEGRATE_FLOPS = 8;        // v += a dt, x += v dt
+const double GRID_BUILD_BYTES = 36;      // SoA x/y written and read twice, cell key, sorted index (+ S read)
+const double GRID_BUILD_FLOPS = 11;      // offsets, bounds, cell coordinates
+const double GATHER_SCATTER_BYTES = 76;  // ten SoA columns out, six back, index and key reads (+ 3S)
+const double GATHER_SCATTER_FLOPS = 11;  // cell-local offsets, 1 / m, position deltas
+const double NARROW_BYTES = 48;          // SoA read once per row sweep, position/velocity written back
+const double PAIR_TEST_FLOPS = 11;       // dx, dy from cell offsets, radius sum, squared compare
+const double CONTACT_FLOPS = 35;         // sqrt, normal, separation, impulse
+
+} // namespace
+
+RooflineAnalyzer::Peaks RooflineAnalyzer::measurePeaks(bool allThreads) {
+    Peaks peaks;
+    peaks.threads = allThreads ? ThreadPool::shared().getThreadCount() : 1;
+    peaks.llcBytes = detectLlcBytes();
+
+    // DRAM: three arrays together 4x the LLC (at least 192 MB, at most a quarter of RAM)
+    size_t dramBytes = std::min(std::max(4 * peaks.llcBytes, size_t(192) << 20), physicalMemoryBytes() / 4);
+    peaks.dramBandwidthGBs = measureTriadGBs(dramBytes / 12, allThreads);
+    peaks.cacheBandwidthGBs = measureTriadGBs(peaks.llcBytes / 4 / 12, allThreads); // a quarter of the LLC
+    peaks.gflops = measureGflops(allThreads);
+    return peaks;
+}
+
+double RooflineAnalyzer::measureBandwidthGBs(size_t workingSetBytes, bool allThreads) {
+    const size_t bytes = std::max<size_t>(workingSetBytes, 64 << 10);
+    return std::max(measureTriadGBs(bytes / 12, allThreads), measureReadModifyWriteGBs(bytes / 4, allThreads));
+}
+
+std::vector<RooflineAnalyzer::Kernel> RooflineAnalyzer::measureKernels(size_t particleCount, size_t steps) {
+    // Uniform cloud at ~25% area fraction with gravity and drag, as in the demo
+    const float radius = 0.5f;
+    const float halfExtent = 0.5f * std::sqrt(particleCount * 3.14159265f * radius * radius / 0.25f);
+    const glm::vec2 minBounds(-halfExtent), maxBounds(halfExtent);
+    const glm::vec2 gravity(0.0f, -9.81f);
+    const float airResistance = 0.01f;
+    const float damping = 0.8f;
+    const float deltaTime = 1.0f / 60.0f;
+
+    ParticleSystem system;
+    std::mt19937 generator(4242);
+    std::uniform_real_distribution<float> position(-halfExtent + radius, halfExtent - radius);
+    std::uniform_real_distribution<float> velocity(-5.0f, 5.0f);
+    for (size_t i = 0; i < particleCount; ++i) {
+        Particle particle(glm::vec2(position(generator), position(generator)), 1.0f);
+        particle.velocity = glm::vec2(velocity(generator), velocity(generator));
+        particle.radius = radius;
+        system.addParticle(particle);
+    }
+
+    PerformanceProfiler profiler;
+    PhysicsEngine engine;
+    engine.setBroadPhase(CollisionBroadPhase::CellList);
+    engine.setProfiler(&profiler);
+
+    double boundaryMs = 0.0, gravityMs = 0.0, airMs = 0.0, collisionMs = 0.0, integrateMs = 0.0;
+    double pairTests = 0.0, contacts = 0.0;
+    auto timeMs = [](Clock::time_point start) { return elapsedSeconds(start) * 1e3; };
+
+    // Two warm-up steps size the grid and SoA buffers; the profiler history is cleared after them
+    const size_t warmup = 2;
+    for (size_t step = 0; step < warmup + steps; ++step) {
+        if (step == warmup) {
+            profiler.clearHistory();
+            boundaryMs = gravityMs = airMs = collisionMs = integrateMs = 0.0;
+            pairTests = contacts = 0.0;
+        }
+        auto start = Clock::now();
+        engine.applyBoundaryConstraints(system, minBounds, maxBounds);
+        boundaryMs += timeMs(start);
+
+        start = Clock::now();
+        engine.applyGravity(system, gravity);
+        gravityMs += timeMs(start);
+
+        start = Clock::now();
+        engine.applyAirResistance(system, airResistance);
+        airMs += timeMs(start);
+
+        start = Clock::now();
+        engine.handleCollisions(system, damping);
+        collisionMs += timeMs(start);
+        pairTests += engine.getLastPairTestCount();
+        contacts += engine.getLastContactCount();
+
+        start = Clock::now();
+        system.update(deltaTime);
+        integrateMs += timeMs(start);
+
+        profiler.flush();
+    }
+
+    const double n = static_cast<double>(particleCount);
+    const double perStep = 1.0 / steps;
+    const double buildMs = profiler.getProfileData("collision_grid_build").avgTime;
+    const double narrowMs = profiler.getProfileData("collision_narrow_phase").avgTime;
+    const double gatherScatterMs = std::max(0.0, collisionMs * perStep - buildMs - narrowMs);
+
+    // Footprints: AoS records, the engine's SoA copies (10 columns) and grid arrays (key, index, offsets)
+    const double records = n * PARTICLE_BYTES;
+    const double soa = n * 40;
+    const double grid = n * 20;
+
+    std::vector<Kernel> kernels;
+    kernels.push_back({"boundaries", false, boundaryMs * perStep, n * PARTICLE_BYTES, n * BOUNDARY_FLOPS, records});
+    kernels.push_back({"gravity", false, gravityMs * perStep, n * 2 * PARTICLE_BYTES, n * GRAVITY_FLOPS, records});
+    kernels.push_back({"air_resistance", false, airMs * perStep, n * 2 * PARTICLE_BYTES, n * AIR_FLOPS, records});
+    kernels.push_back({"collision_grid_build", true, buildMs, n * (PARTICLE_BYTES + GRID_BUILD_BYTES), n * GRID_BUILD_FLOPS,
+                       records + grid});
+    kernels.push_back({"collision_gather_scatter", false, gatherScatterMs,
+                       n * (3 * PARTICLE_BYTES + GATHER_SCATTER_BYTES), n * GATHER_SCATTER_FLOPS, records + soa + grid});
+    kernels.push_back({"collision_narrow_phase", false, narrowMs, n * NARROW_BYTES,
+                       (pairTests * PAIR_TEST_FLOPS + contacts * CONTACT_FLOPS) * perStep, soa + grid});
+    kernels.push_back({"integrate", false, integrateMs * perStep, n * 2 * PARTICLE_BYTES, n * INTEGRATE_FLOPS, records});
+    return kernels;
+}
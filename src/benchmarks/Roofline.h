@@ -0,0 +1,56 @@
+#ifndef ROOFLINE_H
+#define ROOFLINE_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// Roofline analysis of a PhysicsEngine step.
+//
+// Built-in probes measure what this machine (and this build) can reach: a
+// STREAM triad for memory bandwidth, once with arrays far larger than the LLC
+// and once with an LLC-resident working set, and independent multiply-add
+// chains for the FLOP rate. Each kernel of a cell-list step is then timed on a
+// uniform cloud; its bytes and FLOPs come from a per-kernel model (per
+// particle, per pair test, per contact), which gives achieved GB/s, GFLOP/s and
+// arithmetic intensity. Kernels left of the ridge point (peak FLOP/s divided by
+// peak bandwidth) are bandwidth-bound, the rest compute-bound.
+//
+// A kernel's bandwidth roof is probed at its own footprint, as the best of the
+// triad and an in-place read-modify-write stream, so the roof covers whatever
+// cache level the kernel's data actually lives in.
+//
+// Traffic is modelled, not counted: every touched line is assumed to come from
+// memory once per pass and, if written, to go back once. A kernel above its
+// roof means the model overcounts (e.g. data still cached from the previous pass).
+class RooflineAnalyzer {
+public:
+    struct Peaks {
+        size_t threads;
+        double dramBandwidthGBs;
+        double cacheBandwidthGBs; // LLC-resident triad
+        double gflops;
+        size_t llcBytes;
+    };
+
+    struct Kernel {
+        std::string name;
+        bool parallel;          // runs on the thread pool, so it is held to the all-thread roof
+        double msPerStep;
+        double bytesPerStep;    // modelled
+        double flopsPerStep;    // modelled
+        double workingSetBytes; // modelled footprint the kernel sweeps
+    };
+
+    // Probes on the calling thread only, or on every ThreadPool::shared() thread
+    static Peaks measurePeaks(bool allThreads);
+
+    // Bandwidth roof for a given footprint: the best of the triad and the
+    // read-modify-write probe with that many bytes of arrays
+    static double measureBandwidthGBs(size_t workingSetBytes, bool allThreads);
+
+    // Times each kernel of a CellList PhysicsEngine step
+    static std::vector<Kernel> measureKernels(size_t particleCount, size_t steps);
+};
+
+#endif // ROOFLINE_H
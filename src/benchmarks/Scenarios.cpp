@@ -0,0 +1,236 @@
+#include "Scenarios.h"
+#include "../physics/PhysicsEngine.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <random>
+
+namespace {
+
+struct World {
+    ParticleSystem system;
+    PhysicsEngine engine;
+    glm::vec2 minBounds;
+    glm::vec2 maxBounds;
+    std::mt19937 generator;
+};
+
+struct ScenarioDefinition {
+    const char* name;
+    const char* description;
+    uint32_t seed;
+    size_t steps;
+    void (*setup)(World& world);
+    void (*beforeStep)(World& world, size_t step); // nullptr = none
+    ScenarioSuite::Reference reference;
+};
+
+void addParticle(World& world, glm::vec2 position, glm::vec2 velocity, float mass, float radius) {
+    Particle particle(position, mass);
+    particle.velocity = velocity;
+    particle.radius = radius;
+    world.system.addParticle(particle);
+}
+
+// Settled-looking block of 20k equal spheres on the floor of a closed box
+void setupDensePile(World& world) {
+    world.minBounds = glm::vec2(-100.0f, -100.0f);
+    world.maxBounds = glm::vec2(100.0f, 100.0f);
+    world.engine.setGravity(glm::vec2(0.0f, -9.81f));
+
+    std::uniform_real_distribution<float> jitter(-0.02f, 0.02f);
+    const float radius = 0.5f;
+    const float spacing = 1.05f;
+    const int perRow = static_cast<int>(200.0f / spacing) - 1;
+    for (int i = 0; i < 20000; ++i) {
+        glm::vec2 position(-99.0f + (i % perRow) * spacing + jitter(world.generator),
+                           -99.0f + (i / perRow) * spacing);
+        addParticle(world, position, glm::vec2(0.0f), 1.0f, radius);
+    }
+}
+
+// Fast, sparse gas: almost every grid cell empty, rare contacts
+void setupDiluteGas(World& world) {
+    world.minBounds = glm::vec2(-500.0f, -500.0f);
+    world.maxBounds = glm::vec2(500.0f, 500.0f);
+
+    std::uniform_real_distribution<float> position(-495.0f, 495.0f);
+    std::uniform_real_distribution<float> velocity(-20.0f, 20.0f);
+    std::uniform_real_distribution<float> radius(0.3f, 0.6f);
+    for (int i = 0; i < 20000; ++i) {
+        addParticle(world, glm::vec2(position(world.generator), position(world.generator)),
+                    glm::vec2(velocity(world.generator), velocity(world.generator)), 1.0f, radius(world.generator));
+    }
+}
+
+// Eight Gaussian blobs falling towards the centre: load moves between cells over time
+void setupClusteredCollapse(World& world) {
+    world.minBounds = glm::vec2(-200.0f, -200.0f);
+    world.maxBounds = glm::vec2(200.0f, 200.0f);
+
+    std::uniform_real_distribution<float> center(-150.0f, 150.0f);
+    std::normal_distribution<float> spread(0.0f, 20.0f);
+    std::normal_distribution<float> noise(0.0f, 1.0f);
+    std::uniform_real_distribution<float> radius(0.4f, 0.6f);
+    for (int cluster = 0; cluster < 8; ++cluster) {
+        glm::vec2 c(center(world.generator), center(world.generator));
+        for (int i = 0; i < 2500; ++i) {
+            glm::vec2 position = glm::clamp(c + glm::vec2(spread(world.generator), spread(world.generator)),
+                                            world.minBounds + 1.0f, world.maxBounds - 1.0f);
+            glm::vec2 velocity = -0.1f * position + glm::vec2(noise(world.generator), noise(world.generator));
+            addParticle(world, position, velocity, 1.0f, radius(world.generator));
+        }
+    }
+}
+
+// Four nozzles spray particles in; the floor drains them. Population cycles
+// through spawn, fall and removal, so the grid sees constant churn.
+void setupEmitters(World& world) {
+    world.minBounds = glm::vec2(-100.0f, -100.0f);
+    world.maxBounds = glm::vec2(100.0f, 100.0f);
+    world.engine.setGravity(glm::vec2(0.0f, -9.81f));
+}
+
+void emitAndDrain(World& world, size_t) {
+    const float drainY = world.minBounds.y + 2.0f;
+    world.system.removeParticlesIf([drainY](const Particle& p) { return p.position.y - p.radius < drainY; });
+
+    std::uniform_real_distribution<float> spread(-3.0f, 3.0f);
+    std::uniform_real_distribution<float> radius(0.4f, 0.8f);
+    const float nozzles[] = {-60.0f, -20.0f, 20.0f, 60.0f};
+    for (float x : nozzles) {
+        for (int i = 0; i < 10; ++i) {
+            glm::vec2 position(x + spread(world.generator), 90.0f + spread(world.generator));
+            glm::vec2 velocity(2.0f * spread(world.generator), -10.0f + spread(world.generator));
+            addParticle(world, position, velocity, 1.0f, radius(world.generator));
+        }
+    }
+}
+
+// Mostly small grains with a few boulders: the grid cell follows the largest diameter
+void setupMixedRadii(World& world) {
+    world.minBounds = glm::vec2(-150.0f, -150.0f);
+    world.maxBounds = glm::vec2(150.0f, 150.0f);
+    world.engine.setGravity(glm::vec2(0.0f, -9.81f));
+
+    std::uniform_real_distribution<float> position(-145.0f, 145.0f);
+    std::uniform_real_distribution<float> velocity(-2.0f, 2.0f);
+    std::uniform_real_distribution<float> pick(0.0f, 1.0f);
+    for (int i = 0; i < 15000; ++i) {
+        float p = pick(world.generator);
+        float radius = p < 0.95f ? 0.5f : (p < 0.995f ? 2.0f : 6.0f);
+        addParticle(world, glm::vec2(position(world.generator), position(world.generator)),
+                    glm::vec2(velocity(world.generator), velocity(world.generator)), radius * radius, radius);
+    }
+}
+
+// A million tiny passive markers in a large box: bandwidth-bound, nearly contact-free
+void setupTracers(World& world) {
+    world.minBounds = glm::vec2(-1000.0f, -1000.0f);
+    world.maxBounds = glm::vec2(1000.0f, 1000.0f);
+
+    std::uniform_real_distribution<float> position(-999.0f, 999.0f);
+    std::uniform_real_distribution<float> velocity(-5.0f, 5.0f);
+    for (int i = 0; i < 1000000; ++i) {
+        addParticle(world, glm::vec2(position(world.generator), position(world.generator)),
+                    glm::vec2(velocity(world.generator), velocity(world.generator)), 1.0f, 0.05f);
+    }
+}
+
+// References: contacts/step, KE/particle, centre-of-mass y, final particle count,
+// tolerance. Measured on x86-64 (GCC 12, -O3 -march=native and -O2 generic builds,
+// 1 and 4 threads). mixed_radii gets a wider band: its few boulders make the
+// energy sensitive to FP contraction.
+const ScenarioDefinition SCENARIOS[] = {
+    {"dense_pile", "20k equal spheres settling under gravity", 1001, 400, setupDensePile, nullptr,
+     {68362.2, 4.013, -91.66, 20000, 0.10}},
+    {"dilute_gas", "20k fast particles in a 1000x1000 box", 1002, 400, setupDiluteGas, nullptr,
+     {106.7, 70.35, -1.46, 20000, 0.10}},
+    {"clustered_collapse", "8 Gaussian clusters of 2.5k falling inwards", 1003, 400, setupClusteredCollapse, nullptr,
+     {28488.0, 61.75, 15.72, 20000, 0.10}},
+    {"emitters", "4 nozzles x 10 particles/step with a draining floor", 1004, 1200, setupEmitters, emitAndDrain,
+     {9325.4, 754.1, 18.66, 12598, 0.10}},
+    {"mixed_radii", "15k particles, radii 0.5 / 2 / 6 (95 / 4.5 / 0.5 %)", 1005, 400, setupMixedRadii, nullptr,
+     {14210.0, 182.2, -123.8, 15000, 0.15}},
+    {"tracers_1m", "1M tiny tracers in a 2000x2000 box", 1006, 30, setupTracers, nullptr,
+     {2106.4, 8.251, -0.53, 1000000, 0.10}},
+};
+
+const ScenarioDefinition* findScenario(const std::string& name) {
+    for (const ScenarioDefinition& scenario : SCENARIOS) {
+        if (name == scenario.name) return &scenario;
+    }
+    return nullptr;
+}
+
+bool withinTolerance(double value, double reference, double tolerance) {
+    return std::abs(value - reference) <= tolerance * std::max(std::abs(reference), 1.0);
+}
+
+} // namespace
+
+std::vector<std::string> ScenarioSuite::getScenarioNames() {
+    std::vector<std::string> names;
+    for (const ScenarioDefinition& scenario : SCENARIOS) {
+        names.push_back(scenario.name);
+    }
+    return names;
+}
+
+std::string ScenarioSuite::getDescription(const std::string& name) {
+    const ScenarioDefinition* scenario = findScenario(name);
+    return scenario ? scenario->description : "";
+}
+
+bool ScenarioSuite::run(const std::string& name, Result& result) const {
+    const ScenarioDefinition* scenario = findScenario(name);
+    if (!scenario) return false;
+
+    // Same step as the app: boundaries, then forces, collisions (cell list) and integration
+    World world;
+    world.generator.seed(scenario->seed);
+    world.engine.setGravity(glm::vec2(0.0f));
+    world.engine.setAirResistance(0.0f);
+    world.engine.setCollisionDamping(0.8f);
+    world.engine.setBroadPhase(CollisionBroadPhase::CellList);
+    scenario->setup(world);
+
+    const float deltaTime = 1.0f / 60.0f;
+    size_t contacts = 0;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (size_t step = 0; step < scenario->steps; ++step) {
+        if (scenario->beforeStep) {
+            scenario->beforeStep(world, step);
+        }
+        world.engine.applyBoundaryConstraints(world.system, world.minBounds, world.maxBounds);
+        world.engine.integrateParticles(world.system, deltaTime);
+        contacts += world.engine.getLastContactCount();
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+
+    const auto& particles = world.system.getParticles();
+    double kinetic = 0.0;
+    double massSum = 0.0;
+    double weightedY = 0.0;
+    for (const Particle& p : particles) {
+        kinetic += 0.5 * p.mass * glm::dot(p.velocity, p.velocity);
+        massSum += p.mass;
+        weightedY += p.mass * p.position.y;
+    }
+
+    result.name = scenario->name;
+    result.steps = scenario->steps;
+    result.metrics.msPerStep = std::chrono::duration<double, std::milli>(end - start).count() / scenario->steps;
+    result.metrics.contactsPerStep = static_cast<double>(contacts) / scenario->steps;
+    result.metrics.particleCount = particles.size();
+    result.metrics.kineticEnergy = particles.empty() ? 0.0 : kinetic / particles.size();
+    result.metrics.centerOfMassY = massSum > 0.0 ? weightedY / massSum : 0.0;
+    result.reference = scenario->reference;
+
+    const Reference& reference = scenario->reference;
+    result.withinTolerance = withinTolerance(result.metrics.contactsPerStep, reference.contactsPerStep, reference.tolerance)
+        && withinTolerance(result.metrics.kineticEnergy, reference.kineticEnergy, reference.tolerance)
+        && withinTolerance(result.metrics.centerOfMassY, reference.centerOfMassY, reference.tolerance)
+        && withinTolerance(static_cast<double>(result.metrics.particleCount), static_cast<double>(reference.particleCount), reference.tolerance);
+    return true;
+}
@@ -0,0 +1,55 @@
+#ifndef SCENARIOS_H
+#define SCENARIOS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Canned workloads that look like production runs rather than the demo's
+// uniform cloud: piles under gravity, dilute gases, collapsing clusters,
+// emitters with constant spawn/drain churn, wide radius distributions and a
+// million-particle tracer field. Each scenario is fully specified (seed, counts,
+// bounds, step count) and carries reference metrics measured with the
+// reference build; a run reports its own metrics and flags any outside the
+// tolerance, so a speedup that changes the physics shows up immediately.
+//
+// Metrics are aggregates (contacts per step, kinetic energy, centre of mass)
+// because trajectories are chaotic: thread count and FP reordering change
+// individual particles but not the statistics. References assume libstdc++'s
+// random distributions.
+class ScenarioSuite {
+public:
+    struct Metrics {
+        double msPerStep;
+        double contactsPerStep;
+        double kineticEnergy;   // per particle, at the end
+        double centerOfMassY;   // at the end
+        size_t particleCount;   // at the end
+    };
+
+    struct Reference {
+        double contactsPerStep;
+        double kineticEnergy;
+        double centerOfMassY;
+        size_t particleCount;
+        double tolerance;       // relative (absolute below 1.0)
+    };
+
+    struct Result {
+        std::string name;
+        size_t steps;
+        Metrics metrics;
+        Reference reference;
+        bool withinTolerance;
+    };
+
+    // Scenario names in run order
+    static std::vector<std::string> getScenarioNames();
+    static std::string getDescription(const std::string& name);
+
+    // Runs one scenario (false if the name is unknown)
+    bool run(const std::string& name, Result& result) const;
+};
+
+#endif // SCENARIOS_H
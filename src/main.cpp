@@ -1,33 +1,91 @@
 #include <iostream>
 #include <random>
 #include <chrono>
+#include <cmath>
+#include <memory>
 #include <thread>
 
 // Core systems
+#include "benchmarks/BenchmarkRunner.h"
 #include "particle/ParticleSystem.h"
+#include "physics/DeterministicPhysicsEngine.h"
+#include "physics/Dsmc.h"
+#include "physics/EventDrivenEngine.h"
+#include "physics/FlipFluid.h"
+#include "physics/KinematicObstacle.h"
+#include "physics/LangevinThermostat.h"
+#include "physics/LatticeBoltzmann.h"
+#include "physics/LennardJones.h"
+#include "physics/MultipleTimeStepping.h"
 #include "physics/PhysicsEngine.h"
+#include "physics/SignedDistanceField.h"
 #include "rendering/Renderer.h"
+#include "utils/FlightRecorder.h"
 #include "utils/JSONExporter.h"
 #include "utils/PerformanceProfiler.h"
+#include "utils/SamplingProfiler.h"
+#include "utils/ThreadPool.h"
 
+// Which engine advances the particles; the rigid-body PhysicsEngine unless one
+// of the alternative models was selected on the command line
+enum class SimulationMode {
+    Rigid,
+    Deterministic, // fixed-point physics path for bitwise-reproducible runs
+    Fluid,         // FLIP liquid instead of rigid-particle physics
+    EventDriven,   // exact hard-disk dynamics from an event queue
+    Dsmc,          // stochastic collisions per cell (rarefied gas)
+    LennardJones   // soft-potential MD in a periodic box
+};
+
+template <typename Precision>
 class ParticleSimulationApp {
 private:
+    using Position = typename BasicParticle<Precision>::Position;
+    using Vector = typename BasicParticle<Precision>::Vector;
+    
     // Core systems
-    ParticleSystem m_particleSystem;
-    PhysicsEngine m_physicsEngine;
+    BasicParticleSystem<Precision> m_particleSystem;
+    BasicPhysicsEngine<Precision> m_physicsEngine;
+    KinematicObstacleSet m_obstacles;
+    SignedDistanceField m_staticField;
+    LangevinThermostat m_thermostat;
+    LatticeBoltzmannSolver m_lattice;
+    BasicMultipleTimeStepIntegrator<Precision> m_multipleTimeStep;
+    SoftenedGravity m_mutualGravity;
+    
+    // Alternative engines, created in initialize() for the selected mode only
+    std::unique_ptr<DeterministicPhysicsEngine> m_deterministicEngine;
+    std::unique_ptr<FlipFluidSolver> m_fluid;
+    std::unique_ptr<EventDrivenEngine> m_eventEngine;
+    std::unique_ptr<DsmcEngine> m_dsmc;
+    std::unique_ptr<LennardJonesEngine> m_lennardJones;
+    
     Renderer m_renderer;
     JSONExporter m_jsonExporter;
     PerformanceProfiler m_profiler;
+    SamplingProfiler m_samplingProfiler;
+    FlightRecorder m_flightRecorder;
     
     // Simulation parameters
     int m_particleCount;
     bool m_isRunning;
     float m_simulationTime;
     int m_frameCount;
+    SimulationMode m_mode;
+    bool m_useObstacles;  // scripted piston and paddles
+    bool m_useStaticField; // SDF maze and terrain instead of the box
+    bool m_useThermostat;  // Langevin heat bath (Brownian motion)
+    bool m_useLattice;     // particles dragged by a lattice Boltzmann channel flow
+    int m_respaInterval;   // mutual gravity every k steps (RESPA), 0 = off
+    int m_sampleHz;       // call-stack sampling rate, 0 = off
     
     // Performance targets (from README)
     static const int TARGET_FPS = 60;
     static const int TARGET_PHYSICS_STEPS = 100;
+    static constexpr double TARGET_STARTUP_MS = 500.0; // Cold start budget (time to first frame)
+    
+    // Startup timing
+    std::chrono::high_resolution_clock::time_point m_startupBegin;
     
     // Random generation
     std::random_device m_rd;
@@ -39,17 +97,29 @@ public:
         , m_isRunning(false)
         , m_simulationTime(0.0f)
         , m_frameCount(0)
+        , m_mode(SimulationMode::Rigid)
+        , m_useObstacles(false)
+        , m_useStaticField(false)
+        , m_useThermostat(false)
+        , m_useLattice(false)
+        , m_respaInterval(0)
+        , m_sampleHz(0)
         , m_gen(m_rd()) {
         
         // Configure systems
         m_profiler.setTargetFPS(TARGET_FPS);
         m_profiler.setTargetPhysicsSteps(TARGET_PHYSICS_STEPS);
+        m_profiler.setTargetStartupTime(TARGET_STARTUP_MS);
+        m_physicsEngine.setProfiler(&m_profiler);
+        m_profiler.setFlightRecorder(&m_flightRecorder);
+        m_physicsEngine.setBroadPhase(CollisionBroadPhase::CellList);
         
         m_jsonExporter.setMaxFrames(500); // Limit memory usage
         m_jsonExporter.setExportOnDestroy(true);
         m_jsonExporter.setAutoExportFilename("output/simulation_data.json");
         
         std::cout << "=== Particle Simulation System ===" << std::endl;
+        std::cout << "Precision: " << Precision::name() << std::endl;
         std::cout << "Target Performance:" << std::endl;
         std::cout << "  - 60+ FPS with real-time rendering" << std::endl;
         std::cout << "  - 100 physics steps per second" << std::endl;
@@ -58,8 +128,58 @@ public:
         std::cout << std::endl;
     }
     
+    void setBroadPhase(CollisionBroadPhase broadPhase) {
+        m_physicsEngine.setBroadPhase(broadPhase);
+    }
+    
+    void setMode(SimulationMode mode) {
+        m_mode = mode;
+    }
+    
+    void setSeed(unsigned int seed) {
+        // Fixed seed so the initial state (and hence the trajectory) is reproducible
+        m_gen.seed(seed);
+    }
+    
+    void enableObstacles() {
+        m_useObstacles = true;
+    }
+    
+    void enableStaticField() {
+        m_useStaticField = true;
+    }
+    
+    void enableThermostat() {
+        m_useThermostat = true;
+    }
+    
+    void enableLattice() {
+        m_useLattice = true;
+    }
+    
+    void enableMultipleTimeStepping(int interval) {
+        m_respaInterval = interval;
+    }
+    
+    void useTscTimer() {
+        if (m_profiler.setTimerSource(PerformanceProfiler::TimerSource::Tsc)) {
+            std::cout << "[INIT] Profiler timing with the TSC (" << TscClock::getTicksPerSecond() / 1e9 << " GHz)" << std::endl;
+        }
+    }
+    
+    void enableSamplingProfiler(int frequencyHz) {
+        m_sampleHz = frequencyHz;
+    }
+    
+    void enableHardwareCounters() {
+        if (m_physicsEngine.enableHardwareCounters()) {
+            std::cout << "[INIT] Hardware cache counters enabled for collision narrow phase" << std::endl;
+        }
+    }
+    
     bool initialize() {
         std::cout << "[INIT] Initializing simulation systems..." << std::endl;
+        m_startupBegin = std::chrono::high_resolution_clock::now();
         
         // Initialize renderer
         if (!m_renderer.initialize(1280, 720, "Particle Simulation - Team B")) {
@@ -67,17 +187,137 @@ public:
             return false;
         }
         
+        const auto& startup = m_renderer.getStartupTimings();
+        m_profiler.recordStartupPhase("glfw_init", startup.glfwInitTime);
+        m_profiler.recordStartupPhase("gl_setup", startup.glSetupTime);
+        m_profiler.recordStartupPhase("shader_load", startup.shaderLoadTime);
+        
         // Set up viewport for particle world
         m_renderer.setViewport(glm::vec2(-100.0f, -100.0f), glm::vec2(100.0f, 100.0f));
         
+        // Static geometry first, so particles are not spawned inside it
+        if (m_useStaticField) {
+            auto fieldStart = std::chrono::high_resolution_clock::now();
+            m_staticField.setProfiler(&m_profiler);
+            if (!createStaticField()) {
+                std::cerr << "Failed to build the static distance field" << std::endl;
+                return false;
+            }
+            auto fieldEnd = std::chrono::high_resolution_clock::now();
+            double fieldMs = std::chrono::duration<double, std::milli>(fieldEnd - fieldStart).count();
+            m_profiler.recordStartupPhase("sdf_build", fieldMs);
+            std::cout << "[INIT] Baked " << m_staticField.getSegments().size() << " walls, "
+                      << m_staticField.getPolygons().size() << " polygons and " << m_staticField.getCircles().size()
+                      << " circles into a " << m_staticField.getNodesX() << "x" << m_staticField.getNodesY()
+                      << " distance field (" << fieldMs << " ms)" << std::endl;
+        }
+        
         // Create initial particles
+        auto creationStart = std::chrono::high_resolution_clock::now();
         createParticles();
+        auto creationEnd = std::chrono::high_resolution_clock::now();
+        m_profiler.recordStartupPhase("particle_creation",
+            std::chrono::duration<double, std::milli>(creationEnd - creationStart).count());
         
         // Configure physics engine (disabled for now)
-        m_physicsEngine.setGravity(glm::vec2(0.0f, 0.0f));    // No gravity
+        m_physicsEngine.setGravity(Vector(0.0f, 0.0f));       // No gravity
         m_physicsEngine.setAirResistance(0.0f);              // No air resistance
         m_physicsEngine.setCollisionDamping(0.8f);
         
+        if (m_useObstacles) {
+            createObstacles();
+            m_obstacles.setProfiler(&m_profiler);
+            m_physicsEngine.setObstacles(&m_obstacles);
+            std::cout << "[INIT] Created " << m_obstacles.getObstacles().size() << " kinematic obstacles" << std::endl;
+        }
+        
+        if (m_mode == SimulationMode::Fluid) {
+            m_fluid.reset(new FlipFluidSolver());
+            m_fluid->setDomain(glm::vec2(-100.0f, -100.0f), glm::vec2(100.0f, 100.0f), 5.0f);
+            m_fluid->setGravity(glm::vec2(0.0f, -40.0f));
+            m_fluid->setProfiler(&m_profiler);
+            std::cout << "[INIT] FLIP fluid on a " << m_fluid->getCellsX() << "x" << m_fluid->getCellsY()
+                      << " MAC grid, " << m_fluid->getLevelCount() << " multigrid levels" << std::endl;
+        }
+        
+        if (m_mode == SimulationMode::EventDriven) {
+            m_eventEngine.reset(new EventDrivenEngine());
+            m_eventEngine->setBounds(glm::vec2(-100.0f, -100.0f), glm::vec2(100.0f, 100.0f));
+            m_eventEngine->setProfiler(&m_profiler);
+            m_eventEngine->loadFrom(m_particleSystem);
+            std::cout << "[INIT] Event-driven hard-disk dynamics enabled" << std::endl;
+        }
+        
+        if (m_mode == SimulationMode::Dsmc) {
+            m_dsmc.reset(new DsmcEngine());
+            m_dsmc->setDomain(glm::vec2(-100.0f, -100.0f), glm::vec2(100.0f, 100.0f), 5.0f);
+            m_dsmc->setDiameter(4.0f); // about two mean radii
+            m_dsmc->setProfiler(&m_profiler);
+            m_dsmc->loadFrom(m_particleSystem);
+            std::cout << "[INIT] DSMC on " << m_dsmc->getCellCount() << " cells, mean free path "
+                      << m_dsmc->getMeanFreePath() << std::endl;
+        }
+        
+        if (m_mode == SimulationMode::LennardJones) {
+            // sigma = particle diameter; eps about the initial kT (uniform +-5
+            // velocities at the mean mass), so the gas starts near T* = 1
+            m_lennardJones.reset(new LennardJonesEngine());
+            m_lennardJones->setPotential(10.0f, 4.0f, 10.0f);
+            m_lennardJones->setSkin(1.2f);
+            m_lennardJones->setMass(1.25f);
+            m_lennardJones->setBox(-100.0f, -100.0f, 100.0f, 100.0f);
+            m_lennardJones->setProfiler(&m_profiler);
+            m_lennardJones->loadFrom(m_particleSystem);
+            std::cout << "[INIT] Lennard-Jones MD in a periodic box (eps 10, sigma 4, cutoff 10)" << std::endl;
+        }
+        
+        if (m_useThermostat) {
+            // About the temperature of the initial velocities
+            m_thermostat.setTemperature(10.0f);
+            m_thermostat.setFriction(0.5f);
+            m_thermostat.setProfiler(&m_profiler);
+            std::cout << "[INIT] Langevin thermostat at kT = 10" << std::endl;
+        }
+        
+        if (m_useLattice) {
+            // Channel flow along x between walls at y = +-100, driven to a peak
+            // of about 20 units/s (lattice speed 0.08)
+            m_lattice.setViscosity(50.0f);
+            m_lattice.setLatticeTimeStep(1.0f / 120.0f);
+            m_lattice.setDensity(0.05f);
+            m_lattice.setBodyForce(glm::vec2(0.2f, 0.0f));
+            m_lattice.setDragCoefficient(0.25f);
+            m_lattice.setProfiler(&m_profiler);
+            if (!m_lattice.setDomain(glm::vec2(-100.0f, -100.0f), glm::vec2(100.0f, 100.0f), 2.0f)) {
+                return false;
+            }
+            std::cout << "[INIT] Lattice Boltzmann flow on " << m_lattice.getCellsX() << "x" << m_lattice.getCellsY()
+                      << " cells, tau " << m_lattice.getRelaxationTime() << std::endl;
+        }
+        
+        if (m_respaInterval > 0) {
+            // Gentle mutual attraction (about 0.6 units/s^2 across the box)
+            m_mutualGravity.setStrength(10.0f);
+            m_mutualGravity.setSoftening(3.0f);
+            m_multipleTimeStep.addSlowForce([this](const BasicParticleSystem<Precision>& system,
+                                                   std::vector<Vector>& forces) {
+                return m_mutualGravity.compute(system, forces);
+            });
+            m_multipleTimeStep.setInterval(m_respaInterval);
+            m_multipleTimeStep.setProfiler(&m_profiler);
+            std::cout << "[INIT] Mutual gravity every " << m_respaInterval << " steps (RESPA)" << std::endl;
+        }
+        
+        if (m_mode == SimulationMode::Deterministic) {
+            m_deterministicEngine.reset(new DeterministicPhysicsEngine());
+            m_deterministicEngine->setGravity(glm::vec2(0.0f, 0.0f));
+            m_deterministicEngine->setCollisionDamping(0.8f);
+            m_deterministicEngine->setTimeStep(1.0f / TARGET_FPS);
+            m_deterministicEngine->setBounds(glm::vec2(-100.0f, -100.0f), glm::vec2(100.0f, 100.0f));
+            m_deterministicEngine->loadFrom(m_particleSystem);
+            std::cout << "[INIT] Deterministic fixed-point (Q32.32) physics enabled" << std::endl;
+        }
+        
         std::cout << "[INIT] Created " << m_particleCount << " particles" << std::endl;
         
         // Debug: Print first few particle positions
@@ -102,21 +342,106 @@ public:
         std::uniform_real_distribution<float> massDist(0.5f, 2.0f);   // Reasonable mass
         std::uniform_real_distribution<float> radiusDist(1.0f, 3.0f); // Small radii
         
+        // Liquid starts as a dam-break column at rest against the left wall
+        std::uniform_real_distribution<float> damX(-100.0f, -20.0f);
+        std::uniform_real_distribution<float> damY(-100.0f, 20.0f);
+        
+        // Lennard-Jones particles start on a square lattice: random placement
+        // overlaps pairs deep inside the r^-12 wall
+        const int latticeRow = static_cast<int>(std::ceil(std::sqrt(static_cast<float>(m_particleCount))));
+        const float latticeSpacing = 200.0f / latticeRow;
+        
         for (int i = 0; i < m_particleCount; ++i) {
-            glm::vec2 pos(posDist(m_gen), posDist(m_gen));
+            Position pos(posDist(m_gen), posDist(m_gen));
+            if (m_mode == SimulationMode::Fluid) {
+                pos = Position(damX(m_gen), damY(m_gen));
+            }
+            if (m_mode == SimulationMode::LennardJones) {
+                pos = Position(-100.0f + (i % latticeRow + 0.5f) * latticeSpacing,
+                               -100.0f + (i / latticeRow + 0.5f) * latticeSpacing);
+            }
             float mass = massDist(m_gen);
             
-            Particle particle(pos, mass);
-            particle.velocity = glm::vec2(velDist(m_gen), velDist(m_gen));
+            BasicParticle<Precision> particle(pos, mass);
+            particle.velocity = Vector(velDist(m_gen), velDist(m_gen));
             particle.radius = radiusDist(m_gen); // Use normal radius
+            if (m_mode == SimulationMode::Fluid) {
+                particle.velocity = Vector(0.0f, 0.0f);
+            }
+            if (m_mode == SimulationMode::LennardJones) {
+                particle.radius = 2.0f; // sigma / 2
+            }
+            
+            // Redraw positions inside the static geometry (lattice sites are fixed)
+            if (m_useStaticField && m_mode != SimulationMode::LennardJones &&
+                m_staticField.sample(glm::vec2(pos.x, pos.y)) < static_cast<float>(particle.radius)) {
+                --i;
+                continue;
+            }
             
             m_particleSystem.addParticle(particle);
         }
     }
     
+    void createObstacles() {
+        // Piston sweeping up and down along the bottom of the world
+        KinematicObstacle piston(60.0f, 3.0f);
+        piston.addKeyframe(0.0f, glm::vec2(0.0f, -90.0f), 0.0f);
+        piston.addKeyframe(2.0f, glm::vec2(0.0f, -50.0f), 0.0f);
+        piston.addKeyframe(4.0f, glm::vec2(0.0f, -90.0f), 0.0f);
+        m_obstacles.addObstacle(piston);
+        
+        // Two paddles turning in opposite directions
+        const float turn = 2.0f * static_cast<float>(M_PI);
+        KinematicObstacle leftPaddle(25.0f, 2.0f);
+        leftPaddle.addKeyframe(0.0f, glm::vec2(-45.0f, 30.0f), 0.0f);
+        leftPaddle.addKeyframe(3.0f, glm::vec2(-45.0f, 30.0f), turn);
+        m_obstacles.addObstacle(leftPaddle);
+        
+        KinematicObstacle rightPaddle(25.0f, 2.0f);
+        rightPaddle.addKeyframe(0.0f, glm::vec2(45.0f, 30.0f), 0.0f);
+        rightPaddle.addKeyframe(3.0f, glm::vec2(45.0f, 30.0f), -turn);
+        m_obstacles.addObstacle(rightPaddle);
+    }
+    
+    bool createStaticField() {
+        // World box
+        m_staticField.addContainer(glm::vec2(-100.0f, -100.0f), glm::vec2(100.0f, 100.0f));
+        
+        // Maze: staggered walls with alternating gaps
+        for (int row = 0; row < 4; ++row) {
+            float y = 60.0f - row * 30.0f;
+            float gapX = (row % 2 == 0) ? 60.0f : -60.0f;
+            m_staticField.addSegment(glm::vec2(-100.0f, y), glm::vec2(gapX - 12.0f, y), 1.5f);
+            m_staticField.addSegment(glm::vec2(gapX + 12.0f, y), glm::vec2(100.0f, y), 1.5f);
+        }
+        
+        // Rolling terrain along the bottom
+        std::vector<glm::vec2> terrain;
+        terrain.push_back(glm::vec2(100.0f, -110.0f));
+        terrain.push_back(glm::vec2(-100.0f, -110.0f));
+        for (int i = 0; i <= 40; ++i) {
+            float x = -100.0f + i * 5.0f;
+            terrain.push_back(glm::vec2(x, -85.0f + 8.0f * std::sin(x * 0.08f)));
+        }
+        m_staticField.addPolygon(terrain);
+        
+        // Pegs between the lowest wall and the terrain
+        for (int i = 0; i < 5; ++i) {
+            m_staticField.addCircle(glm::vec2(-60.0f + i * 30.0f, -50.0f), 4.0f);
+        }
+        
+        // Band above the largest particle radius (3)
+        return m_staticField.build(glm::vec2(-100.0f, -100.0f), glm::vec2(100.0f, 100.0f), 0.5f, 4.0f);
+    }
+    
     void run() {
         std::cout << "[RUN] Starting simulation main loop..." << std::endl;
         
+        if (m_sampleHz > 0 && m_samplingProfiler.start(m_sampleHz)) {
+            std::cout << "[PROFILE] Sampling call stacks at " << m_sampleHz << " Hz" << std::endl;
+        }
+        
         m_isRunning = true;
         const float deltaTime = 1.0f / TARGET_FPS;
         auto lastTime = std::chrono::high_resolution_clock::now();
@@ -141,10 +466,15 @@ public:
             // Render
             render();
             
+            if (m_frameCount == 0) {
+                reportStartupTime();
+            }
+            
             // End profiling
             m_profiler.endFrame();
             m_profiler.updateFPS(m_renderer.getFPS());
             m_profiler.updateParticleCount(m_particleSystem.getParticles().size());
+            recordFlightFrame();
             
             // Export data periodically (every 30 frames for reasonable data rate)
             if (m_frameCount % 30 == 0) {
@@ -184,16 +514,57 @@ public:
         }
         updateCount++;
         
+        switch (m_mode) {
+        case SimulationMode::Deterministic:
+            m_deterministicEngine->step();
+            m_deterministicEngine->storeTo(m_particleSystem);
+            return;
+        case SimulationMode::Fluid:
+            m_fluid->step(m_particleSystem, deltaTime);
+            return;
+        case SimulationMode::EventDriven:
+            m_eventEngine->advance(deltaTime);
+            m_eventEngine->storeTo(m_particleSystem);
+            return;
+        case SimulationMode::Dsmc:
+            m_dsmc->setTimeStep(deltaTime);
+            m_dsmc->step();
+            m_dsmc->storeTo(m_particleSystem);
+            return;
+        case SimulationMode::LennardJones:
+            m_lennardJones->setTimeStep(deltaTime);
+            m_lennardJones->step();
+            m_lennardJones->storeTo(m_particleSystem);
+            return;
+        case SimulationMode::Rigid:
+            break;
+        }
+        
         // Apply boundary constraints (full screen - prevent off-screen)
-        m_physicsEngine.applyBoundaryConstraints(m_particleSystem, 
-                                                glm::vec2(-100.0f, -100.0f), 
-                                                glm::vec2(100.0f, 100.0f));
+        if (m_useStaticField) {
+            m_physicsEngine.applyBoundaryConstraints(m_particleSystem, m_staticField);
+        } else {
+            m_physicsEngine.applyBoundaryConstraints(m_particleSystem, 
+                                                    Position(-100.0f, -100.0f), 
+                                                    Position(100.0f, 100.0f));
+        }
         
         // Add some interactive forces
         addInteractiveForces();
         
+        if (m_useThermostat) {
+            m_thermostat.apply(m_particleSystem, deltaTime);
+        }
+        if (m_useLattice) {
+            m_lattice.step(m_particleSystem, deltaTime);
+        }
+        
         // Update physics
-        m_physicsEngine.integrateParticles(m_particleSystem, deltaTime);
+        if (m_respaInterval > 0) {
+            m_multipleTimeStep.step(m_particleSystem, m_physicsEngine, deltaTime);
+        } else {
+            m_physicsEngine.integrateParticles(m_particleSystem, deltaTime);
+        }
     }
     
     void addInteractiveForces() {
@@ -210,6 +581,12 @@ public:
         {
             PROFILE_SCOPE(m_profiler, "particle_rendering");
             m_renderer.renderParticleSystem(m_particleSystem);
+            if (m_useObstacles) {
+                m_renderer.renderObstacles(m_obstacles);
+            }
+            if (m_useStaticField) {
+                m_renderer.renderStaticGeometry(m_staticField);
+            }
         }
         
         // Present frame
@@ -217,6 +594,34 @@ public:
         m_renderer.pollEvents();
     }
     
+    void recordFlightFrame() {
+        FlightRecorder::FrameState state;
+        state.particleCount = static_cast<int>(m_particleSystem.getParticles().size());
+        state.contactCount = m_physicsEngine.getLastContactCount();
+        state.exportQueuedFrames = m_jsonExporter.getFrameCount();
+        state.exportQueueCapacity = m_jsonExporter.getMaxFrames();
+        state.exportBytes = m_jsonExporter.getTotalDataSize();
+        
+        if (m_flightRecorder.endFrame(m_frameCount, m_profiler.getFrameTime(), state)) {
+            std::cout << "[FLIGHT] Frame " << m_frameCount << " took " << m_profiler.getFrameTime() << " ms ("
+                      << m_flightRecorder.getMedianFrameTime() << " ms median), trace saved to "
+                      << m_flightRecorder.getLastDumpFile() << std::endl;
+        }
+    }
+    
+    void reportStartupTime() {
+        auto firstFrameTime = std::chrono::high_resolution_clock::now();
+        double timeToFirstFrame = std::chrono::duration<double, std::milli>(firstFrameTime - m_startupBegin).count();
+        m_profiler.recordTimeToFirstFrame(timeToFirstFrame);
+        
+        const auto& startup = m_renderer.getStartupTimings();
+        std::cout << "[STARTUP] GLFW init: " << startup.glfwInitTime << " ms, GL setup: " << startup.glSetupTime
+                  << " ms, shader load: " << startup.shaderLoadTime << " ms"
+                  << (startup.shaderFromCache ? " (cached)" : "") << std::endl;
+        std::cout << "[STARTUP] Time to first frame: " << timeToFirstFrame << " ms (target "
+                  << TARGET_STARTUP_MS << " ms: " << (m_profiler.isStartupTargetMet() ? "MET" : "MISSED") << ")" << std::endl;
+    }
+    
     void printPerformanceReport() {
         std::cout << "\n=== Performance Report (Frame " << m_frameCount << ") ===" << std::endl;
         std::cout << "Current FPS: " << m_renderer.getFPS() << std::endl;
@@ -236,18 +641,47 @@ public:
         if (renderData.callCount > 0) {
             std::cout << "Rendering: " << renderData.avgTime << " ms avg" << std::endl;
         }
+        if (m_respaInterval > 0) {
+            std::cout << "RESPA energy drift: " << m_multipleTimeStep.getEnergyDrift() * 100.0 << "% (max "
+                      << m_multipleTimeStep.getMaxEnergyDrift() * 100.0 << "%, walls and damped contacts included)" << std::endl;
+        }
         std::cout << std::endl;
     }
     
     void cleanup() {
         std::cout << "\n[CLEANUP] Finalizing simulation..." << std::endl;
         
-        // Export final performance data
+        // Export final performance data (merging scopes closed after the last endFrame)
+        m_profiler.flush();
         m_profiler.exportToFile("output/performance_profile.json");
         
+        if (m_samplingProfiler.isRunning()) {
+            m_samplingProfiler.stop();
+            if (m_samplingProfiler.writeFoldedStacks("output/performance_profile.folded")) {
+                std::cout << "[PROFILE] " << m_samplingProfiler.getSampleCount() << " samples ("
+                          << m_samplingProfiler.getDroppedSampleCount() << " dropped), handler overhead "
+                          << m_samplingProfiler.getOverheadPercent() << "% of CPU time" << std::endl;
+            }
+        }
+        
         // Export final simulation data
         m_jsonExporter.exportToFile("output/final_simulation_data.json");
         
+        if (m_deterministicEngine) {
+            std::cout << "[DETERMINISTIC] State hash after " << m_frameCount << " steps: 0x" << std::hex
+                      << m_deterministicEngine->computeStateHash() << std::dec << std::endl;
+        }
+        
+        if (m_lennardJones) {
+            std::cout << "[LJ] Total energy " << m_lennardJones->getTotalEnergy() << ", "
+                      << m_lennardJones->getNeighborListBuildCount() << " neighbor list builds" << std::endl;
+        }
+        
+        if (m_useObstacles) {
+            std::cout << "[OBSTACLES] BVH refits: " << m_obstacles.getRefitCount()
+                      << ", rebuilds: " << m_obstacles.getRebuildCount() << std::endl;
+        }
+        
         // Print final report
         std::cout << "\n=== Final Performance Summary ===" << std::endl;
         std::cout << m_profiler.getPerformanceReport() << std::endl;
@@ -261,13 +695,90 @@ public:
         std::cout << "  - simulation_data.json (continuous data)" << std::endl;
         std::cout << "  - final_simulation_data.json (complete dataset)" << std::endl;
         std::cout << "  - performance_profile.json (timing analysis)" << std::endl;
+        if (m_sampleHz > 0) {
+            std::cout << "  - performance_profile.folded (sampled call stacks, for flame graphs)" << std::endl;
+        }
         
         m_isRunning = false;
     }
 };
 
-int main(int argc, char* argv[]) {
+// Everything the command line selects, filled by main() and passed whole to runSimulation
+struct SimulationOptions {
     int particleCount = 500;
+    std::string precision = "float";   // float, double or mixed
+    bool bruteForce = false;
+    bool hardwareCounters = false;
+    SimulationMode mode = SimulationMode::Rigid;
+    unsigned int seed = 42;            // initial state for deterministic mode
+    bool obstacles = false;
+    bool staticField = false;
+    bool thermostat = false;
+    bool lattice = false;
+    int respaInterval = 0;             // 0 = no mutual gravity
+    int sampleHz = 0;                  // 0 = no call-stack sampling
+    bool tscTimer = false;
+};
+
+template <typename Precision>
+int runSimulation(const SimulationOptions& options) {
+    ParticleSimulationApp<Precision> app(options.particleCount);
+    if (options.bruteForce) {
+        app.setBroadPhase(CollisionBroadPhase::BruteForce);
+    }
+    if (options.hardwareCounters) {
+        app.enableHardwareCounters();
+    }
+    app.setMode(options.mode);
+    if (options.mode == SimulationMode::Deterministic) {
+        app.setSeed(options.seed);
+    }
+    if (options.obstacles) {
+        app.enableObstacles();
+    }
+    if (options.staticField) {
+        app.enableStaticField();
+    }
+    if (options.thermostat) {
+        app.enableThermostat();
+    }
+    if (options.lattice) {
+        app.enableLattice();
+    }
+    if (options.respaInterval > 0) {
+        app.enableMultipleTimeStepping(options.respaInterval);
+    }
+    if (options.sampleHz > 0) {
+        app.enableSamplingProfiler(options.sampleHz);
+    }
+    if (options.tscTimer) {
+        app.useTscTimer();
+    }
+    
+    if (!app.initialize()) {
+        std::cerr << "Failed to initialize simulation" << std::endl;
+        return -1;
+    }
+    
+    app.run();
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    SimulationOptions options;
+    std::string modeFlag; // the flag that chose options.mode, for conflict messages
+    
+    // The alternative engines each replace the whole physics step, so at most one may be chosen
+    auto selectMode = [&](SimulationMode mode, const std::string& flag) {
+        if (!modeFlag.empty() && modeFlag != flag) {
+            std::cerr << "Conflicting simulation modes: " << modeFlag << " and " << flag
+                      << " (choose one of --deterministic, --flip, --edmd, --dsmc, --lj)" << std::endl;
+            return false;
+        }
+        options.mode = mode;
+        modeFlag = flag;
+        return true;
+    };
     
     // Parse command line arguments
     for (int i = 1; i < argc; i++) {
@@ -282,6 +793,24 @@ int main(int argc, char* argv[]) {
             std::cout << std::endl;
             std::cout << "Options:" << std::endl;
             std::cout << "  --help, -h       Show this help message" << std::endl;
+            std::cout << "  --brute-force    Use O(n^2) all-pairs collision detection" << std::endl;
+            std::cout << "  --hw-counters    Report cache-miss rates of the collision kernel (Linux perf)" << std::endl;
+            std::cout << "  --sample-profile HZ  Sample call stacks at HZ (e.g. 997) into output/performance_profile.folded" << std::endl;
+            std::cout << "  --profiler-clock C   Timer behind profiler scopes: chrono (default) or tsc" << std::endl;
+            std::cout << "  --obstacles      Add a scripted piston and rotating paddles" << std::endl;
+            std::cout << "  --sdf-maze       Replace the box with a maze and terrain baked into a distance field" << std::endl;
+            std::cout << "  --flip           Simulate the particles as a FLIP liquid (dam break)" << std::endl;
+            std::cout << "  --edmd           Exact elastic hard-disk dynamics, event-driven instead of time-stepped" << std::endl;
+            std::cout << "  --dsmc           Rarefied gas: collisions sampled per cell by Direct Simulation Monte Carlo" << std::endl;
+            std::cout << "  --lj             Soft-potential Lennard-Jones molecular dynamics in a periodic box" << std::endl;
+            std::cout << "  --langevin       Couple the particles to a Langevin heat bath (Brownian motion)" << std::endl;
+            std::cout << "  --lbm            Immerse the particles in a lattice Boltzmann channel flow (two-way drag)" << std::endl;
+            std::cout << "  --respa K        Mutual gravity between particles, evaluated every K steps (multiple time stepping)" << std::endl;
+            std::cout << "  --precision P    Scalar precision: float, double or mixed (double positions)" << std::endl;
+            std::cout << "  --threads N      Worker threads for parallel physics passes (default: all cores)" << std::endl;
+            std::cout << "  --deterministic  Fixed-point physics with bitwise-reproducible results" << std::endl;
+            std::cout << "  --seed N         Initial-state seed for --deterministic (default: 42)" << std::endl;
+            std::cout << "  --bench NAME     Run a headless benchmark and exit (see --bench help)" << std::endl;
             std::cout << std::endl;
             std::cout << "Examples:" << std::endl;
             std::cout << "  " << argv[0] << "              # Run with 500 particles" << std::endl;
@@ -293,11 +822,94 @@ int main(int argc, char* argv[]) {
             std::cout << "  - JSON data export for ML training" << std::endl;
             std::cout << "  - Performance profiling and optimization" << std::endl;
             return 0;
+        } else if (arg == "--brute-force") {
+            options.bruteForce = true;
+        } else if (arg == "--hw-counters") {
+            options.hardwareCounters = true;
+        } else if (arg == "--sample-profile" && i + 1 < argc) {
+            try {
+                options.sampleHz = std::stoi(argv[++i]);
+            } catch (const std::exception&) {
+                std::cerr << "Invalid sampling rate: " << argv[i] << std::endl;
+                return 1;
+            }
+        } else if (arg == "--profiler-clock" && i + 1 < argc) {
+            std::string clock = argv[++i];
+            if (clock != "chrono" && clock != "tsc") {
+                std::cerr << "Invalid profiler clock: " << clock << " (expected chrono or tsc)" << std::endl;
+                return 1;
+            }
+            options.tscTimer = clock == "tsc";
+        } else if (arg == "--bench" && i + 1 < argc) {
+            // Remaining arguments belong to the benchmark
+            std::string benchmark = argv[++i];
+            std::vector<std::string> benchmarkArgs(argv + i + 1, argv + argc);
+            BenchmarkRunner runner;
+            if (benchmark == "help") {
+                runner.printUsage();
+                return 0;
+            }
+            return runner.run(benchmark, benchmarkArgs);
+        } else if (arg == "--obstacles") {
+            options.obstacles = true;
+        } else if (arg == "--sdf-maze") {
+            options.staticField = true;
+        } else if (arg == "--flip") {
+            if (!selectMode(SimulationMode::Fluid, arg)) {
+                return 1;
+            }
+        } else if (arg == "--edmd") {
+            if (!selectMode(SimulationMode::EventDriven, arg)) {
+                return 1;
+            }
+        } else if (arg == "--dsmc") {
+            if (!selectMode(SimulationMode::Dsmc, arg)) {
+                return 1;
+            }
+        } else if (arg == "--lj") {
+            if (!selectMode(SimulationMode::LennardJones, arg)) {
+                return 1;
+            }
+        } else if (arg == "--langevin") {
+            options.thermostat = true;
+        } else if (arg == "--lbm") {
+            options.lattice = true;
+        } else if (arg == "--respa" && i + 1 < argc) {
+            try {
+                options.respaInterval = std::max(1, std::stoi(argv[++i]));
+            } catch (const std::exception&) {
+                std::cerr << "Invalid RESPA interval: " << argv[i] << std::endl;
+                return 1;
+            }
+        } else if (arg == "--deterministic") {
+            if (!selectMode(SimulationMode::Deterministic, arg)) {
+                return 1;
+            }
+        } else if (arg == "--seed" && i + 1 < argc) {
+            try {
+                options.seed = static_cast<unsigned int>(std::stoul(argv[++i]));
+            } catch (const std::exception&) {
+                std::cerr << "Invalid seed: " << argv[i] << std::endl;
+                return 1;
+            }
+        } else if (arg == "--precision" && i + 1 < argc) {
+            options.precision = argv[++i];
+            if (options.precision != "float" && options.precision != "double" && options.precision != "mixed") {
+                std::cerr << "Invalid precision: " << options.precision << " (expected float, double or mixed)" << std::endl;
+                return 1;
+            }
+        } else if (arg == "--threads" && i + 1 < argc) {
+            try {
+                ThreadPool::setSharedThreadCount(std::max(1, std::stoi(argv[++i])));
+            } catch (const std::exception&) {
+                std::cerr << "Invalid thread count: " << argv[i] << std::endl;
+                return 1;
+            }
         } else {
             // Try to parse as particle count
             try {
-                particleCount = std::stoi(arg);
-                particleCount = std::max(1, std::min(particleCount, 2000)); // Clamp range
+                options.particleCount = std::stoi(arg);
+                options.particleCount = std::max(1, std::min(options.particleCount, 2000)); // Clamp range
             } catch (const std::exception&) {
                 std::cerr << "Invalid argument: " << arg << std::endl;
                 std::cerr << "Use --help for usage information" << std::endl;
@@ -306,19 +918,22 @@ int main(int argc, char* argv[]) {
         }
     }
     
-    std::cout << "Starting Particle Simulation with " << particleCount << " particles" << std::endl;
+    std::cout << "Starting Particle Simulation with " << options.particleCount << " particles" << std::endl;
     std::cout << "Usage: " << argv[0] << " [particle_count]" << std::endl;
     std::cout << std::endl;
     
     try {
-        ParticleSimulationApp app(particleCount);
-        
-        if (!app.initialize()) {
-            std::cerr << "Failed to initialize simulation" << std::endl;
-            return -1;
+        int result;
+        if (options.precision == "double") {
+            result = runSimulation<DoublePrecision>(options);
+        } else if (options.precision == "mixed") {
+            result = runSimulation<MixedPrecision>(options);
+        } else {
+            result = runSimulation<FloatPrecision>(options);
+        }
+        if (result != 0) {
+            return result;
         }
-        
-        app.run();
         
         std::cout << "\nSimulation completed successfully!" << std::endl;
         
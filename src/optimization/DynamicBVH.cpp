@@ -0,0 +1,108 @@
+#include "DynamicBVH.h"
+#include <algorithm>
+
+namespace {
+    AABB merge(const AABB& a, const AABB& b) {
+        return AABB{std::min(a.minX, b.minX), std::min(a.minY, b.minY),
+                    std::max(a.maxX, b.maxX), std::max(a.maxY, b.maxY)};
+    }
+}
+
+DynamicBVH::DynamicBVH()
+    : m_buildCost(0.0f)
+    , m_rebuildThreshold(1.5f) {
+}
+
+void DynamicBVH::build(const std::vector<AABB>& boxes) {
+    const uint32_t count = static_cast<uint32_t>(boxes.size());
+    m_nodes.clear();
+    m_items.resize(count);
+    m_itemBoxes.resize(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        m_items[i] = i;
+    }
+    if (count == 0) {
+        m_buildCost = 0.0f;
+        return;
+    }
+
+    // A binary tree with leaves of >= 1 item has fewer than 2n nodes
+    m_nodes.reserve(2 * count);
+    m_nodes.push_back(Node());
+    buildRange(0, 0, count, boxes);
+
+    for (uint32_t i = 0; i < count; ++i) {
+        m_itemBoxes[i] = boxes[m_items[i]];
+    }
+    m_buildCost = getCost();
+}
+
+void DynamicBVH::buildRange(uint32_t nodeIndex, uint32_t begin, uint32_t end, const std::vector<AABB>& boxes) {
+    AABB bounds = boxes[m_items[begin]];
+    AABB centroids{bounds.minX + bounds.maxX, bounds.minY + bounds.maxY, bounds.minX + bounds.maxX, bounds.minY + bounds.maxY};
+    for (uint32_t i = begin + 1; i < end; ++i) {
+        const AABB& box = boxes[m_items[i]];
+        bounds = merge(bounds, box);
+        float cx = box.minX + box.maxX;
+        float cy = box.minY + box.maxY;
+        centroids = merge(centroids, AABB{cx, cy, cx, cy});
+    }
+
+    if (end - begin <= MAX_LEAF_ITEMS) {
+        m_nodes[nodeIndex] = Node{bounds, begin, end - begin};
+        return;
+    }
+
+    // Median split along the longer centroid axis (centroids are kept doubled)
+    const bool splitX = (centroids.maxX - centroids.minX) >= (centroids.maxY - centroids.minY);
+    const uint32_t mid = begin + (end - begin) / 2;
+    std::nth_element(m_items.begin() + begin, m_items.begin() + mid, m_items.begin() + end,
+        [&](uint32_t a, uint32_t b) {
+            return splitX ? (boxes[a].minX + boxes[a].maxX) < (boxes[b].minX + boxes[b].maxX)
+                          : (boxes[a].minY + boxes[a].maxY) < (boxes[b].minY + boxes[b].maxY);
+        });
+
+    const uint32_t left = static_cast<uint32_t>(m_nodes.size());
+    m_nodes.push_back(Node());
+    m_nodes.push_back(Node());
+    m_nodes[nodeIndex] = Node{bounds, left, 0};
+    buildRange(left, begin, mid, boxes);
+    buildRange(left + 1, mid, end, boxes);
+}
+
+void DynamicBVH::refit(const std::vector<AABB>& boxes) {
+    for (size_t i = 0; i < m_items.size(); ++i) {
+        m_itemBoxes[i] = boxes[m_items[i]];
+    }
+
+    // Children follow their parents, so walking backwards is a bottom-up pass
+    for (size_t n = m_nodes.size(); n-- > 0;) {
+        Node& node = m_nodes[n];
+        if (node.count > 0) {
+            node.box = computeLeafBox(node);
+        } else {
+            node.box = merge(m_nodes[node.first].box, m_nodes[node.first + 1].box);
+        }
+    }
+}
+
+AABB DynamicBVH::computeLeafBox(const Node& node) const {
+    AABB box = m_itemBoxes[node.first];
+    for (uint32_t i = node.first + 1; i < node.first + node.count; ++i) {
+        box = merge(box, m_itemBoxes[i]);
+    }
+    return box;
+}
+
+float DynamicBVH::getCost() const {
+    if (m_nodes.empty()) return 0.0f;
+
+    // SAH: expected traversal cost of a random query, relative to the root
+    const float rootArea = std::max(m_nodes[0].box.perimeter(), 1e-6f);
+    float cost = 0.0f;
+    for (const Node& node : m_nodes) {
+        float weight = node.count > 0 ? static_cast<float>(node.count) : 1.0f;
+        cost += weight * node.box.perimeter() / rootArea;
+    }
+    return cost;
+}
@@ -0,0 +1,86 @@
+#ifndef DYNAMIC_BVH_H
+#define DYNAMIC_BVH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Axis-aligned box used by the BVH
+struct AABB {
+    float minX, minY;
+    float maxX, maxY;
+
+    float perimeter() const { return 2.0f * ((maxX - minX) + (maxY - minY)); } // 2D surface area
+    bool overlaps(const AABB& other) const {
+        return minX <= other.maxX && other.minX <= maxX && minY <= other.maxY && other.minY <= maxY;
+    }
+};
+
+// Bounding volume hierarchy over boxes that move every step.
+// build() does a median split on the longest centroid axis. refit() keeps the
+// topology and only recomputes node boxes bottom-up, which is O(n) with no
+// allocation; the tree degrades as items drift apart, so callers compare
+// getQualityRatio() (SAH cost now / SAH cost at the last build) against
+// getRebuildThreshold() and rebuild when it grows too large.
+class DynamicBVH {
+public:
+    DynamicBVH();
+
+    void build(const std::vector<AABB>& boxes);
+    void refit(const std::vector<AABB>& boxes); // boxes in the same order as at build()
+    bool needsRebuild() const { return m_nodes.empty() || getQualityRatio() > m_rebuildThreshold; }
+
+    // Calls callback(itemIndex) for every item whose box overlaps the query box
+    template <typename Callback>
+    void query(const AABB& box, Callback&& callback) const {
+        if (m_nodes.empty()) return;
+        uint32_t stack[MAX_DEPTH];
+        int top = 0;
+        stack[top++] = 0;
+        while (top > 0) {
+            const Node& node = m_nodes[stack[--top]];
+            if (!node.box.overlaps(box)) continue;
+            if (node.count > 0) {
+                for (uint32_t i = node.first; i < node.first + node.count; ++i) {
+                    if (m_itemBoxes[i].overlaps(box)) callback(m_items[i]);
+                }
+            } else {
+                stack[top++] = node.first;     // left child
+                stack[top++] = node.first + 1; // right child
+            }
+        }
+    }
+
+    // Tree quality (surface area heuristic, using perimeter as 2D area)
+    float getCost() const;
+    float getQualityRatio() const { return m_buildCost > 0.0f ? getCost() / m_buildCost : 1.0f; }
+    void setRebuildThreshold(float threshold) { m_rebuildThreshold = threshold; }
+    float getRebuildThreshold() const { return m_rebuildThreshold; }
+
+    size_t getNodeCount() const { return m_nodes.size(); }
+    size_t getItemCount() const { return m_items.size(); }
+
+private:
+    // Internal nodes store their children at first/first + 1; leaves store
+    // count > 0 items starting at first. Children always follow their parent,
+    // so a reverse sweep over m_nodes visits children before parents.
+    struct Node {
+        AABB box;
+        uint32_t first;
+        uint32_t count;
+    };
+
+    std::vector<Node> m_nodes;
+    std::vector<uint32_t> m_items;   // item indices in leaf order
+    std::vector<AABB> m_itemBoxes;   // item boxes in leaf order (refreshed by refit)
+    float m_buildCost;
+    float m_rebuildThreshold;
+
+    static const uint32_t MAX_LEAF_ITEMS = 2;
+    static const int MAX_DEPTH = 64;
+
+    void buildRange(uint32_t nodeIndex, uint32_t begin, uint32_t end, const std::vector<AABB>& boxes);
+    AABB computeLeafBox(const Node& node) const;
+};
+
+#endif // DYNAMIC_BVH_H
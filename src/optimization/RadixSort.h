@@ -0,0 +1,139 @@
+#ifndef RADIX_SORT_H
+#define RADIX_SORT_H
+
+#include "../utils/ThreadPool.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <type_traits>
+#include <vector>
+
+// LSD radix sort for unsigned 32/64-bit keys, optionally carrying a payload
+// (typically a particle index). Each 8-bit pass runs a parallel per-thread
+// histogram, an exclusive prefix sum over (digit, thread) and a parallel
+// stable scatter. Passes whose digit is identical for every key are skipped,
+// so keys that only use their low bits (Morton codes, cell ids) cost fewer passes.
+//
+// The sorter owns its scratch buffers; reusing one instance across steps
+// avoids reallocating them.
+template <typename Key, typename Value = uint32_t>
+class RadixSorter {
+    static_assert(std::is_integral<Key>::value && std::is_unsigned<Key>::value,
+                  "RadixSorter keys must be unsigned integers");
+
+public:
+    explicit RadixSorter(ThreadPool* threadPool = nullptr)
+        : m_threadPool(threadPool ? threadPool : &ThreadPool::shared())
+        , m_keyBits(sizeof(Key) * 8) {
+    }
+
+    // Only the low `bits` bits of each key take part in the sort
+    void setKeyBits(int bits) { m_keyBits = std::max(1, std::min(bits, static_cast<int>(sizeof(Key) * 8))); }
+
+    void sortKeys(std::vector<Key>& keys) {
+        m_keyScratch.resize(keys.size());
+        sortImpl(keys, nullptr);
+    }
+
+    // Returns false (and leaves both untouched) unless there is one value per key
+    bool sortPairs(std::vector<Key>& keys, std::vector<Value>& values) {
+        if (keys.size() != values.size()) {
+            std::cerr << "[RADIX] sortPairs: " << keys.size() << " keys but " << values.size() << " values" << std::endl;
+            return false;
+        }
+        m_keyScratch.resize(keys.size());
+        m_valueScratch.resize(values.size());
+        sortImpl(keys, &values);
+        return true;
+    }
+
+private:
+    static const int RADIX_BITS = 8;
+    static const size_t RADIX = size_t(1) << RADIX_BITS;
+    static const size_t MIN_KEYS_PER_THREAD = 16384;
+
+    ThreadPool* m_threadPool;
+    int m_keyBits;
+
+    std::vector<Key> m_keyScratch;
+    std::vector<Value> m_valueScratch;
+    std::vector<size_t> m_counts; // [chunk][digit] histograms, then scatter cursors
+
+    void sortImpl(std::vector<Key>& keys, std::vector<Value>* values) {
+        const size_t count = keys.size();
+        if (count < 2) return;
+
+        const size_t chunkCount = std::max<size_t>(1, std::min(m_threadPool->getThreadCount(), count / MIN_KEYS_PER_THREAD));
+        const size_t chunkSize = (count + chunkCount - 1) / chunkCount;
+        m_counts.resize(chunkCount * RADIX);
+
+        Key* source = keys.data();
+        Key* target = m_keyScratch.data();
+        Value* sourceValues = values ? values->data() : nullptr;
+        Value* targetValues = values ? m_valueScratch.data() : nullptr;
+        bool inScratch = false;
+
+        for (int shift = 0; shift < m_keyBits; shift += RADIX_BITS) {
+            // The last pass only looks at the digit bits below m_keyBits
+            const Key digitMask = static_cast<Key>(m_keyBits - shift < RADIX_BITS ? (size_t(1) << (m_keyBits - shift)) - 1 : RADIX - 1);
+
+            // Histogram per chunk
+            m_threadPool->parallelFor(0, chunkCount, [&](size_t chunkBegin, size_t chunkEnd, size_t) {
+                for (size_t chunk = chunkBegin; chunk < chunkEnd; ++chunk) {
+                    size_t* counts = &m_counts[chunk * RADIX];
+                    std::fill(counts, counts + RADIX, size_t(0));
+                    size_t end = std::min(count, (chunk + 1) * chunkSize);
+                    for (size_t i = chunk * chunkSize; i < end; ++i) {
+                        counts[(source[i] >> shift) & digitMask]++;
+                    }
+                }
+            });
+
+            // Skip the pass when every key shares this digit
+            size_t firstDigitTotal = 0;
+            size_t firstDigit = (source[0] >> shift) & digitMask;
+            for (size_t chunk = 0; chunk < chunkCount; ++chunk) {
+                firstDigitTotal += m_counts[chunk * RADIX + firstDigit];
+            }
+            if (firstDigitTotal == count) continue;
+
+            // Exclusive prefix sum in (digit, chunk) order gives each chunk its write cursors
+            size_t running = 0;
+            for (size_t digit = 0; digit < RADIX; ++digit) {
+                for (size_t chunk = 0; chunk < chunkCount; ++chunk) {
+                    size_t& entry = m_counts[chunk * RADIX + digit];
+                    size_t digitCount = entry;
+                    entry = running;
+                    running += digitCount;
+                }
+            }
+
+            // Stable scatter per chunk
+            m_threadPool->parallelFor(0, chunkCount, [&](size_t chunkBegin, size_t chunkEnd, size_t) {
+                for (size_t chunk = chunkBegin; chunk < chunkEnd; ++chunk) {
+                    size_t* cursors = &m_counts[chunk * RADIX];
+                    size_t end = std::min(count, (chunk + 1) * chunkSize);
+                    for (size_t i = chunk * chunkSize; i < end; ++i) {
+                        size_t slot = cursors[(source[i] >> shift) & digitMask]++;
+                        target[slot] = source[i];
+                        if (sourceValues) targetValues[slot] = sourceValues[i];
+                    }
+                }
+            });
+
+            std::swap(source, target);
+            std::swap(sourceValues, targetValues);
+            inScratch = !inScratch;
+        }
+
+        // An odd number of executed passes leaves the result in scratch; swapping
+        // the vectors is O(1) and the old storage becomes the next scratch buffer
+        if (inScratch) {
+            keys.swap(m_keyScratch);
+            if (values) values->swap(m_valueScratch);
+        }
+    }
+};
+
+#endif // RADIX_SORT_H
@@ -0,0 +1,159 @@
+#include "UniformGrid.h"
+#include <algorithm>
+#include <cmath>
+
+UniformGrid::UniformGrid(ThreadPool* threadPool)
+    : m_threadPool(threadPool ? threadPool : &ThreadPool::shared())
+    , m_cellsX(1)
+    , m_cellsY(1)
+    , m_cellSize(1.0f)
+    , m_originX(0.0f)
+    , m_originY(0.0f)
+    , m_chunkCount(1) {
+}
+
+void UniformGrid::build(const float* x, const float* y, size_t count, float cellSize, size_t cellBudget) {
+    computeLayout(x, y, count, cellSize, std::max(count, cellBudget));
+
+    // One chunk per thread, but every chunk carries a histogram over all cells, so
+    // the chunk count is also capped to keep histogram words in proportion to count.
+    // Small inputs run as a single serial chunk.
+    const size_t cellCount = getCellCount();
+    const size_t histogramChunks = count * MAX_HISTOGRAM_WORDS_PER_PARTICLE / std::max<size_t>(1, cellCount);
+    m_chunkCount = std::max<size_t>(1, std::min({m_threadPool->getThreadCount(), size_t(MAX_SORT_CHUNKS),
+                                                 histogramChunks, count / MIN_PARTICLES_PER_THREAD}));
+    const size_t chunkSize = (count + m_chunkCount - 1) / m_chunkCount;
+
+    m_cellKeys.resize(count);
+    m_sortedIndices.resize(count);
+    m_cellOffsets.resize(cellCount + 1);
+    m_threadCounts.resize(m_chunkCount * cellCount);
+
+    // Pass 1: cell keys and per-thread histograms
+    const float invCellSize = 1.0f / m_cellSize;
+    m_threadPool->parallelFor(0, m_chunkCount, [&](size_t chunkBegin, size_t chunkEnd, size_t) {
+        for (size_t chunk = chunkBegin; chunk < chunkEnd; ++chunk) {
+            uint32_t* counts = &m_threadCounts[chunk * cellCount];
+            std::fill(counts, counts + cellCount, 0u);
+
+            size_t end = std::min(count, (chunk + 1) * chunkSize);
+            for (size_t i = chunk * chunkSize; i < end; ++i) {
+                int cellX = std::min(static_cast<int>((x[i] - m_originX) * invCellSize), m_cellsX - 1);
+                int cellY = std::min(static_cast<int>((y[i] - m_originY) * invCellSize), m_cellsY - 1);
+                uint32_t key = static_cast<uint32_t>(cellIndex(std::max(cellX, 0), std::max(cellY, 0)));
+                m_cellKeys[i] = key;
+                counts[key]++;
+            }
+        }
+    });
+
+    // Pass 2: exclusive prefix sum over (cell, thread) -> cell offsets and write cursors
+    computeCellOffsets(cellCount);
+
+    // Pass 3: each thread scatters its own chunk; chunk order keeps the sort stable
+    m_threadPool->parallelFor(0, m_chunkCount, [&](size_t chunkBegin, size_t chunkEnd, size_t) {
+        for (size_t chunk = chunkBegin; chunk < chunkEnd; ++chunk) {
+            uint32_t* cursors = &m_threadCounts[chunk * cellCount];
+            size_t end = std::min(count, (chunk + 1) * chunkSize);
+            for (size_t i = chunk * chunkSize; i < end; ++i) {
+                m_sortedIndices[cursors[m_cellKeys[i]]++] = static_cast<uint32_t>(i);
+            }
+        }
+    });
+}
+
+void UniformGrid::computeCellOffsets(size_t cellCount) {
+    const size_t threads = m_threadPool->getThreadCount();
+    const size_t blockCount = std::max<size_t>(1, std::min(threads, cellCount / MIN_PARTICLES_PER_THREAD));
+    const size_t blockSize = (cellCount + blockCount - 1) / blockCount;
+    m_blockTotals.resize(blockCount + 1);
+
+    // Sum each block of cells across all thread histograms
+    m_threadPool->parallelFor(0, blockCount, [&](size_t blockBegin, size_t blockEnd, size_t) {
+        for (size_t block = blockBegin; block < blockEnd; ++block) {
+            uint32_t total = 0;
+            size_t end = std::min(cellCount, (block + 1) * blockSize);
+            for (size_t c = block * blockSize; c < end; ++c) {
+                for (size_t chunk = 0; chunk < m_chunkCount; ++chunk) {
+                    total += m_threadCounts[chunk * cellCount + c];
+                }
+            }
+            m_blockTotals[block + 1] = total;
+        }
+    });
+
+    m_blockTotals[0] = 0;
+    for (size_t block = 0; block < blockCount; ++block) {
+        m_blockTotals[block + 1] += m_blockTotals[block];
+    }
+
+    // Scan within each block, turning histogram entries into per-thread write cursors
+    m_threadPool->parallelFor(0, blockCount, [&](size_t blockBegin, size_t blockEnd, size_t) {
+        for (size_t block = blockBegin; block < blockEnd; ++block) {
+            uint32_t running = m_blockTotals[block];
+            size_t end = std::min(cellCount, (block + 1) * blockSize);
+            for (size_t c = block * blockSize; c < end; ++c) {
+                m_cellOffsets[c] = running;
+                for (size_t chunk = 0; chunk < m_chunkCount; ++chunk) {
+                    uint32_t& entry = m_threadCounts[chunk * cellCount + c];
+                    uint32_t cellCountForChunk = entry;
+                    entry = running;
+                    running += cellCountForChunk;
+                }
+            }
+        }
+    });
+
+    m_cellOffsets[cellCount] = m_blockTotals[blockCount];
+}
+
+void UniformGrid::computeLayout(const float* x, const float* y, size_t count, float cellSize, size_t cellBudget) {
+    // Parallel bounds reduction: each chunk writes its own min/max slot
+    const size_t boundsChunks = std::max<size_t>(1, std::min(m_threadPool->getThreadCount(), count / MIN_PARTICLES_PER_THREAD));
+    m_threadBounds.resize(boundsChunks * 4);
+    const size_t chunkSize = (count + boundsChunks - 1) / boundsChunks;
+    m_threadPool->parallelFor(0, boundsChunks, [&](size_t chunkBegin, size_t chunkEnd, size_t) {
+        for (size_t chunk = chunkBegin; chunk < chunkEnd; ++chunk) {
+            size_t begin = chunk * chunkSize;
+            size_t end = std::min(count, begin + chunkSize);
+            float* bounds = &m_threadBounds[chunk * 4];
+            bounds[0] = bounds[2] = begin < end ? x[begin] : 0.0f;
+            bounds[1] = bounds[3] = begin < end ? y[begin] : 0.0f;
+            for (size_t i = begin; i < end; ++i) {
+                bounds[0] = std::min(bounds[0], x[i]);
+                bounds[1] = std::min(bounds[1], y[i]);
+                bounds[2] = std::max(bounds[2], x[i]);
+                bounds[3] = std::max(bounds[3], y[i]);
+            }
+        }
+    });
+
+    float minX = 0.0f, minY = 0.0f, maxX = 0.0f, maxY = 0.0f;
+    bool first = true;
+    for (size_t chunk = 0; chunk < boundsChunks; ++chunk) {
+        if (chunk * chunkSize >= count) break;
+        const float* bounds = &m_threadBounds[chunk * 4];
+        minX = first ? bounds[0] : std::min(minX, bounds[0]);
+        minY = first ? bounds[1] : std::min(minY, bounds[1]);
+        maxX = first ? bounds[2] : std::max(maxX, bounds[2]);
+        maxY = first ? bounds[3] : std::max(maxY, bounds[3]);
+        first = false;
+    }
+
+    m_cellSize = std::max(cellSize, 1e-6f);
+    m_originX = minX;
+    m_originY = minY;
+
+    // Grow cells until the grid stays proportional to the particle count
+    size_t maxCells = std::max(MIN_CELLS, cellBudget * MAX_CELLS_PER_PARTICLE);
+    while (true) {
+        double cellsX = std::floor((maxX - minX) / m_cellSize) + 1.0;
+        double cellsY = std::floor((maxY - minY) / m_cellSize) + 1.0;
+        if (cellsX * cellsY <= static_cast<double>(maxCells)) {
+            m_cellsX = static_cast<int>(cellsX);
+            m_cellsY = static_cast<int>(cellsY);
+            break;
+        }
+        m_cellSize *= 2.0f;
+    }
+}
@@ -0,0 +1,80 @@
+#ifndef UNIFORM_GRID_H
+#define UNIFORM_GRID_H
+
+#include "../utils/ThreadPool.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Cell list for broad-phase collision detection.
+// Particles are counting-sorted by cell (row-major), so every cell - and every
+// run of consecutive cells in a row - is one contiguous slice of getSortedIndices().
+//
+// build() is a parallel counting sort: cell keys and per-chunk histograms are
+// computed per chunk, an exclusive prefix sum over (cell, thread) gives every
+// thread its own write cursors, and each thread scatters its chunk into one flat
+// index array. The result is identical to a serial stable sort, and rebuilds
+// reuse all buffers, so steady-state steps are O(n) with no allocation.
+class UniformGrid {
+public:
+    explicit UniformGrid(ThreadPool* threadPool = nullptr); // nullptr = ThreadPool::shared()
+
+    // Rebuild from SoA positions. cellSize should be at least the largest particle diameter.
+    // The cell count is capped in proportion to cellBudget particles (0 = count); pass a
+    // larger budget when other particles will look up the grid without being binned.
+    void build(const float* x, const float* y, size_t count, float cellSize, size_t cellBudget = 0);
+
+    // Grid layout
+    int getCellsX() const { return m_cellsX; }
+    int getCellsY() const { return m_cellsY; }
+    size_t getCellCount() const { return static_cast<size_t>(m_cellsX) * m_cellsY; }
+    float getCellSize() const { return m_cellSize; }
+    float getOriginX() const { return m_originX; }
+    float getOriginY() const { return m_originY; }
+    int cellIndex(int cellX, int cellY) const { return cellY * m_cellsX + cellX; }
+
+    // Cell contents: sorted slots [cellStart(c), cellEnd(c)) hold particle indices of cell c
+    uint32_t cellStart(int cell) const { return m_cellOffsets[cell]; }
+    uint32_t cellEnd(int cell) const { return m_cellOffsets[cell + 1]; }
+    const std::vector<uint32_t>& getSortedIndices() const { return m_sortedIndices; }
+    const std::vector<uint32_t>& getCellOffsets() const { return m_cellOffsets; }
+    const std::vector<uint32_t>& getCellKeys() const { return m_cellKeys; } // by particle index
+
+private:
+    ThreadPool* m_threadPool;
+    
+    int m_cellsX;
+    int m_cellsY;
+    float m_cellSize;
+    float m_originX;
+    float m_originY;
+
+    // Buffers are reused between builds, so steady-state rebuilds do not allocate
+    std::vector<uint32_t> m_cellKeys;      // cell of each particle
+    std::vector<uint32_t> m_cellOffsets;   // exclusive prefix sum of cell counts (size cells + 1)
+    std::vector<uint32_t> m_sortedIndices; // particle indices ordered by cell
+    std::vector<uint32_t> m_threadCounts;  // per-thread histograms, then write cursors [thread][cell]
+    std::vector<uint32_t> m_blockTotals;   // per-thread cell-block sums for the parallel scan
+    std::vector<float> m_threadBounds;     // per-thread min/max x/y
+    size_t m_chunkCount;
+
+    // Guard against degenerate bounds producing enormous grids
+    static const size_t MAX_CELLS_PER_PARTICLE = 4;
+    static const size_t MIN_CELLS = 1024;
+    
+    // The counting sort costs ~25 ns per particle, so 4096 gives ~100 us chunks.
+    // Also the minimum cell block of the parallel prefix sum.
+    static const size_t MIN_PARTICLES_PER_THREAD = 4096;
+
+    // Each sort chunk owns a histogram over every cell, so a build clears, scans and
+    // reads chunks * cells words on top of the particle passes. With up to 4 cells per
+    // particle that is 4 * chunks words per particle (256 MB for 1M particles on 16
+    // threads), so chunks are capped both outright and to 8 histogram words per particle.
+    static const size_t MAX_SORT_CHUNKS = 16;
+    static const size_t MAX_HISTOGRAM_WORDS_PER_PARTICLE = 8;
+
+    void computeLayout(const float* x, const float* y, size_t count, float cellSize, size_t cellBudget);
+    void computeCellOffsets(size_t cellCount);
+};
+
+#endif // UNIFORM_GRID_H
@@ -1,23 +1,30 @@
-
 #include "Particle.h"
 
 // Constructor implementation
-Particle::Particle(glm::vec2 pos, float m) {
+template <typename Precision>
+BasicParticle<Precision>::BasicParticle(Position pos, ScalarType m) {
     position = pos;
     mass = m;
-    velocity = glm::vec2(0.0f, 0.0f);
-    acceleration = glm::vec2(0.0f, 0.0f);
+    velocity = Vector(0.0f, 0.0f);
+    acceleration = Vector(0.0f, 0.0f);
     radius = 5.0f; // Default radius
 }
 
-void Particle::applyForce(const glm::vec2& force) {
+template <typename Precision>
+void BasicParticle<Precision>::applyForce(const Vector& force) {
     // Newton's second law: F = ma  =>  a = F/m
     acceleration += force / mass;
 }
 
-void Particle::update(float deltaTime) {
+template <typename Precision>
+void BasicParticle<Precision>::update(ScalarType deltaTime) {
     velocity += acceleration * deltaTime;
-    position += velocity * deltaTime;
+    // Position step is taken in position precision (matters for the mixed mode)
+    position += Position(velocity) * static_cast<PositionType>(deltaTime);
     // Reset acceleration after applying it
-    acceleration = glm::vec2(0.0f, 0.0f);
-}
\ No newline at end of file
+    acceleration = Vector(0.0f, 0.0f);
+}
+
+template class BasicParticle<FloatPrecision>;
+template class BasicParticle<DoublePrecision>;
+template class BasicParticle<MixedPrecision>;
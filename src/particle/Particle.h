@@ -1,24 +1,33 @@
-
 #ifndef PARTICLE_H
 #define PARTICLE_H
 
+#include "Precision.h"
 #include <glm/glm.hpp> // For vec2
 
-class Particle {
+template <typename Precision>
+class BasicParticle {
 public:
+    using PositionType = typename Precision::Position;
+    using ScalarType = typename Precision::Scalar;
+    using Position = glm::vec<2, PositionType>;
+    using Vector = glm::vec<2, ScalarType>;
     
-    Particle(glm::vec2 pos, float mass);     // Constructs a Particle at the given position with the specified mass.
+    BasicParticle(Position pos, ScalarType mass);     // Constructs a Particle at the given position with the specified mass.
 
     // Member Functions
-    void applyForce(const glm::vec2& force); //A function to change the particle's acceleration based on a force (like gravity).
-    void update(float deltaTime); // A function to update the particle's position based on its velocity over a small time step.
+    void applyForce(const Vector& force); //A function to change the particle's acceleration based on a force (like gravity).
+    void update(ScalarType deltaTime); // A function to update the particle's position based on its velocity over a small time step.
 
     // Member Variables
-    glm::vec2 position;
-    glm::vec2 velocity;
-    glm::vec2 acceleration;
-    float mass;
-    float radius;
+    Position position;
+    Vector velocity;
+    Vector acceleration;
+    ScalarType mass;
+    ScalarType radius;
 };
 
-#endif // PARTICLE_H
\ No newline at end of file
+using Particle = BasicParticle<FloatPrecision>;
+using DoubleParticle = BasicParticle<DoublePrecision>;
+using MixedParticle = BasicParticle<MixedPrecision>;
+
+#endif // PARTICLE_H
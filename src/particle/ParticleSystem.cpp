@@ -1,20 +1,64 @@
-
 #include "ParticleSystem.h"
+#include <iostream>
 
-void ParticleSystem::addParticle(const Particle& particle) {
+template <typename Precision>
+void BasicParticleSystem<Precision>::addParticle(const ParticleType& particle) {
     particles.push_back(particle);
+    if (hasCollisionFilters()) {
+        syncCollisionFilters();
+    }
 }
 
-void ParticleSystem::update(float deltaTime) {
+template <typename Precision>
+void BasicParticleSystem<Precision>::addParticle(const ParticleType& particle, uint32_t collisionGroup, uint32_t collisionMask) {
+    particles.push_back(particle);
+    if (hasCollisionFilters() || collisionGroup != DEFAULT_COLLISION_GROUP || collisionMask != DEFAULT_COLLISION_MASK) {
+        syncCollisionFilters();
+        collisionGroups.back() = collisionGroup;
+        collisionMasks.back() = collisionMask;
+    }
+}
+
+template <typename Precision>
+void BasicParticleSystem<Precision>::setCollisionFilter(size_t index, uint32_t collisionGroup, uint32_t collisionMask) {
+    syncCollisionFilters();
+    collisionGroups[index] = collisionGroup;
+    collisionMasks[index] = collisionMask;
+}
+
+template <typename Precision>
+bool BasicParticleSystem<Precision>::syncCollisionFilters() {
+    bool aligned = collisionGroups.size() <= particles.size();
+    if (!aligned) {
+        // Particles were removed behind the columns' back; which filter belongs
+        // to which particle is lost
+        std::cerr << "[PARTICLES] " << collisionGroups.size() << " collision filters for " << particles.size()
+                  << " particles (remove particles with removeParticlesIf); filters reset" << std::endl;
+        collisionGroups.clear();
+        collisionMasks.clear();
+    }
+    collisionGroups.resize(particles.size(), uint32_t(DEFAULT_COLLISION_GROUP));
+    collisionMasks.resize(particles.size(), uint32_t(DEFAULT_COLLISION_MASK));
+    return aligned;
+}
+
+template <typename Precision>
+void BasicParticleSystem<Precision>::update(typename Precision::Scalar deltaTime) {
     for (auto& particle : particles) {
         particle.update(deltaTime);
     }
 }
 
-const std::vector<Particle>& ParticleSystem::getParticles() const {
+template <typename Precision>
+const std::vector<typename BasicParticleSystem<Precision>::ParticleType>& BasicParticleSystem<Precision>::getParticles() const {
     return particles;
 }
 
-std::vector<Particle>& ParticleSystem::getParticles() {
+template <typename Precision>
+std::vector<typename BasicParticleSystem<Precision>::ParticleType>& BasicParticleSystem<Precision>::getParticles() {
     return particles;
-}
\ No newline at end of file
+}
+
+template class BasicParticleSystem<FloatPrecision>;
+template class BasicParticleSystem<DoublePrecision>;
+template class BasicParticleSystem<MixedPrecision>;
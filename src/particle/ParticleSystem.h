@@ -1,19 +1,79 @@
-
 #ifndef PARTICLE_SYSTEM_H
 #define PARTICLE_SYSTEM_H
 
 #include "Particle.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
 #include <vector>
 
-class ParticleSystem {
+template <typename Precision>
+class BasicParticleSystem {
 public:
-    void addParticle(const Particle& particle);
-    void update(float deltaTime);
-    const std::vector<Particle>& getParticles() const;
-    std::vector<Particle>& getParticles(); // Non-const version for physics updates
+    using ParticleType = BasicParticle<Precision>;
+    
+    // Collision filtering: particles a and b collide only when
+    // (group_a & mask_b) != 0 and (group_b & mask_a) != 0. A zero group or
+    // mask takes a particle out of collision detection altogether.
+    static const uint32_t DEFAULT_COLLISION_GROUP = 1u;
+    static const uint32_t DEFAULT_COLLISION_MASK = 0xFFFFFFFFu;
+    
+    void addParticle(const ParticleType& particle);
+    void addParticle(const ParticleType& particle, uint32_t collisionGroup, uint32_t collisionMask);
+    void update(typename Precision::Scalar deltaTime);
+    const std::vector<ParticleType>& getParticles() const;
+    std::vector<ParticleType>& getParticles(); // Non-const version for physics updates
+    // Removes every particle matching the predicate, keeping the filter
+    // columns aligned; returns the number removed
+    template <typename Predicate>
+    size_t removeParticlesIf(Predicate predicate);
+    
+    // Filter columns, parallel to getParticles(). They stay empty (all
+    // defaults, no filtering cost) until a filter is first set. Particles
+    // appended through getParticles() get the defaults from
+    // syncCollisionFilters(); particles must be removed with
+    // removeParticlesIf(). If the columns outgrow the particles, sync reports
+    // the error, resets every filter to the defaults and returns false.
+    void setCollisionFilter(size_t index, uint32_t collisionGroup, uint32_t collisionMask);
+    bool hasCollisionFilters() const { return !collisionGroups.empty(); }
+    bool syncCollisionFilters();
+    const std::vector<uint32_t>& getCollisionGroups() const { return collisionGroups; }
+    const std::vector<uint32_t>& getCollisionMasks() const { return collisionMasks; }
 
 private:
-    std::vector<Particle> particles;
+    std::vector<ParticleType> particles;
+    std::vector<uint32_t> collisionGroups;
+    std::vector<uint32_t> collisionMasks;
 };
 
-#endif // PARTICLE_SYSTEM_H
\ No newline at end of file
+template <typename Precision>
+template <typename Predicate>
+size_t BasicParticleSystem<Precision>::removeParticlesIf(Predicate predicate) {
+    const bool filtered = hasCollisionFilters();
+    if (filtered) syncCollisionFilters();
+    size_t kept = 0;
+    for (size_t i = 0; i < particles.size(); ++i) {
+        if (predicate(static_cast<const ParticleType&>(particles[i]))) continue;
+        if (kept != i) {
+            particles[kept] = particles[i];
+            if (filtered) {
+                collisionGroups[kept] = collisionGroups[i];
+                collisionMasks[kept] = collisionMasks[i];
+            }
+        }
+        kept++;
+    }
+    size_t removed = particles.size() - kept;
+    particles.erase(particles.begin() + kept, particles.end());
+    if (filtered) {
+        collisionGroups.resize(kept);
+        collisionMasks.resize(kept);
+    }
+    return removed;
+}
+
+using ParticleSystem = BasicParticleSystem<FloatPrecision>;
+using DoubleParticleSystem = BasicParticleSystem<DoublePrecision>;
+using MixedParticleSystem = BasicParticleSystem<MixedPrecision>;
+
+#endif // PARTICLE_SYSTEM_H
@@ -0,0 +1,31 @@
+#ifndef PRECISION_H
+#define PRECISION_H
+
+// Scalar precision policies for BasicParticle / BasicParticleSystem / BasicPhysicsEngine.
+// Position is the type particle positions are stored and integrated in;
+// Scalar is used for velocity, acceleration, mass, radius and force math.
+
+// Default: single precision everywhere (best SIMD throughput)
+struct FloatPrecision {
+    using Position = float;
+    using Scalar = float;
+    static const char* name() { return "float"; }
+};
+
+// Double everywhere, for long-running energy-sensitive runs
+struct DoublePrecision {
+    using Position = double;
+    using Scalar = double;
+    static const char* name() { return "double"; }
+};
+
+// Double positions (no drift from accumulating small steps) with float
+// velocities and forces. Collision math runs in float on positions taken
+// relative to their grid cell origin, so it stays accurate far from (0, 0).
+struct MixedPrecision {
+    using Position = double;
+    using Scalar = float;
+    static const char* name() { return "mixed"; }
+};
+
+#endif // PRECISION_H
@@ -0,0 +1,269 @@
+#include "BatchedWorldEngine.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+namespace {
+
+// One particle pair (i, j) in `count` consecutive worlds. Rows i and j never
+// overlap, so every pointer is restrict and the loop vectorizes across worlds.
+// Same response as PhysicsEngine::resolveCollision, with branches as selects.
+size_t resolvePairRows(float* __restrict xi, float* __restrict yi, float* __restrict vxi, float* __restrict vyi,
+                       const float* __restrict ri, const float* __restrict invMi,
+                       float* __restrict xj, float* __restrict yj, float* __restrict vxj, float* __restrict vyj,
+                       const float* __restrict rj, const float* __restrict invMj,
+                       size_t count, float damping) {
+    // Contacts are rare (about one per world per step), so first test the whole
+    // row cheaply and skip the sqrt/divide pass when no world has this pair touching.
+    // The squared test is padded slightly so it never rejects a true contact.
+    int candidates = 0;
+    for (size_t w = 0; w < count; ++w) {
+        const float dx = xj[w] - xi[w];
+        const float dy = yj[w] - yi[w];
+        const float radiusSum = ri[w] + rj[w];
+        candidates |= dx * dx + dy * dy <= radiusSum * radiusSum * 1.0001f;
+    }
+    if (!candidates) return 0;
+
+    size_t contacts = 0;
+    for (size_t w = 0; w < count; ++w) {
+        const float dx = xj[w] - xi[w];
+        const float dy = yj[w] - yi[w];
+        const float distance = std::sqrt(dx * dx + dy * dy);
+        const float radiusSum = ri[w] + rj[w];
+        const bool contact = distance < radiusSum;
+        const bool resolve = contact && distance > 0.0f; // coincident centres are counted but skipped
+
+        // Divide unconditionally (by 1 when inactive) so the loop has no branches
+        const float invDistance = 1.0f / (resolve ? distance : 1.0f);
+        const float nx = resolve ? dx * invDistance : 0.0f;
+        const float ny = resolve ? dy * invDistance : 0.0f;
+
+        // Separate overlapping particles
+        const float separation = resolve ? (radiusSum - distance) * 0.5f : 0.0f;
+        xi[w] -= nx * separation;
+        yi[w] -= ny * separation;
+        xj[w] += nx * separation;
+        yj[w] += ny * separation;
+
+        // Impulse only while approaching
+        const float velAlongNormal = (vxj[w] - vxi[w]) * nx + (vyj[w] - vyi[w]) * ny;
+        const float impulse = velAlongNormal < 0.0f ? -(1.0f + damping) * velAlongNormal / (invMi[w] + invMj[w]) : 0.0f;
+        vxi[w] -= impulse * nx * invMi[w];
+        vyi[w] -= impulse * ny * invMi[w];
+        vxj[w] += impulse * nx * invMj[w];
+        vyj[w] += impulse * ny * invMj[w];
+
+        contacts += contact ? 1 : 0;
+    }
+    return contacts;
+}
+
+} // namespace
+
+BatchedWorldEngine::BatchedWorldEngine(size_t worldCount, size_t particlesPerWorld, ThreadPool* threadPool)
+    : m_threadPool(threadPool ? threadPool : &ThreadPool::shared())
+    , m_worldCount(worldCount)
+    , m_particleCount(particlesPerWorld)
+    , m_timeStep(1.0f / 60.0f)
+    , m_gravity(0.0f, -9.81f)
+    , m_airResistance(0.01f)
+    , m_collisionDamping(0.8f)
+    , m_minBounds(-10.0f, -10.0f)
+    , m_maxBounds(10.0f, 10.0f)
+    , m_maxSpeed(2.0f)
+    , m_minMass(0.5f)
+    , m_maxMass(2.0f)
+    , m_minRadius(0.2f)
+    , m_maxRadius(0.5f)
+    , m_lastContactCount(0) {
+    const size_t size = worldCount * particlesPerWorld;
+    m_posX.assign(size, 0.0f);
+    m_posY.assign(size, 0.0f);
+    m_velX.assign(size, 0.0f);
+    m_velY.assign(size, 0.0f);
+    m_radius.assign(size, 1.0f);
+    m_mass.assign(size, 1.0f);
+    m_invMass.assign(size, 1.0f);
+    m_accX.assign(size, 0.0f);
+    m_accY.assign(size, 0.0f);
+}
+
+void BatchedWorldEngine::setBounds(const glm::vec2& minBounds, const glm::vec2& maxBounds) {
+    m_minBounds = minBounds;
+    m_maxBounds = maxBounds;
+}
+
+void BatchedWorldEngine::setSpawnRanges(float maxSpeed, float minMass, float maxMass, float minRadius, float maxRadius) {
+    m_maxSpeed = maxSpeed;
+    m_minMass = minMass;
+    m_maxMass = maxMass;
+    m_minRadius = minRadius;
+    m_maxRadius = maxRadius;
+}
+
+void BatchedWorldEngine::setParticle(size_t world, size_t particle, const glm::vec2& position, const glm::vec2& velocity, float mass, float radius) {
+    size_t index = particle * m_worldCount + world;
+    m_posX[index] = position.x;
+    m_posY[index] = position.y;
+    m_velX[index] = velocity.x;
+    m_velY[index] = velocity.y;
+    m_mass[index] = mass;
+    m_invMass[index] = 1.0f / mass;
+    m_radius[index] = radius;
+}
+
+void BatchedWorldEngine::reset(uint64_t seed) {
+    m_threadPool->parallelFor(0, m_worldCount, [&](size_t begin, size_t end, size_t) {
+        for (size_t world = begin; world < end; ++world) {
+            resetWorld(world, seed);
+        }
+    }, MIN_WORLDS_PER_THREAD);
+}
+
+void BatchedWorldEngine::resetWorlds(const uint32_t* worldIndices, size_t count, uint64_t seed) {
+    // Typically a handful of finished episodes per step; not worth a fork/join
+    for (size_t i = 0; i < count; ++i) {
+        resetWorld(worldIndices[i], seed);
+    }
+}
+
+void BatchedWorldEngine::resetWorld(size_t world, uint64_t seed) {
+    // Independent stream per world, so resetting one world never shifts another
+    std::mt19937_64 generator(seed ^ (0x9E3779B97F4A7C15ULL * (world + 1)));
+    std::uniform_real_distribution<float> speed(-m_maxSpeed, m_maxSpeed);
+    std::uniform_real_distribution<float> mass(m_minMass, m_maxMass);
+    std::uniform_real_distribution<float> radius(m_minRadius, m_maxRadius);
+
+    for (size_t p = 0; p < m_particleCount; ++p) {
+        float r = radius(generator);
+        std::uniform_real_distribution<float> x(m_minBounds.x + r, m_maxBounds.x - r);
+        std::uniform_real_distribution<float> y(m_minBounds.y + r, m_maxBounds.y - r);
+        glm::vec2 position(x(generator), y(generator));
+        glm::vec2 velocity(speed(generator), speed(generator));
+        setParticle(world, p, position, velocity, mass(generator), r);
+    }
+}
+
+void BatchedWorldEngine::step(const float* forceX, const float* forceY) {
+    const size_t blockCount = (m_worldCount + WORLD_BLOCK - 1) / WORLD_BLOCK;
+    m_threadContacts.assign(m_threadPool->getThreadCount(), 0);
+
+    m_threadPool->parallelFor(0, blockCount, [&](size_t blockBegin, size_t blockEnd, size_t threadIndex) {
+        size_t begin = blockBegin * WORLD_BLOCK;
+        size_t end = std::min(blockEnd * WORLD_BLOCK, m_worldCount);
+        // Step one tile at a time so its rows stay in cache through all pairs
+        for (size_t tile = begin; tile < end; tile += WORLD_TILE) {
+            m_threadContacts[threadIndex] += stepWorlds(tile, std::min(tile + WORLD_TILE, end), forceX, forceY);
+        }
+    }, MIN_WORLDS_PER_THREAD / WORLD_BLOCK);
+
+    m_lastContactCount = 0;
+    for (size_t contacts : m_threadContacts) {
+        m_lastContactCount += contacts;
+    }
+}
+
+size_t BatchedWorldEngine::stepWorlds(size_t begin, size_t end, const float* forceX, const float* forceY) {
+    const size_t worlds = m_worldCount;
+    const size_t count = end - begin;
+    const float damping = m_collisionDamping;
+    const float minX = m_minBounds.x, minY = m_minBounds.y;
+    const float maxX = m_maxBounds.x, maxY = m_maxBounds.y;
+    const float gravityX = m_gravity.x, gravityY = m_gravity.y;
+    const float air = m_airResistance;
+    const float dt = m_timeStep;
+
+    // Boundaries, then forces (same order as the app loop around PhysicsEngine)
+    for (size_t p = 0; p < m_particleCount; ++p) {
+        const size_t row = p * worlds + begin;
+        float* __restrict x = &m_posX[row];
+        float* __restrict y = &m_posY[row];
+        float* __restrict vx = &m_velX[row];
+        float* __restrict vy = &m_velY[row];
+        float* __restrict ax = &m_accX[row];
+        float* __restrict ay = &m_accY[row];
+        const float* __restrict r = &m_radius[row];
+        const float* __restrict invMass = &m_invMass[row];
+        const float* fx = forceX ? forceX + row : nullptr;
+        const float* fy = forceY ? forceY + row : nullptr;
+
+        for (size_t w = 0; w < count; ++w) {
+            // Same sequence of checks as applyBoundaryConstraints, as selects
+            const bool left = x[w] - r[w] < minX;
+            float px = left ? minX + r[w] : x[w];
+            float pvx = left ? -vx[w] * damping : vx[w];
+            const bool right = px + r[w] > maxX;
+            x[w] = right ? maxX - r[w] : px;
+            vx[w] = right ? -pvx * damping : pvx;
+
+            const bool bottom = y[w] - r[w] < minY;
+            float py = bottom ? minY + r[w] : y[w];
+            float pvy = bottom ? -vy[w] * damping : vy[w];
+            const bool top = py + r[w] > maxY;
+            y[w] = top ? maxY - r[w] : py;
+            vy[w] = top ? -pvy * damping : pvy;
+
+            // Gravity and quadratic drag (F = -k |v| v), as accelerations
+            const float speed = std::sqrt(vx[w] * vx[w] + vy[w] * vy[w]);
+            ax[w] = gravityX - air * speed * vx[w] * invMass[w];
+            ay[w] = gravityY - air * speed * vy[w] * invMass[w];
+        }
+        if (fx && fy) {
+            for (size_t w = 0; w < count; ++w) {
+                ax[w] += fx[w] * invMass[w];
+                ay[w] += fy[w] * invMass[w];
+            }
+        }
+    }
+
+    // All pairs, in the brute-force engine's order, each pair across all worlds at once
+    size_t contacts = 0;
+    for (size_t i = 0; i < m_particleCount; ++i) {
+        const size_t rowI = i * worlds + begin;
+        for (size_t j = i + 1; j < m_particleCount; ++j) {
+            const size_t rowJ = j * worlds + begin;
+            contacts += resolvePairRows(&m_posX[rowI], &m_posY[rowI], &m_velX[rowI], &m_velY[rowI], &m_radius[rowI], &m_invMass[rowI],
+                                        &m_posX[rowJ], &m_posY[rowJ], &m_velX[rowJ], &m_velY[rowJ], &m_radius[rowJ], &m_invMass[rowJ],
+                                        count, damping);
+        }
+    }
+
+    // Explicit Euler, as Particle::update
+    for (size_t p = 0; p < m_particleCount; ++p) {
+        const size_t row = p * worlds + begin;
+        float* __restrict x = &m_posX[row];
+        float* __restrict y = &m_posY[row];
+        float* __restrict vx = &m_velX[row];
+        float* __restrict vy = &m_velY[row];
+        const float* __restrict ax = &m_accX[row];
+        const float* __restrict ay = &m_accY[row];
+        for (size_t w = 0; w < count; ++w) {
+            vx[w] += ax[w] * dt;
+            vy[w] += ay[w] * dt;
+            x[w] += vx[w] * dt;
+            y[w] += vy[w] * dt;
+        }
+    }
+
+    return contacts;
+}
+
+void BatchedWorldEngine::observe(float* out) const {
+    const size_t worlds = m_worldCount;
+    const size_t particles = m_particleCount;
+
+    // Transpose [particle][world] into [world][particle][4], one world block per task
+    m_threadPool->parallelFor(0, worlds, [&](size_t begin, size_t end, size_t) {
+        for (size_t w = begin; w < end; ++w) {
+            float* world = out + w * particles * 4;
+            for (size_t p = 0; p < particles; ++p) {
+                size_t index = p * worlds + w;
+                world[p * 4 + 0] = m_posX[index];
+                world[p * 4 + 1] = m_posY[index];
+                world[p * 4 + 2] = m_velX[index];
+                world[p * 4 + 3] = m_velY[index];
+            }
+        }
+    }, MIN_WORLDS_PER_THREAD);
+}
@@ -0,0 +1,91 @@
+#ifndef BATCHED_WORLD_ENGINE_H
+#define BATCHED_WORLD_ENGINE_H
+
+#include "../utils/ThreadPool.h"
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Steps many small, independent worlds in lockstep (RL-style environments).
+// Every world has the same particle count, and every per-particle array is laid
+// out [particle][world] with the world index innermost, so each physics kernel
+// is a loop over worlds: unit-stride and branch-free, it vectorizes across
+// worlds, and threads take contiguous world ranges. The model matches
+// PhysicsEngine with the brute-force broad phase (gravity, air resistance,
+// pairwise impulses in the same pair order, explicit Euler, box boundaries).
+class BatchedWorldEngine {
+public:
+    BatchedWorldEngine(size_t worldCount, size_t particlesPerWorld, ThreadPool* threadPool = nullptr);
+
+    // Configuration (shared by all worlds)
+    void setTimeStep(float deltaTime) { m_timeStep = deltaTime; }
+    void setGravity(const glm::vec2& gravity) { m_gravity = gravity; }
+    void setAirResistance(float resistance) { m_airResistance = resistance; }
+    void setCollisionDamping(float damping) { m_collisionDamping = damping; }
+    void setBounds(const glm::vec2& minBounds, const glm::vec2& maxBounds);
+    void setSpawnRanges(float maxSpeed, float minMass, float maxMass, float minRadius, float maxRadius);
+
+    // Episode control: random initial state per world, reproducible from (seed, world)
+    void reset(uint64_t seed);
+    void resetWorlds(const uint32_t* worldIndices, size_t count, uint64_t seed);
+
+    // Advance every world by one step. forceX / forceY are optional external
+    // forces laid out like the state arrays ([particle][world]); nullptr = none.
+    void step(const float* forceX = nullptr, const float* forceY = nullptr);
+
+    // Observation tensor [world][particle][x, y, vx, vy], as RL trainers expect.
+    // `out` must hold getObservationSize() floats.
+    void observe(float* out) const;
+    size_t getObservationSize() const { return m_worldCount * m_particleCount * 4; }
+
+    // Direct access to the batched state ([particle][world], index = particle * worlds + world)
+    size_t getWorldCount() const { return m_worldCount; }
+    size_t getParticlesPerWorld() const { return m_particleCount; }
+    float* getPositionsX() { return m_posX.data(); }
+    float* getPositionsY() { return m_posY.data(); }
+    float* getVelocitiesX() { return m_velX.data(); }
+    float* getVelocitiesY() { return m_velY.data(); }
+    const float* getRadii() const { return m_radius.data(); }
+    const float* getMasses() const { return m_mass.data(); }
+    void setParticle(size_t world, size_t particle, const glm::vec2& position, const glm::vec2& velocity, float mass, float radius);
+
+    size_t getLastContactCount() const { return m_lastContactCount; }
+
+private:
+    ThreadPool* m_threadPool;
+    size_t m_worldCount;
+    size_t m_particleCount;
+
+    // Parameters
+    float m_timeStep;
+    glm::vec2 m_gravity;
+    float m_airResistance;
+    float m_collisionDamping;
+    glm::vec2 m_minBounds, m_maxBounds;
+    float m_maxSpeed, m_minMass, m_maxMass, m_minRadius, m_maxRadius;
+
+    // State, [particle][world]
+    std::vector<float> m_posX, m_posY;
+    std::vector<float> m_velX, m_velY;
+    std::vector<float> m_radius, m_mass, m_invMass;
+    std::vector<float> m_accX, m_accY; // forces of the current step, applied after collisions
+    std::vector<size_t> m_threadContacts;
+    size_t m_lastContactCount;
+
+    // Threads take world ranges in multiples of this, which keeps vector loops
+    // full. Block boundaries fall on cache-line boundaries only when worldCount
+    // is a multiple of 16 and the arrays are 64-byte aligned (std::vector does
+    // not promise that); otherwise two threads can share one line per particle
+    // row at their common boundary, a small cost next to 64+ worlds per thread.
+    static const size_t WORLD_BLOCK = 16;
+    // Worlds stepped together: wide enough for full vectors, small enough that
+    // every particle row of the tile stays in L1/L2 across the O(n^2) pair loop
+    static const size_t WORLD_TILE = 64;
+    static const size_t MIN_WORLDS_PER_THREAD = 64;
+
+    void resetWorld(size_t world, uint64_t seed);
+    size_t stepWorlds(size_t begin, size_t end, const float* forceX, const float* forceY);
+};
+
+#endif // BATCHED_WORLD_ENGINE_H
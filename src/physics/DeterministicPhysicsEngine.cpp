@@ -0,0 +1,273 @@
+#include "DeterministicPhysicsEngine.h"
+#include <algorithm>
+
+DeterministicPhysicsEngine::DeterministicPhysicsEngine()
+    : m_timeStep(FixedPoint::fromFloat(1.0f / 60.0f))
+    , m_gravityX(0)
+    , m_gravityY(FixedPoint::fromFloat(-9.81f))
+    , m_collisionDamping(FixedPoint::fromFloat(0.8f))
+    , m_minX(0), m_minY(0), m_maxX(0), m_maxY(0)
+    , m_hasBounds(false)
+    , m_lastContactCount(0) {
+}
+
+template <typename Precision>
+void DeterministicPhysicsEngine::loadFrom(const BasicParticleSystem<Precision>& system) {
+    const auto& particles = system.getParticles();
+    m_posX.clear(); m_posY.clear();
+    m_velX.clear(); m_velY.clear();
+    m_radius.clear(); m_invMass.clear(); m_mass.clear();
+
+    for (const auto& particle : particles) {
+        addParticle(FixedPoint::fromFloat(particle.position.x), FixedPoint::fromFloat(particle.position.y),
+                    FixedPoint::fromFloat(particle.velocity.x), FixedPoint::fromFloat(particle.velocity.y),
+                    FixedPoint::fromFloat(particle.mass), FixedPoint::fromFloat(particle.radius));
+    }
+}
+
+template <typename Precision>
+void DeterministicPhysicsEngine::storeTo(BasicParticleSystem<Precision>& system) const {
+    using Position = typename BasicParticle<Precision>::Position;
+    using Vector = typename BasicParticle<Precision>::Vector;
+    auto& particles = system.getParticles();
+    size_t count = std::min(particles.size(), m_posX.size());
+    for (size_t i = 0; i < count; ++i) {
+        particles[i].position = Position(FixedPoint::toDouble(m_posX[i]), FixedPoint::toDouble(m_posY[i]));
+        particles[i].velocity = Vector(FixedPoint::toDouble(m_velX[i]), FixedPoint::toDouble(m_velY[i]));
+        particles[i].acceleration = Vector(0.0f, 0.0f);
+    }
+}
+
+template void DeterministicPhysicsEngine::loadFrom(const BasicParticleSystem<FloatPrecision>&);
+template void DeterministicPhysicsEngine::loadFrom(const BasicParticleSystem<DoublePrecision>&);
+template void DeterministicPhysicsEngine::loadFrom(const BasicParticleSystem<MixedPrecision>&);
+template void DeterministicPhysicsEngine::storeTo(BasicParticleSystem<FloatPrecision>&) const;
+template void DeterministicPhysicsEngine::storeTo(BasicParticleSystem<DoublePrecision>&) const;
+template void DeterministicPhysicsEngine::storeTo(BasicParticleSystem<MixedPrecision>&) const;
+
+void DeterministicPhysicsEngine::addParticle(int64_t x, int64_t y, int64_t vx, int64_t vy, int64_t mass, int64_t radius) {
+    m_posX.push_back(x);
+    m_posY.push_back(y);
+    m_velX.push_back(vx);
+    m_velY.push_back(vy);
+    m_mass.push_back(mass);
+    m_invMass.push_back(FixedPoint::div(FixedPoint::ONE, mass));
+    m_radius.push_back(radius);
+}
+
+void DeterministicPhysicsEngine::setGravity(const glm::vec2& gravity) {
+    m_gravityX = FixedPoint::fromFloat(gravity.x);
+    m_gravityY = FixedPoint::fromFloat(gravity.y);
+}
+
+void DeterministicPhysicsEngine::setBounds(const glm::vec2& minBounds, const glm::vec2& maxBounds) {
+    m_minX = FixedPoint::fromFloat(minBounds.x);
+    m_minY = FixedPoint::fromFloat(minBounds.y);
+    m_maxX = FixedPoint::fromFloat(maxBounds.x);
+    m_maxY = FixedPoint::fromFloat(maxBounds.y);
+    m_hasBounds = true;
+}
+
+void DeterministicPhysicsEngine::step() {
+    // Same order as the float app loop: boundaries, collisions, then integration
+    if (m_hasBounds) {
+        applyBoundaryConstraints();
+    }
+    handleCollisions();
+    integrate();
+}
+
+void DeterministicPhysicsEngine::integrate() {
+    // Gravity is the only body force, so a = g for every particle (F = m g)
+    const size_t count = m_posX.size();
+    const int64_t dvx = FixedPoint::mul(m_gravityX, m_timeStep);
+    const int64_t dvy = FixedPoint::mul(m_gravityY, m_timeStep);
+    const int64_t dt = m_timeStep;
+    int64_t* __restrict posX = m_posX.data();
+    int64_t* __restrict posY = m_posY.data();
+    int64_t* __restrict velX = m_velX.data();
+    int64_t* __restrict velY = m_velY.data();
+
+    // Semi-implicit Euler, branch-free SoA loop (vectorizes)
+    for (size_t i = 0; i < count; ++i) {
+        int64_t vx = velX[i] + dvx;
+        int64_t vy = velY[i] + dvy;
+        velX[i] = vx;
+        velY[i] = vy;
+        posX[i] += FixedPoint::mul(vx, dt);
+        posY[i] += FixedPoint::mul(vy, dt);
+    }
+}
+
+void DeterministicPhysicsEngine::applyBoundaryConstraints() {
+    const size_t count = m_posX.size();
+    const int64_t damping = m_collisionDamping;
+    int64_t* __restrict posX = m_posX.data();
+    int64_t* __restrict posY = m_posY.data();
+    int64_t* __restrict velX = m_velX.data();
+    int64_t* __restrict velY = m_velY.data();
+    const int64_t* __restrict radius = m_radius.data();
+    const int64_t minX = m_minX, maxX = m_maxX, minY = m_minY, maxY = m_maxY;
+
+    // Selects instead of branches keep the loop vectorizable
+    for (size_t i = 0; i < count; ++i) {
+        int64_t r = radius[i];
+        int64_t x = posX[i], y = posY[i];
+        int64_t vx = velX[i], vy = velY[i];
+
+        int64_t bouncedVx = -FixedPoint::mul(vx, damping);
+        bool hitMinX = x - r < minX;
+        x = hitMinX ? minX + r : x;
+        vx = hitMinX ? bouncedVx : vx;
+        bouncedVx = -FixedPoint::mul(vx, damping);
+        bool hitMaxX = x + r > maxX;
+        x = hitMaxX ? maxX - r : x;
+        vx = hitMaxX ? bouncedVx : vx;
+
+        int64_t bouncedVy = -FixedPoint::mul(vy, damping);
+        bool hitMinY = y - r < minY;
+        y = hitMinY ? minY + r : y;
+        vy = hitMinY ? bouncedVy : vy;
+        bouncedVy = -FixedPoint::mul(vy, damping);
+        bool hitMaxY = y + r > maxY;
+        y = hitMaxY ? maxY - r : y;
+        vy = hitMaxY ? bouncedVy : vy;
+
+        posX[i] = x; posY[i] = y;
+        velX[i] = vx; velY[i] = vy;
+    }
+}
+
+void DeterministicPhysicsEngine::handleCollisions() {
+    m_lastContactCount = 0;
+    const size_t count = m_posX.size();
+    if (count < 2) return;
+
+    // Integer cell list: power-of-two cells no smaller than the largest diameter
+    int64_t minX = m_posX[0], maxX = m_posX[0], minY = m_posY[0], maxY = m_posY[0];
+    int64_t maxRadius = 0;
+    for (size_t i = 0; i < count; ++i) {
+        minX = std::min(minX, m_posX[i]);
+        maxX = std::max(maxX, m_posX[i]);
+        minY = std::min(minY, m_posY[i]);
+        maxY = std::max(maxY, m_posY[i]);
+        maxRadius = std::max(maxRadius, m_radius[i]);
+    }
+
+    int shift = 0;
+    while (shift < 62 && (int64_t(1) << shift) < 2 * maxRadius) shift++;
+    while (shift < 62 && (((maxX - minX) >> shift) >= MAX_CELLS_PER_AXIS || ((maxY - minY) >> shift) >= MAX_CELLS_PER_AXIS)) {
+        shift++;
+    }
+    const uint32_t cellsX = static_cast<uint32_t>((maxX - minX) >> shift) + 1;
+    const uint32_t cellsY = static_cast<uint32_t>((maxY - minY) >> shift) + 1;
+    const size_t cellCount = static_cast<size_t>(cellsX) * cellsY;
+
+    // Serial counting sort keeps the pair order - and therefore the result - fixed
+    m_cellKeys.resize(count);
+    m_sortedIndices.resize(count);
+    m_cellOffsets.assign(cellCount + 1, 0);
+    for (size_t i = 0; i < count; ++i) {
+        uint32_t cellX = static_cast<uint32_t>((m_posX[i] - minX) >> shift);
+        uint32_t cellY = static_cast<uint32_t>((m_posY[i] - minY) >> shift);
+        m_cellKeys[i] = cellY * cellsX + cellX;
+        m_cellOffsets[m_cellKeys[i] + 1]++;
+    }
+    for (size_t c = 0; c < cellCount; ++c) {
+        m_cellOffsets[c + 1] += m_cellOffsets[c];
+    }
+    for (size_t i = 0; i < count; ++i) {
+        m_sortedIndices[m_cellOffsets[m_cellKeys[i]]++] = static_cast<uint32_t>(i);
+    }
+    for (size_t c = cellCount; c > 0; --c) {
+        m_cellOffsets[c] = m_cellOffsets[c - 1];
+    }
+    m_cellOffsets[0] = 0;
+
+    // Half-shell stencil (self, E, NW, N, NE) visits each cell pair once
+    for (uint32_t cellY = 0; cellY < cellsY; ++cellY) {
+        for (uint32_t cellX = 0; cellX < cellsX; ++cellX) {
+            uint32_t cell = cellY * cellsX + cellX;
+            uint32_t begin = m_cellOffsets[cell];
+            uint32_t end = m_cellOffsets[cell + 1];
+
+            for (uint32_t a = begin; a < end; ++a) {
+                for (uint32_t b = a + 1; b < end; ++b) {
+                    resolvePair(m_sortedIndices[a], m_sortedIndices[b]);
+                }
+
+                uint32_t spans[2][2] = {{0, 0}, {0, 0}};
+                if (cellX + 1 < cellsX) {
+                    spans[0][0] = m_cellOffsets[cell + 1];
+                    spans[0][1] = m_cellOffsets[cell + 2];
+                }
+                if (cellY + 1 < cellsY) {
+                    uint32_t left = (cellY + 1) * cellsX + (cellX > 0 ? cellX - 1 : 0);
+                    uint32_t right = (cellY + 1) * cellsX + std::min(cellX + 1, cellsX - 1);
+                    spans[1][0] = m_cellOffsets[left];
+                    spans[1][1] = m_cellOffsets[right + 1];
+                }
+                for (const auto& span : spans) {
+                    for (uint32_t b = span[0]; b < span[1]; ++b) {
+                        resolvePair(m_sortedIndices[a], m_sortedIndices[b]);
+                    }
+                }
+            }
+        }
+    }
+}
+
+void DeterministicPhysicsEngine::resolvePair(uint32_t a, uint32_t b) {
+    int64_t dx = m_posX[b] - m_posX[a];
+    int64_t dy = m_posY[b] - m_posY[a];
+    int64_t radiusSum = m_radius[a] + m_radius[b];
+    int64_t distanceSq = FixedPoint::mul(dx, dx) + FixedPoint::mul(dy, dy);
+    if (distanceSq >= FixedPoint::mul(radiusSum, radiusSum) || distanceSq == 0) return;
+    m_lastContactCount++;
+
+    int64_t distance = FixedPoint::sqrt(distanceSq);
+    if (distance == 0) return;
+    int64_t nx = FixedPoint::div(dx, distance);
+    int64_t ny = FixedPoint::div(dy, distance);
+
+    // Separate overlapping particles
+    int64_t separation = (radiusSum - distance) / 2;
+    int64_t sepX = FixedPoint::mul(nx, separation);
+    int64_t sepY = FixedPoint::mul(ny, separation);
+    m_posX[a] -= sepX;
+    m_posY[a] -= sepY;
+    m_posX[b] += sepX;
+    m_posY[b] += sepY;
+
+    // Don't resolve if velocities are separating
+    int64_t velAlongNormal = FixedPoint::mul(m_velX[b] - m_velX[a], nx) + FixedPoint::mul(m_velY[b] - m_velY[a], ny);
+    if (velAlongNormal > 0) return;
+
+    int64_t j = FixedPoint::mul(-(FixedPoint::ONE + m_collisionDamping), velAlongNormal);
+    j = FixedPoint::div(j, m_invMass[a] + m_invMass[b]);
+
+    int64_t impulseX = FixedPoint::mul(j, nx);
+    int64_t impulseY = FixedPoint::mul(j, ny);
+    m_velX[a] -= FixedPoint::mul(impulseX, m_invMass[a]);
+    m_velY[a] -= FixedPoint::mul(impulseY, m_invMass[a]);
+    m_velX[b] += FixedPoint::mul(impulseX, m_invMass[b]);
+    m_velY[b] += FixedPoint::mul(impulseY, m_invMass[b]);
+}
+
+uint64_t DeterministicPhysicsEngine::computeStateHash() const {
+    uint64_t hash = 14695981039346656037ULL;
+    auto mix = [&hash](const std::vector<int64_t>& values) {
+        for (int64_t value : values) {
+            uint64_t bits = static_cast<uint64_t>(value);
+            for (int byte = 0; byte < 8; ++byte) {
+                hash ^= (bits >> (byte * 8)) & 0xFF;
+                hash *= 1099511628211ULL;
+            }
+        }
+    };
+    mix(m_posX);
+    mix(m_posY);
+    mix(m_velX);
+    mix(m_velY);
+    return hash;
+}
@@ -0,0 +1,72 @@
+#ifndef DETERMINISTIC_PHYSICS_ENGINE_H
+#define DETERMINISTIC_PHYSICS_ENGINE_H
+
+#include "../particle/ParticleSystem.h"
+#include "FixedPoint.h"
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <vector>
+
+// Fixed-point (Q32.32) physics path for bitwise-reproducible trajectories.
+// Mirrors PhysicsEngine's gravity / collision / boundary model, but all state
+// lives in int64 SoA arrays and every kernel is integer-only, so the same input
+// produces the same bits on every machine regardless of -march=native or the
+// vector ISA the compiler picked. Float values are only produced by storeTo()
+// for rendering and export.
+class DeterministicPhysicsEngine {
+public:
+    DeterministicPhysicsEngine();
+
+    // State transfer (float -> fixed conversion is exact per input value)
+    template <typename Precision>
+    void loadFrom(const BasicParticleSystem<Precision>& system);
+    template <typename Precision>
+    void storeTo(BasicParticleSystem<Precision>& system) const;
+    void addParticle(int64_t x, int64_t y, int64_t vx, int64_t vy, int64_t mass, int64_t radius); // raw Q32.32
+
+    // Simulation
+    void step();
+
+    // Configuration (converted to fixed point once, when set)
+    void setTimeStep(float deltaTime) { m_timeStep = FixedPoint::fromFloat(deltaTime); }
+    void setGravity(const glm::vec2& gravity);
+    void setCollisionDamping(float damping) { m_collisionDamping = FixedPoint::fromFloat(damping); }
+    void setBounds(const glm::vec2& minBounds, const glm::vec2& maxBounds);
+
+    // Reproducibility check: FNV-1a over the raw state arrays
+    uint64_t computeStateHash() const;
+    size_t getParticleCount() const { return m_posX.size(); }
+    size_t getLastContactCount() const { return m_lastContactCount; }
+
+private:
+    // Particle state (Q32.32)
+    std::vector<int64_t> m_posX, m_posY;
+    std::vector<int64_t> m_velX, m_velY;
+    std::vector<int64_t> m_radius;
+    std::vector<int64_t> m_invMass;
+    std::vector<int64_t> m_mass;
+
+    // Parameters (Q32.32)
+    int64_t m_timeStep;
+    int64_t m_gravityX, m_gravityY;
+    int64_t m_collisionDamping;
+    int64_t m_minX, m_minY, m_maxX, m_maxY;
+    bool m_hasBounds;
+
+    size_t m_lastContactCount;
+
+    // Integer cell list (power-of-two cells, so a cell key is a shift)
+    std::vector<uint32_t> m_cellKeys;
+    std::vector<uint32_t> m_cellOffsets;
+    std::vector<uint32_t> m_sortedIndices;
+
+    static const uint32_t MAX_CELLS_PER_AXIS = 4096;
+
+    // Kernels, in step order
+    void integrate();
+    void applyBoundaryConstraints();
+    void handleCollisions();
+    void resolvePair(uint32_t a, uint32_t b);
+};
+
+#endif // DETERMINISTIC_PHYSICS_ENGINE_H
@@ -0,0 +1,320 @@
+#include "Dsmc.h"
+#include "../utils/CounterRNG.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+namespace {
+
+// Streams of the counter-based generator: collisions use (step << 32) | cell,
+// initial states use the top bit so the two never overlap
+const uint64_t INITIAL_STATE_STREAM = uint64_t(1) << 63;
+
+} // namespace
+
+DsmcEngine::DsmcEngine(ThreadPool* threadPool)
+    : m_threadPool(threadPool ? threadPool : &ThreadPool::shared())
+    , m_profiler(nullptr)
+    , m_diameter(1.0f)
+    , m_particleWeight(1.0f)
+    , m_timeStep(1.0f / 60.0f)
+    , m_seed(1)
+    , m_stepIndex(0)
+    , m_cellsX(0)
+    , m_cellsY(0)
+    , m_cellWidth(1.0f)
+    , m_cellHeight(1.0f)
+    , m_chunkCount(1)
+    , m_lastCollisions(0)
+    , m_lastCandidates(0) {
+    setDomain(glm::vec2(-100.0f, -100.0f), glm::vec2(100.0f, 100.0f), 10.0f);
+}
+
+bool DsmcEngine::setDomain(const glm::vec2& minBounds, const glm::vec2& maxBounds, float cellSize) {
+    glm::vec2 size = maxBounds - minBounds;
+    if (!(cellSize > 0.0f) || !(size.x > 0.0f) || !(size.y > 0.0f)) {
+        std::cerr << "[DSMC] Invalid domain or cell size" << std::endl;
+        return false;
+    }
+    m_min = minBounds;
+    m_max = maxBounds;
+    m_cellsX = std::max(1, static_cast<int>(std::round(size.x / cellSize)));
+    m_cellsY = std::max(1, static_cast<int>(std::round(size.y / cellSize)));
+    m_cellWidth = size.x / m_cellsX;
+    m_cellHeight = size.y / m_cellsY;
+    m_maxCrossSpeed.clear(); // re-estimated at the next step
+    return true;
+}
+
+void DsmcEngine::clear() {
+    m_posX.clear(); m_posY.clear();
+    m_velX.clear(); m_velY.clear();
+    m_ids.clear();
+    m_maxCrossSpeed.clear();
+}
+
+void DsmcEngine::addParticle(float x, float y, float vx, float vy) {
+    m_ids.push_back(static_cast<uint32_t>(m_posX.size()));
+    m_posX.push_back(x);
+    m_posY.push_back(y);
+    m_velX.push_back(vx);
+    m_velY.push_back(vy);
+    m_maxCrossSpeed.clear();
+}
+
+void DsmcEngine::createUniform(size_t count, float thermalSpeed) {
+    m_posX.resize(count); m_posY.resize(count);
+    m_velX.resize(count); m_velY.resize(count);
+    m_ids.resize(count);
+    m_maxCrossSpeed.clear();
+
+    const glm::vec2 size = m_max - m_min;
+    m_threadPool->parallelFor(0, count, [&](size_t begin, size_t end, size_t) {
+        for (size_t i = begin; i < end; ++i) {
+            CounterRNG rng(m_seed, INITIAL_STATE_STREAM | i);
+            m_posX[i] = m_min.x + rng.nextFloat() * size.x;
+            m_posY[i] = m_min.y + rng.nextFloat() * size.y;
+            // Box-Muller: two normals from two uniforms
+            float radius = thermalSpeed * std::sqrt(-2.0f * std::log(1.0f - rng.nextFloat()));
+            float angle = 6.28318531f * rng.nextFloat();
+            m_velX[i] = radius * std::cos(angle);
+            m_velY[i] = radius * std::sin(angle);
+            m_ids[i] = static_cast<uint32_t>(i);
+        }
+    }, MIN_PARTICLES_PER_THREAD);
+}
+
+template <typename Precision>
+void DsmcEngine::loadFrom(const BasicParticleSystem<Precision>& system) {
+    clear();
+    for (const auto& particle : system.getParticles()) {
+        addParticle(static_cast<float>(particle.position.x), static_cast<float>(particle.position.y),
+                    static_cast<float>(particle.velocity.x), static_cast<float>(particle.velocity.y));
+    }
+}
+
+template <typename Precision>
+void DsmcEngine::storeTo(BasicParticleSystem<Precision>& system) const {
+    using Position = typename BasicParticle<Precision>::Position;
+    using Vector = typename BasicParticle<Precision>::Vector;
+    auto& particles = system.getParticles();
+    for (size_t slot = 0; slot < m_posX.size(); ++slot) {
+        uint32_t id = m_ids[slot];
+        if (id >= particles.size()) continue;
+        particles[id].position = Position(m_posX[slot], m_posY[slot]);
+        particles[id].velocity = Vector(m_velX[slot], m_velY[slot]);
+        particles[id].acceleration = Vector(0.0f, 0.0f);
+    }
+}
+
+template void DsmcEngine::loadFrom(const BasicParticleSystem<FloatPrecision>&);
+template void DsmcEngine::loadFrom(const BasicParticleSystem<DoublePrecision>&);
+template void DsmcEngine::loadFrom(const BasicParticleSystem<MixedPrecision>&);
+template void DsmcEngine::storeTo(BasicParticleSystem<FloatPrecision>&) const;
+template void DsmcEngine::storeTo(BasicParticleSystem<DoublePrecision>&) const;
+template void DsmcEngine::storeTo(BasicParticleSystem<MixedPrecision>&) const;
+
+void DsmcEngine::step() {
+    if (m_posX.empty()) return;
+
+    if (m_maxCrossSpeed.size() != getCellCount()) {
+        // Start (d g)max at a generous multiple of the rms speed; it only grows
+        // from there, and an overestimate just costs rejected candidates
+        double meanSpeedSq = 2.0 * getKineticEnergy() / m_posX.size();
+        m_maxCrossSpeed.assign(getCellCount(), m_diameter * 3.0f * static_cast<float>(std::sqrt(meanSpeedSq)));
+        m_candidateRemainder.assign(getCellCount(), 0.0f);
+    }
+
+    move();
+    sortByCell();
+    collide();
+    m_stepIndex++;
+}
+
+void DsmcEngine::move() {
+    PROFILE_SCOPE(m_profiler, "dsmc_move");
+    const size_t count = m_posX.size();
+    m_cellKeys.resize(count);
+
+    float* __restrict posX = m_posX.data();
+    float* __restrict posY = m_posY.data();
+    float* __restrict velX = m_velX.data();
+    float* __restrict velY = m_velY.data();
+    uint32_t* __restrict keys = m_cellKeys.data();
+    const float dt = m_timeStep;
+    const float minX = m_min.x, minY = m_min.y, maxX = m_max.x, maxY = m_max.y;
+    const float inverseWidth = 1.0f / m_cellWidth, inverseHeight = 1.0f / m_cellHeight;
+    const int lastX = m_cellsX - 1, lastY = m_cellsY - 1;
+    const int cellsX = m_cellsX;
+
+    m_threadPool->parallelFor(0, count, [=](size_t begin, size_t end, size_t) {
+        for (size_t i = begin; i < end; ++i) {
+            float x = posX[i] + velX[i] * dt;
+            float y = posY[i] + velY[i] * dt;
+            // Specular walls: mirror the overshoot
+            if (x < minX) { x = 2.0f * minX - x; velX[i] = -velX[i]; }
+            if (x > maxX) { x = 2.0f * maxX - x; velX[i] = -velX[i]; }
+            if (y < minY) { y = 2.0f * minY - y; velY[i] = -velY[i]; }
+            if (y > maxY) { y = 2.0f * maxY - y; velY[i] = -velY[i]; }
+            x = std::min(std::max(x, minX), maxX);
+            y = std::min(std::max(y, minY), maxY);
+            posX[i] = x;
+            posY[i] = y;
+            int cellX = std::min(lastX, static_cast<int>((x - minX) * inverseWidth));
+            int cellY = std::min(lastY, static_cast<int>((y - minY) * inverseHeight));
+            keys[i] = static_cast<uint32_t>(cellY * cellsX + cellX);
+        }
+    }, MIN_PARTICLES_PER_THREAD);
+}
+
+void DsmcEngine::sortByCell() {
+    PROFILE_SCOPE(m_profiler, "dsmc_sort");
+    const size_t count = m_posX.size();
+    const size_t cellCount = getCellCount();
+    m_chunkCount = std::max<size_t>(1, std::min(std::min(m_threadPool->getThreadCount(), size_t(MAX_SORT_CHUNKS)),
+                                                 count / MIN_PARTICLES_PER_THREAD));
+    const size_t chunkSize = (count + m_chunkCount - 1) / m_chunkCount;
+    m_chunkCounts.assign(m_chunkCount * cellCount, 0);
+
+    // Histogram per chunk
+    m_threadPool->parallelFor(0, m_chunkCount, [&](size_t chunkBegin, size_t chunkEnd, size_t) {
+        for (size_t chunk = chunkBegin; chunk < chunkEnd; ++chunk) {
+            uint32_t* counts = &m_chunkCounts[chunk * cellCount];
+            size_t end = std::min(count, (chunk + 1) * chunkSize);
+            for (size_t i = chunk * chunkSize; i < end; ++i) {
+                counts[m_cellKeys[i]]++;
+            }
+        }
+    });
+
+    // Exclusive prefix sum in (cell, chunk) order: cell ranges and per-chunk
+    // write cursors. The scatter is stable, so the result does not depend on
+    // the chunk count.
+    m_cellOffsets.resize(cellCount + 1);
+    uint32_t running = 0;
+    for (size_t cell = 0; cell < cellCount; ++cell) {
+        m_cellOffsets[cell] = running;
+        for (size_t chunk = 0; chunk < m_chunkCount; ++chunk) {
+            uint32_t& entry = m_chunkCounts[chunk * cellCount + cell];
+            uint32_t cellChunkCount = entry;
+            entry = running;
+            running += cellChunkCount;
+        }
+    }
+    m_cellOffsets[cellCount] = running;
+
+    m_scratchPosX.resize(count); m_scratchPosY.resize(count);
+    m_scratchVelX.resize(count); m_scratchVelY.resize(count);
+    m_scratchIds.resize(count);
+    m_threadPool->parallelFor(0, m_chunkCount, [&](size_t chunkBegin, size_t chunkEnd, size_t) {
+        for (size_t chunk = chunkBegin; chunk < chunkEnd; ++chunk) {
+            uint32_t* cursors = &m_chunkCounts[chunk * cellCount];
+            size_t end = std::min(count, (chunk + 1) * chunkSize);
+            for (size_t i = chunk * chunkSize; i < end; ++i) {
+                uint32_t slot = cursors[m_cellKeys[i]]++;
+                m_scratchPosX[slot] = m_posX[i];
+                m_scratchPosY[slot] = m_posY[i];
+                m_scratchVelX[slot] = m_velX[i];
+                m_scratchVelY[slot] = m_velY[i];
+                m_scratchIds[slot] = m_ids[i];
+            }
+        }
+    });
+    m_posX.swap(m_scratchPosX);
+    m_posY.swap(m_scratchPosY);
+    m_velX.swap(m_scratchVelX);
+    m_velY.swap(m_scratchVelY);
+    m_ids.swap(m_scratchIds);
+}
+
+void DsmcEngine::collide() {
+    PROFILE_SCOPE(m_profiler, "dsmc_collide");
+    const size_t cellCount = getCellCount();
+    const size_t threadCount = m_threadPool->getThreadCount();
+    m_threadCollisions.assign(threadCount, 0);
+    m_threadCandidates.assign(threadCount, 0);
+
+    // Candidate pairs per cell = N (N - 1) * candidateScale * (d g)max
+    const float candidateScale = 0.5f * m_particleWeight * m_timeStep / (m_cellWidth * m_cellHeight);
+    const uint64_t streamBase = m_stepIndex << 32;
+
+    m_threadPool->parallelFor(0, cellCount, [&](size_t cellBegin, size_t cellEnd, size_t threadIndex) {
+        float* __restrict velX = m_velX.data();
+        float* __restrict velY = m_velY.data();
+        uint64_t collisions = 0, candidatesTotal = 0;
+
+        for (size_t cell = cellBegin; cell < cellEnd; ++cell) {
+            const uint32_t first = m_cellOffsets[cell];
+            const uint32_t n = m_cellOffsets[cell + 1] - first;
+            if (n < 2) continue;
+
+            float maxCrossSpeed = m_maxCrossSpeed[cell];
+            float expected = static_cast<float>(n) * (n - 1) * candidateScale * maxCrossSpeed + m_candidateRemainder[cell];
+            uint32_t candidates = static_cast<uint32_t>(expected);
+            m_candidateRemainder[cell] = expected - candidates;
+            candidatesTotal += candidates;
+
+            CounterRNG rng(m_seed, streamBase | cell);
+            for (uint32_t k = 0; k < candidates; ++k) {
+                uint32_t i = first + rng.nextBelow(n);
+                uint32_t j = first + rng.nextBelow(n - 1);
+                if (j >= i) j++;
+
+                float gx = velX[i] - velX[j];
+                float gy = velY[i] - velY[j];
+                float g = std::sqrt(gx * gx + gy * gy);
+                float crossSpeed = m_diameter * g;
+                maxCrossSpeed = std::max(maxCrossSpeed, crossSpeed);
+                if (rng.nextFloat() * maxCrossSpeed >= crossSpeed) continue;
+
+                // Hard disks: impact parameter b = d * s with s uniform in
+                // [-1, 1] deflects the relative velocity by pi - 2 asin(s)
+                float s = 2.0f * rng.nextFloat() - 1.0f;
+                float cosChi = 2.0f * s * s - 1.0f;
+                float sinChi = 2.0f * s * std::sqrt(std::max(0.0f, 1.0f - s * s));
+                float centerX = 0.5f * (velX[i] + velX[j]);
+                float centerY = 0.5f * (velY[i] + velY[j]);
+                float halfX = 0.5f * (gx * cosChi - gy * sinChi);
+                float halfY = 0.5f * (gx * sinChi + gy * cosChi);
+                velX[i] = centerX + halfX;
+                velY[i] = centerY + halfY;
+                velX[j] = centerX - halfX;
+                velY[j] = centerY - halfY;
+                collisions++;
+            }
+            m_maxCrossSpeed[cell] = maxCrossSpeed;
+        }
+        m_threadCollisions[threadIndex] += collisions;
+        m_threadCandidates[threadIndex] += candidatesTotal;
+    }, MIN_CELLS_PER_THREAD);
+
+    m_lastCollisions = 0;
+    m_lastCandidates = 0;
+    for (size_t t = 0; t < threadCount; ++t) {
+        m_lastCollisions += m_threadCollisions[t];
+        m_lastCandidates += m_threadCandidates[t];
+    }
+}
+
+double DsmcEngine::getKineticEnergy() const {
+    double sum = 0.0;
+    for (size_t i = 0; i < m_velX.size(); ++i) {
+        sum += 0.5 * (static_cast<double>(m_velX[i]) * m_velX[i] + static_cast<double>(m_velY[i]) * m_velY[i]);
+    }
+    return sum;
+}
+
+glm::dvec2 DsmcEngine::getMomentum() const {
+    glm::dvec2 sum(0.0, 0.0);
+    for (size_t i = 0; i < m_velX.size(); ++i) {
+        sum.x += m_velX[i];
+        sum.y += m_velY[i];
+    }
+    return sum;
+}
+
+float DsmcEngine::getMeanFreePath() const {
+    float area = (m_max.x - m_min.x) * (m_max.y - m_min.y);
+    float density = m_posX.size() * m_particleWeight / area;
+    return 1.0f / (std::sqrt(2.0f) * density * m_diameter);
+}
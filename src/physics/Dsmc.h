@@ -0,0 +1,117 @@
+#ifndef DSMC_H
+#define DSMC_H
+
+#include "../particle/ParticleSystem.h"
+#include "../utils/PerformanceProfiler.h"
+#include "../utils/ThreadPool.h"
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Direct Simulation Monte Carlo for a rarefied gas of hard disks in a box with
+// specular walls. Each simulated particle stands for `particleWeight` real
+// molecules. Collisions are not detected, they are sampled:
+//   1. every particle moves ballistically for one step;
+//   2. particles are counting-sorted into square cells (parallel histogram and
+//      scatter; the arrays themselves are reordered, so each cell is a
+//      contiguous range);
+//   3. each cell, independently and in parallel, draws its number of
+//      candidate pairs with Bird's no-time-counter scheme,
+//          N (N - 1) / 2 * weight * (d g)max * dt / cellArea,
+//      accepts a random pair with probability g / gmax, and scatters it as a
+//      hard-disk collision (impact parameter uniform in [-d, d]).
+// Random numbers come from a counter-based generator with one stream per
+// (step, cell). Results are therefore bitwise identical for any thread count.
+// Momentum and energy are conserved by every collision.
+//
+// Valid when the cell size is below the mean free path and particles cross
+// at most about one cell per step.
+//
+// Profiler scopes: "dsmc_move", "dsmc_sort" and "dsmc_collide".
+class DsmcEngine {
+public:
+    explicit DsmcEngine(ThreadPool* threadPool = nullptr); // nullptr = ThreadPool::shared()
+
+    // Box [minBounds, maxBounds] split into square cells of about cellSize.
+    // Returns false for an empty box or a non-positive cell size.
+    bool setDomain(const glm::vec2& minBounds, const glm::vec2& maxBounds, float cellSize);
+    void setDiameter(float diameter) { m_diameter = diameter; }           // molecular collision diameter
+    void setParticleWeight(float weight) { m_particleWeight = weight; }   // real molecules per particle
+    void setTimeStep(float deltaTime) { m_timeStep = deltaTime; }
+    void setSeed(uint64_t seed) { m_seed = seed; }
+    void setProfiler(PerformanceProfiler* profiler) { m_profiler = profiler; }
+
+    // Particles (uniform mass, so state transfer drops the per-particle masses)
+    void clear();
+    void addParticle(float x, float y, float vx, float vy);
+    // Uniform positions and Maxwellian velocities with the given per-axis
+    // standard deviation, generated in parallel from the counter-based stream
+    void createUniform(size_t count, float thermalSpeed);
+    template <typename Precision>
+    void loadFrom(const BasicParticleSystem<Precision>& system);
+    template <typename Precision>
+    void storeTo(BasicParticleSystem<Precision>& system) const;
+
+    void step();
+
+    // Diagnostics
+    size_t getParticleCount() const { return m_posX.size(); }
+    size_t getCellCount() const { return static_cast<size_t>(m_cellsX) * m_cellsY; }
+    uint64_t getLastCollisionCount() const { return m_lastCollisions; }
+    uint64_t getLastCandidateCount() const { return m_lastCandidates; }
+    double getKineticEnergy() const;     // per unit mass
+    glm::dvec2 getMomentum() const;      // per unit mass
+    float getMeanFreePath() const;       // 1 / (sqrt(2) n d) for the current density
+
+private:
+    ThreadPool* m_threadPool;
+    PerformanceProfiler* m_profiler;
+
+    float m_diameter;
+    float m_particleWeight;
+    float m_timeStep;
+    uint64_t m_seed;
+    uint64_t m_stepIndex;
+
+    // Domain and cells
+    glm::vec2 m_min, m_max;
+    int m_cellsX, m_cellsY;
+    float m_cellWidth, m_cellHeight;
+
+    // Particle state (SoA, in cell order after each step)
+    std::vector<float> m_posX, m_posY;
+    std::vector<float> m_velX, m_velY;
+    std::vector<uint32_t> m_ids;          // insertion index of each slot
+    std::vector<uint32_t> m_cellKeys;
+    std::vector<float> m_scratchPosX, m_scratchPosY;
+    std::vector<float> m_scratchVelX, m_scratchVelY;
+    std::vector<uint32_t> m_scratchIds;
+
+    // Per cell: [begin, end) ranges, the running (d g)max and the fractional
+    // candidate count carried to the next step
+    std::vector<uint32_t> m_cellOffsets;
+    std::vector<float> m_maxCrossSpeed;
+    std::vector<float> m_candidateRemainder;
+
+    // Counting sort: [chunk][cell] histograms, then write cursors
+    std::vector<uint32_t> m_chunkCounts;
+    size_t m_chunkCount;
+    std::vector<uint64_t> m_threadCollisions, m_threadCandidates;
+
+    uint64_t m_lastCollisions;
+    uint64_t m_lastCandidates;
+
+    // The move is ~4 ns per particle (~60 us per chunk of 16384); sampling pairs
+    // costs ~110 ns per cell, ~110 us per chunk of 1024 cells
+    static const size_t MIN_PARTICLES_PER_THREAD = 16384;
+    static const size_t MIN_CELLS_PER_THREAD = 1024;
+    // Counting sort chunks are capped so [chunk][cell] histograms stay small
+    static const size_t MAX_SORT_CHUNKS = 16;
+
+    void move();
+    void sortByCell();
+    void collide();
+};
+
+#endif // DSMC_H
@@ -0,0 +1,323 @@
+#include "EventDrivenEngine.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+EventDrivenEngine::EventDrivenEngine()
+    : m_profiler(nullptr)
+    , m_minX(-100.0)
+    , m_minY(-100.0)
+    , m_maxX(100.0)
+    , m_maxY(100.0)
+    , m_cellsX(1)
+    , m_cellsY(1)
+    , m_cellWidth(200.0)
+    , m_cellHeight(200.0)
+    , m_now(0.0)
+    , m_ready(false)
+    , m_collisionCount(0)
+    , m_wallCount(0)
+    , m_cellCrossingCount(0)
+    , m_staleEventCount(0) {
+}
+
+template <typename Precision>
+void EventDrivenEngine::loadFrom(const BasicParticleSystem<Precision>& system) {
+    m_posX.clear(); m_posY.clear();
+    m_velX.clear(); m_velY.clear();
+    m_stamp.clear();
+    m_radius.clear(); m_mass.clear();
+    m_eventCounts.clear();
+    for (const auto& particle : system.getParticles()) {
+        addParticle(glm::dvec2(particle.position.x, particle.position.y), glm::dvec2(particle.velocity.x, particle.velocity.y),
+                    particle.radius, particle.mass);
+    }
+    m_now = 0.0;
+}
+
+template <typename Precision>
+void EventDrivenEngine::storeTo(BasicParticleSystem<Precision>& system) const {
+    using Position = typename BasicParticle<Precision>::Position;
+    using Vector = typename BasicParticle<Precision>::Vector;
+    auto& particles = system.getParticles();
+    size_t count = std::min(particles.size(), m_posX.size());
+    for (size_t i = 0; i < count; ++i) {
+        // Disks are all at m_now after advance()
+        particles[i].position = Position(m_posX[i], m_posY[i]);
+        particles[i].velocity = Vector(m_velX[i], m_velY[i]);
+    }
+}
+
+template void EventDrivenEngine::loadFrom(const BasicParticleSystem<FloatPrecision>&);
+template void EventDrivenEngine::loadFrom(const BasicParticleSystem<DoublePrecision>&);
+template void EventDrivenEngine::loadFrom(const BasicParticleSystem<MixedPrecision>&);
+template void EventDrivenEngine::storeTo(BasicParticleSystem<FloatPrecision>&) const;
+template void EventDrivenEngine::storeTo(BasicParticleSystem<DoublePrecision>&) const;
+template void EventDrivenEngine::storeTo(BasicParticleSystem<MixedPrecision>&) const;
+
+void EventDrivenEngine::addParticle(const glm::dvec2& position, const glm::dvec2& velocity, double radius, double mass) {
+    m_posX.push_back(position.x);
+    m_posY.push_back(position.y);
+    m_velX.push_back(velocity.x);
+    m_velY.push_back(velocity.y);
+    m_stamp.push_back(m_now);
+    m_radius.push_back(radius);
+    m_mass.push_back(mass);
+    m_eventCounts.push_back(0);
+    m_ready = false;
+}
+
+void EventDrivenEngine::setBounds(const glm::vec2& minBounds, const glm::vec2& maxBounds) {
+    m_minX = minBounds.x;
+    m_minY = minBounds.y;
+    m_maxX = maxBounds.x;
+    m_maxY = maxBounds.y;
+    m_ready = false;
+}
+
+void EventDrivenEngine::synchronize(uint32_t i) {
+    double elapsed = m_now - m_stamp[i];
+    m_posX[i] += m_velX[i] * elapsed;
+    m_posY[i] += m_velY[i] * elapsed;
+    m_stamp[i] = m_now;
+}
+
+void EventDrivenEngine::insertIntoCell(uint32_t i) {
+    int32_t& head = m_cellHeads[static_cast<size_t>(m_cellY[i]) * m_cellsX + m_cellX[i]];
+    m_previous[i] = -1;
+    m_next[i] = head;
+    if (head >= 0) m_previous[head] = static_cast<int32_t>(i);
+    head = static_cast<int32_t>(i);
+}
+
+void EventDrivenEngine::removeFromCell(uint32_t i) {
+    if (m_previous[i] >= 0) {
+        m_next[m_previous[i]] = m_next[i];
+    } else {
+        m_cellHeads[static_cast<size_t>(m_cellY[i]) * m_cellsX + m_cellX[i]] = m_next[i];
+    }
+    if (m_next[i] >= 0) m_previous[m_next[i]] = m_previous[i];
+}
+
+void EventDrivenEngine::rebuild() {
+    const size_t count = m_posX.size();
+
+    // Cells at least one contact distance (largest diameter) wide, and about
+    // two disks per cell: in a dilute gas, diameter-sized cells would make
+    // cell crossings far outnumber collisions
+    double maxRadius = 0.0;
+    for (double radius : m_radius) maxRadius = std::max(maxRadius, radius);
+    const double area = (m_maxX - m_minX) * (m_maxY - m_minY);
+    const double cellSize = std::max(std::max(2.0 * maxRadius, std::sqrt(2.0 * area / count)), 1e-9);
+    m_cellsX = std::max(1, std::min(MAX_CELLS_PER_AXIS, static_cast<int>((m_maxX - m_minX) / cellSize)));
+    m_cellsY = std::max(1, std::min(MAX_CELLS_PER_AXIS, static_cast<int>((m_maxY - m_minY) / cellSize)));
+    m_cellWidth = (m_maxX - m_minX) / m_cellsX;
+    m_cellHeight = (m_maxY - m_minY) / m_cellsY;
+
+    m_cellHeads.assign(static_cast<size_t>(m_cellsX) * m_cellsY, -1);
+    m_next.assign(count, -1);
+    m_previous.assign(count, -1);
+    m_cellX.resize(count);
+    m_cellY.resize(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        synchronize(i);
+        // Disks outside the walls are put back inside
+        m_posX[i] = std::min(std::max(m_posX[i], m_minX + m_radius[i]), m_maxX - m_radius[i]);
+        m_posY[i] = std::min(std::max(m_posY[i], m_minY + m_radius[i]), m_maxY - m_radius[i]);
+        m_cellX[i] = std::min(m_cellsX - 1, std::max(0, static_cast<int>((m_posX[i] - m_minX) / m_cellWidth)));
+        m_cellY[i] = std::min(m_cellsY - 1, std::max(0, static_cast<int>((m_posY[i] - m_minY) / m_cellHeight)));
+        insertIntoCell(i);
+    }
+
+    m_queue = std::priority_queue<Event, std::vector<Event>, LaterEvent>();
+    for (uint32_t i = 0; i < count; ++i) {
+        m_eventCounts[i]++;
+        predictAll(i);
+    }
+    m_ready = true;
+}
+
+void EventDrivenEngine::predictCollision(uint32_t i, uint32_t j) {
+    // Both disks at m_now (i already is)
+    double elapsed = m_now - m_stamp[j];
+    double dx = m_posX[j] + m_velX[j] * elapsed - m_posX[i];
+    double dy = m_posY[j] + m_velY[j] * elapsed - m_posY[i];
+    double dvx = m_velX[j] - m_velX[i];
+    double dvy = m_velY[j] - m_velY[i];
+    double approach = dx * dvx + dy * dvy;
+    if (approach >= 0.0) return; // separating
+
+    double contact = m_radius[i] + m_radius[j];
+    double gapSq = dx * dx + dy * dy - contact * contact;
+    double time;
+    if (gapSq <= 0.0) {
+        time = 0.0; // overlapping and approaching: collide now
+    } else {
+        double speedSq = dvx * dvx + dvy * dvy;
+        double discriminant = approach * approach - speedSq * gapSq;
+        if (discriminant < 0.0) return; // pass each other
+        time = gapSq / (-approach + std::sqrt(discriminant)); // smaller root, cancellation-free form
+    }
+    m_queue.push({m_now + time, i, j, m_eventCounts[i], m_eventCounts[j], EventType::Collision});
+}
+
+void EventDrivenEngine::predictCollisionsInCell(uint32_t i, int cellX, int cellY) {
+    if (cellX < 0 || cellX >= m_cellsX || cellY < 0 || cellY >= m_cellsY) return;
+    for (int32_t j = m_cellHeads[static_cast<size_t>(cellY) * m_cellsX + cellX]; j >= 0; j = m_next[j]) {
+        if (static_cast<uint32_t>(j) != i) predictCollision(i, static_cast<uint32_t>(j));
+    }
+}
+
+void EventDrivenEngine::predictBoundary(uint32_t i) {
+    // Earliest of: wall in x / y, cell edge in x / y (cell edges at the grid
+    // border are walls, so they are skipped)
+    const double infinity = std::numeric_limits<double>::infinity();
+    double best = infinity;
+    EventType type = EventType::WallX;
+    auto consider = [&](double time, EventType candidate) {
+        if (time < best) {
+            best = time;
+            type = candidate;
+        }
+    };
+
+    const double vx = m_velX[i], vy = m_velY[i];
+    if (vx > 0.0) {
+        consider((m_maxX - m_radius[i] - m_posX[i]) / vx, EventType::WallX);
+        if (m_cellX[i] + 1 < m_cellsX) consider((m_minX + (m_cellX[i] + 1) * m_cellWidth - m_posX[i]) / vx, EventType::CellX);
+    } else if (vx < 0.0) {
+        consider((m_minX + m_radius[i] - m_posX[i]) / vx, EventType::WallX);
+        if (m_cellX[i] > 0) consider((m_minX + m_cellX[i] * m_cellWidth - m_posX[i]) / vx, EventType::CellX);
+    }
+    if (vy > 0.0) {
+        consider((m_maxY - m_radius[i] - m_posY[i]) / vy, EventType::WallY);
+        if (m_cellY[i] + 1 < m_cellsY) consider((m_minY + (m_cellY[i] + 1) * m_cellHeight - m_posY[i]) / vy, EventType::CellY);
+    } else if (vy < 0.0) {
+        consider((m_minY + m_radius[i] - m_posY[i]) / vy, EventType::WallY);
+        if (m_cellY[i] > 0) consider((m_minY + m_cellY[i] * m_cellHeight - m_posY[i]) / vy, EventType::CellY);
+    }
+    if (best == infinity) return; // at rest
+
+    m_queue.push({m_now + std::max(best, 0.0), i, i, m_eventCounts[i], m_eventCounts[i], type});
+}
+
+void EventDrivenEngine::predictAll(uint32_t i) {
+    for (int dy = -1; dy <= 1; ++dy) {
+        for (int dx = -1; dx <= 1; ++dx) {
+            predictCollisionsInCell(i, m_cellX[i] + dx, m_cellY[i] + dy);
+        }
+    }
+    predictBoundary(i);
+}
+
+void EventDrivenEngine::handleCollision(const Event& event) {
+    const uint32_t i = event.a, j = event.b;
+    synchronize(i);
+    synchronize(j);
+
+    double dx = m_posX[j] - m_posX[i];
+    double dy = m_posY[j] - m_posY[i];
+    double distance = std::sqrt(dx * dx + dy * dy);
+    if (distance > 0.0) {
+        double nx = dx / distance, ny = dy / distance;
+        double closing = (m_velX[j] - m_velX[i]) * nx + (m_velY[j] - m_velY[i]) * ny;
+        if (closing < 0.0) {
+            // Elastic: exchange the normal momentum
+            double impulse = 2.0 * m_mass[i] * m_mass[j] / (m_mass[i] + m_mass[j]) * closing;
+            m_velX[i] += impulse / m_mass[i] * nx;
+            m_velY[i] += impulse / m_mass[i] * ny;
+            m_velX[j] -= impulse / m_mass[j] * nx;
+            m_velY[j] -= impulse / m_mass[j] * ny;
+        }
+    }
+    m_collisionCount++;
+
+    // Every pending event of either disk is now stale
+    m_eventCounts[i]++;
+    m_eventCounts[j]++;
+    predictAll(i);
+    predictAll(j);
+}
+
+void EventDrivenEngine::handleWall(const Event& event) {
+    const uint32_t i = event.a;
+    synchronize(i);
+    if (event.type == EventType::WallX) {
+        m_velX[i] = -m_velX[i];
+        m_posX[i] = std::min(std::max(m_posX[i], m_minX + m_radius[i]), m_maxX - m_radius[i]);
+    } else {
+        m_velY[i] = -m_velY[i];
+        m_posY[i] = std::min(std::max(m_posY[i], m_minY + m_radius[i]), m_maxY - m_radius[i]);
+    }
+    m_wallCount++;
+    m_eventCounts[i]++;
+    predictAll(i);
+}
+
+void EventDrivenEngine::handleCellCrossing(const Event& event) {
+    // The velocity does not change, so pending events stay valid: only the
+    // disks that just came into range need predicting
+    const uint32_t i = event.a;
+    synchronize(i);
+    removeFromCell(i);
+    if (event.type == EventType::CellX) {
+        int step = m_velX[i] > 0.0 ? 1 : -1;
+        m_cellX[i] += step;
+        for (int dy = -1; dy <= 1; ++dy) {
+            predictCollisionsInCell(i, m_cellX[i] + step, m_cellY[i] + dy);
+        }
+    } else {
+        int step = m_velY[i] > 0.0 ? 1 : -1;
+        m_cellY[i] += step;
+        for (int dx = -1; dx <= 1; ++dx) {
+            predictCollisionsInCell(i, m_cellX[i] + dx, m_cellY[i] + step);
+        }
+    }
+    insertIntoCell(i);
+    m_cellCrossingCount++;
+    predictBoundary(i);
+}
+
+void EventDrivenEngine::advance(double duration) {
+    PROFILE_SCOPE(m_profiler, "edmd_advance");
+    const size_t count = m_posX.size();
+    if (count == 0) return;
+    if (!m_ready) rebuild();
+
+    const double target = m_now + duration;
+    const size_t queueLimit = MAX_EVENTS_PER_PARTICLE * count + 1024;
+    while (!m_queue.empty() && m_queue.top().time <= target) {
+        Event event = m_queue.top();
+        m_queue.pop();
+        if (event.countA != m_eventCounts[event.a] || event.countB != m_eventCounts[event.b]) {
+            m_staleEventCount++;
+            continue;
+        }
+
+        m_now = std::max(m_now, event.time);
+        if (event.type == EventType::Collision) {
+            handleCollision(event);
+        } else if (event.type == EventType::WallX || event.type == EventType::WallY) {
+            handleWall(event);
+        } else {
+            handleCellCrossing(event);
+        }
+
+        if (m_queue.size() > queueLimit) {
+            rebuild();
+        }
+    }
+
+    m_now = target;
+    for (uint32_t i = 0; i < count; ++i) {
+        synchronize(i);
+    }
+}
+
+double EventDrivenEngine::getKineticEnergy() const {
+    double sum = 0.0;
+    for (size_t i = 0; i < m_velX.size(); ++i) {
+        sum += 0.5 * m_mass[i] * (m_velX[i] * m_velX[i] + m_velY[i] * m_velY[i]);
+    }
+    return sum;
+}
@@ -0,0 +1,77 @@
+#ifndef FIXED_POINT_H
+#define FIXED_POINT_H
+
+#include <cmath>
+#include <cstdint>
+
+#if !defined(__SIZEOF_INT128__)
+#error "FixedPoint requires a compiler with 128-bit integer support (GCC or Clang on a 64-bit target)"
+#endif
+
+// Signed Q32.32 fixed-point arithmetic on raw int64_t values.
+// Every operation is exact integer math, so results are bitwise identical on
+// any CPU and with any -march / vector ISA. mul() is written with 32x32->64
+// partial products only, so loops over raw arrays auto-vectorize.
+class FixedPoint {
+public:
+    static const int FRACTION_BITS = 32;
+    static const int64_t ONE = int64_t(1) << FRACTION_BITS;
+
+    // Conversions. fromFloat is exact for the same input on every machine
+    // (scaling by a power of two and rounding to nearest are both exact).
+    static int64_t fromFloat(double value) {
+        return static_cast<int64_t>(std::llround(value * 4294967296.0));
+    }
+    static double toDouble(int64_t raw) { return static_cast<double>(raw) / 4294967296.0; }
+    static float toFloat(int64_t raw) { return static_cast<float>(toDouble(raw)); }
+    static int64_t fromInt(int64_t value) { return value * ONE; }
+
+    // (a * b) >> 32 on magnitudes, truncated toward zero. Branch-free.
+    static inline int64_t mul(int64_t a, int64_t b) {
+        uint64_t signA = static_cast<uint64_t>(a >> 63);
+        uint64_t signB = static_cast<uint64_t>(b >> 63);
+        uint64_t magA = (static_cast<uint64_t>(a) ^ signA) - signA;
+        uint64_t magB = (static_cast<uint64_t>(b) ^ signB) - signB;
+
+        uint64_t aHi = magA >> 32, aLo = magA & 0xFFFFFFFFULL;
+        uint64_t bHi = magB >> 32, bLo = magB & 0xFFFFFFFFULL;
+        uint64_t result = ((aHi * bHi) << 32) + aHi * bLo + aLo * bHi + ((aLo * bLo) >> 32);
+
+        uint64_t sign = signA ^ signB;
+        return static_cast<int64_t>((result ^ sign) - sign);
+    }
+
+    // (a << 32) / b, truncated toward zero. Returns 0 for b == 0.
+    static inline int64_t div(int64_t a, int64_t b) {
+        if (b == 0) return 0;
+        __int128 numerator = static_cast<__int128>(a) * ONE;
+        return static_cast<int64_t>(numerator / b);
+    }
+
+    // Floor square root of a non-negative Q32.32 value
+    static inline int64_t sqrt(int64_t a) {
+        if (a <= 0) return 0;
+        unsigned __int128 value = static_cast<unsigned __int128>(a) << FRACTION_BITS;
+
+        // Integer Newton iteration from an over-estimate converges monotonically
+        unsigned __int128 x = static_cast<unsigned __int128>(1) << ((bitLength(value) + 1) / 2);
+        while (true) {
+            unsigned __int128 next = (x + value / x) >> 1;
+            if (next >= x) break;
+            x = next;
+        }
+        return static_cast<int64_t>(x);
+    }
+
+private:
+    static inline int bitLength(unsigned __int128 value) {
+        int bits = 0;
+        while (value) {
+            value >>= 1;
+            bits++;
+        }
+        return bits;
+    }
+};
+
+#endif // FIXED_POINT_H
@@ -0,0 +1,594 @@
+#include "FlipFluid.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+namespace {
+
+// Bilinear interpolation on a face grid of width x height samples, where
+// (fx, fy) is the position in sample units. Outside positions are clamped.
+float sampleFaces(const float* values, int width, int height, float fx, float fy) {
+    int i = std::min(std::max(static_cast<int>(std::floor(fx)), 0), width - 2);
+    int j = std::min(std::max(static_cast<int>(std::floor(fy)), 0), height - 2);
+    float tx = std::min(std::max(fx - i, 0.0f), 1.0f);
+    float ty = std::min(std::max(fy - j, 0.0f), 1.0f);
+    const float* row = values + static_cast<size_t>(j) * width + i;
+    float bottom = row[0] + tx * (row[1] - row[0]);
+    float top = row[width] + tx * (row[width + 1] - row[width]);
+    return bottom + ty * (top - bottom);
+}
+
+// Adds value * bilinear weights (and the weights) around (fx, fy), as in sampleFaces
+void splatFaces(float* values, float* weights, int width, int height, float fx, float fy, float value) {
+    int i = std::min(std::max(static_cast<int>(std::floor(fx)), 0), width - 2);
+    int j = std::min(std::max(static_cast<int>(std::floor(fy)), 0), height - 2);
+    float tx = std::min(std::max(fx - i, 0.0f), 1.0f);
+    float ty = std::min(std::max(fy - j, 0.0f), 1.0f);
+    size_t base = static_cast<size_t>(j) * width + i;
+    float w00 = (1.0f - tx) * (1.0f - ty), w10 = tx * (1.0f - ty);
+    float w01 = (1.0f - tx) * ty, w11 = tx * ty;
+    values[base] += w00 * value;            weights[base] += w00;
+    values[base + 1] += w10 * value;        weights[base + 1] += w10;
+    values[base + width] += w01 * value;    weights[base + width] += w01;
+    values[base + width + 1] += w11 * value; weights[base + width + 1] += w11;
+}
+
+} // namespace
+
+FlipFluidSolver::FlipFluidSolver(ThreadPool* threadPool)
+    : m_threadPool(threadPool ? threadPool : &ThreadPool::shared())
+    , m_profiler(nullptr)
+    , m_gravity(0.0f, -9.81f)
+    , m_picRatio(0.05f)
+    , m_tolerance(1e-4f)
+    , m_maxIterations(200)
+    , m_useMultigrid(true)
+    , m_cellsX(0)
+    , m_cellsY(0)
+    , m_origin(0.0f)
+    , m_cellSize(1.0f)
+    , m_inverseCellSize(1.0f)
+    , m_fluidCellCount(0)
+    , m_lastIterations(0)
+    , m_lastResidual(0.0f) {
+}
+
+bool FlipFluidSolver::setDomain(const glm::vec2& minBounds, const glm::vec2& maxBounds, float cellSize) {
+    if (!(cellSize > 0.0f) || !(maxBounds.x > minBounds.x) || !(maxBounds.y > minBounds.y)) {
+        std::cerr << "[FLIP] Invalid domain or cell size " << cellSize << std::endl;
+        return false;
+    }
+    const int cellsX = static_cast<int>(std::ceil((maxBounds.x - minBounds.x) / cellSize));
+    const int cellsY = static_cast<int>(std::ceil((maxBounds.y - minBounds.y) / cellSize));
+    if (cellsX < 2 || cellsY < 2) {
+        std::cerr << "[FLIP] Domain needs at least 2x2 cells, got " << cellsX << "x" << cellsY << std::endl;
+        return false;
+    }
+
+    m_cellsX = cellsX;
+    m_cellsY = cellsY;
+    m_origin = minBounds;
+    m_cellSize = cellSize;
+    m_inverseCellSize = 1.0f / cellSize;
+
+    const size_t uSize = static_cast<size_t>(cellsX + 1) * cellsY;
+    const size_t vSize = static_cast<size_t>(cellsX) * (cellsY + 1);
+    const size_t cells = static_cast<size_t>(cellsX) * cellsY;
+    m_u.assign(uSize, 0.0f); m_uBefore.assign(uSize, 0.0f); m_uWeight.assign(uSize, 0.0f);
+    m_v.assign(vSize, 0.0f); m_vBefore.assign(vSize, 0.0f); m_vWeight.assign(vSize, 0.0f);
+    m_fluid.assign(cells, 0);
+    m_pressure.assign(cells, 0.0f);
+    m_residual.assign(cells, 0.0f);
+    m_direction.assign(cells, 0.0f);
+    m_product.assign(cells, 0.0f);
+    m_preconditioned.assign(cells, 0.0f);
+
+    // Halve (rounding up) until the coarsest level is a handful of cells across
+    m_levels.clear();
+    int levelX = cellsX, levelY = cellsY;
+    while (true) {
+        Level level;
+        level.cellsX = levelX;
+        level.cellsY = levelY;
+        const size_t levelCells = static_cast<size_t>(levelX) * levelY;
+        for (std::vector<float>* vector : {&level.diagonal, &level.right, &level.up,
+                                           &level.solution, &level.rhs, &level.residual}) {
+            vector->assign(levelCells, 0.0f);
+        }
+        m_levels.push_back(level);
+        if (levelX <= COARSEST_CELLS || levelY <= COARSEST_CELLS) break;
+        levelX = (levelX + 1) / 2;
+        levelY = (levelY + 1) / 2;
+    }
+    return true;
+}
+
+void FlipFluidSolver::setSolverTolerance(float tolerance, int maxIterations) {
+    m_tolerance = tolerance;
+    m_maxIterations = std::max(1, maxIterations);
+}
+
+template <typename Body>
+double FlipFluidSolver::parallelSum(size_t count, const Body& body) {
+    const size_t threads = m_threadPool->getThreadCount();
+    m_threadSums.assign(threads, 0.0);
+    m_threadPool->parallelFor(0, count, [&](size_t begin, size_t end, size_t threadIndex) {
+        m_threadSums[threadIndex] = body(begin, end);
+    }, MIN_CELLS_PER_THREAD);
+
+    double sum = 0.0;
+    for (double partial : m_threadSums) {
+        sum += partial;
+    }
+    return sum;
+}
+
+template <typename Precision>
+void FlipFluidSolver::transferToGrid(const BasicParticleSystem<Precision>& system) {
+    PROFILE_SCOPE(m_profiler, "flip_to_grid");
+    const auto& particles = system.getParticles();
+    const size_t threads = m_threadPool->getThreadCount();
+    const int uWidth = m_cellsX + 1, uHeight = m_cellsY;
+    const int vWidth = m_cellsX, vHeight = m_cellsY + 1;
+    const size_t uSize = m_u.size(), vSize = m_v.size(), cells = m_fluid.size();
+
+    m_threadU.assign(threads * uSize, 0.0f);
+    m_threadUWeight.assign(threads * uSize, 0.0f);
+    m_threadV.assign(threads * vSize, 0.0f);
+    m_threadVWeight.assign(threads * vSize, 0.0f);
+    m_threadCells.assign(threads * cells, 0.0f);
+
+    // Each thread splats its particles into its own buffers
+    m_threadPool->parallelFor(0, particles.size(), [&](size_t begin, size_t end, size_t threadIndex) {
+        float* u = &m_threadU[threadIndex * uSize];
+        float* uWeight = &m_threadUWeight[threadIndex * uSize];
+        float* v = &m_threadV[threadIndex * vSize];
+        float* vWeight = &m_threadVWeight[threadIndex * vSize];
+        float* cellCounts = &m_threadCells[threadIndex * cells];
+        for (size_t p = begin; p < end; ++p) {
+            const auto& particle = particles[p];
+            float gx = (static_cast<float>(particle.position.x) - m_origin.x) * m_inverseCellSize;
+            float gy = (static_cast<float>(particle.position.y) - m_origin.y) * m_inverseCellSize;
+            splatFaces(u, uWeight, uWidth, uHeight, gx, gy - 0.5f, static_cast<float>(particle.velocity.x));
+            splatFaces(v, vWeight, vWidth, vHeight, gx - 0.5f, gy, static_cast<float>(particle.velocity.y));
+            int cx = std::min(std::max(static_cast<int>(gx), 0), m_cellsX - 1);
+            int cy = std::min(std::max(static_cast<int>(gy), 0), m_cellsY - 1);
+            cellCounts[static_cast<size_t>(cy) * m_cellsX + cx] += 1.0f;
+        }
+    }, MIN_PARTICLES_PER_THREAD);
+
+    // Sum the thread buffers, normalize
+    auto reduce = [&](const std::vector<float>& threadValues, const std::vector<float>& threadWeights,
+                      std::vector<float>& values, std::vector<float>& weights) {
+        const size_t size = values.size();
+        m_threadPool->parallelFor(0, size, [&](size_t begin, size_t end, size_t) {
+            for (size_t f = begin; f < end; ++f) {
+                float sum = 0.0f, weight = 0.0f;
+                for (size_t t = 0; t < threads; ++t) {
+                    sum += threadValues[t * size + f];
+                    weight += threadWeights[t * size + f];
+                }
+                values[f] = weight > 0.0f ? sum / weight : 0.0f;
+                weights[f] = weight;
+            }
+        }, MIN_CELLS_PER_THREAD);
+    };
+    reduce(m_threadU, m_threadUWeight, m_u, m_uWeight);
+    reduce(m_threadV, m_threadVWeight, m_v, m_vWeight);
+
+    size_t fluidCells = 0;
+    for (size_t c = 0; c < cells; ++c) {
+        float count = 0.0f;
+        for (size_t t = 0; t < threads; ++t) {
+            count += m_threadCells[t * cells + c];
+        }
+        m_fluid[c] = count > 0.0f ? 1 : 0;
+        fluidCells += m_fluid[c];
+    }
+    m_fluidCellCount = fluidCells;
+
+    // Faces no particle reached take their neighbours' velocity, so particles
+    // near the surface interpolate sensible values
+    extrapolate(m_u, m_uWeight, uWidth, uHeight);
+    extrapolate(m_v, m_vWeight, vWidth, vHeight);
+}
+
+void FlipFluidSolver::extrapolate(std::vector<float>& velocity, const std::vector<float>& weight, int width, int height) const {
+    const int layers = 2;
+    std::vector<uint8_t> valid(weight.size());
+    for (size_t f = 0; f < weight.size(); ++f) {
+        valid[f] = weight[f] > 0.0f ? 1 : 0;
+    }
+    std::vector<uint8_t> nextValid;
+    std::vector<float> source;
+    for (int layer = 0; layer < layers; ++layer) {
+        source = velocity;
+        nextValid = valid;
+        m_threadPool->parallelFor(0, static_cast<size_t>(height), [&](size_t rowBegin, size_t rowEnd, size_t) {
+            for (size_t j = rowBegin; j < rowEnd; ++j) {
+                for (int i = 0; i < width; ++i) {
+                    size_t f = j * width + i;
+                    if (valid[f]) continue;
+                    float sum = 0.0f;
+                    int count = 0;
+                    if (i > 0 && valid[f - 1]) { sum += source[f - 1]; count++; }
+                    if (i < width - 1 && valid[f + 1]) { sum += source[f + 1]; count++; }
+                    if (j > 0 && valid[f - width]) { sum += source[f - width]; count++; }
+                    if (static_cast<int>(j) < height - 1 && valid[f + width]) { sum += source[f + width]; count++; }
+                    if (count > 0) {
+                        velocity[f] = sum / count;
+                        nextValid[f] = 1;
+                    }
+                }
+            }
+        });
+        valid.swap(nextValid);
+    }
+}
+
+void FlipFluidSolver::buildLevels() {
+    // Level 0: unit weight between neighbouring fluid cells; a fluid cell's
+    // diagonal counts its non-wall faces (an air neighbour is pressure 0)
+    Level& fine = m_levels[0];
+    const int width = m_cellsX, height = m_cellsY;
+    m_threadPool->parallelFor(0, static_cast<size_t>(height), [&](size_t rowBegin, size_t rowEnd, size_t) {
+        for (size_t j = rowBegin; j < rowEnd; ++j) {
+            for (int i = 0; i < width; ++i) {
+                size_t c = j * width + i;
+                if (!m_fluid[c]) {
+                    fine.diagonal[c] = fine.right[c] = fine.up[c] = 0.0f;
+                    continue;
+                }
+                const bool top = static_cast<int>(j) == height - 1;
+                fine.diagonal[c] = static_cast<float>((i > 0) + (i < width - 1) + (j > 0) + !top);
+                fine.right[c] = (i < width - 1 && m_fluid[c + 1]) ? 1.0f : 0.0f;
+                fine.up[c] = (!top && m_fluid[c + width]) ? 1.0f : 0.0f;
+            }
+        }
+    });
+
+    // Coarse levels: Galerkin product P^T A P with piecewise constant P. Faces
+    // inside a 2x2 block cancel; faces between blocks add up. Halving it gives
+    // the unit stencil again in the interior; the plain product over-weights
+    // the coarse grid and costs about 2.5x the CG iterations.
+    for (size_t l = 1; l < m_levels.size(); ++l) {
+        const Level& f = m_levels[l - 1];
+        Level& coarse = m_levels[l];
+        m_threadPool->parallelFor(0, static_cast<size_t>(coarse.cellsY), [&](size_t rowBegin, size_t rowEnd, size_t) {
+            for (size_t J = rowBegin; J < rowEnd; ++J) {
+                for (int I = 0; I < coarse.cellsX; ++I) {
+                    float diagonal = 0.0f, right = 0.0f, up = 0.0f;
+                    const int x0 = 2 * I, y0 = 2 * static_cast<int>(J);
+                    const bool hasX1 = x0 + 1 < f.cellsX, hasY1 = y0 + 1 < f.cellsY;
+                    for (int b = 0; b < (hasY1 ? 2 : 1); ++b) {
+                        for (int a = 0; a < (hasX1 ? 2 : 1); ++a) {
+                            diagonal += f.diagonal[static_cast<size_t>(y0 + b) * f.cellsX + x0 + a];
+                        }
+                        size_t rowStart = static_cast<size_t>(y0 + b) * f.cellsX;
+                        if (hasX1) {
+                            diagonal -= 2.0f * f.right[rowStart + x0];
+                            right += f.right[rowStart + x0 + 1];
+                        } else {
+                            right += f.right[rowStart + x0];
+                        }
+                    }
+                    for (int a = 0; a < (hasX1 ? 2 : 1); ++a) {
+                        if (hasY1) {
+                            diagonal -= 2.0f * f.up[static_cast<size_t>(y0) * f.cellsX + x0 + a];
+                            up += f.up[static_cast<size_t>(y0 + 1) * f.cellsX + x0 + a];
+                        } else {
+                            up += f.up[static_cast<size_t>(y0) * f.cellsX + x0 + a];
+                        }
+                    }
+                    size_t c = J * coarse.cellsX + I;
+                    coarse.diagonal[c] = 0.5f * diagonal;
+                    coarse.right[c] = 0.5f * right;
+                    coarse.up[c] = 0.5f * up;
+                }
+            }
+        });
+    }
+}
+
+void FlipFluidSolver::applyOperator(const Level& level, const std::vector<float>& x, std::vector<float>& result) const {
+    const int width = level.cellsX, height = level.cellsY;
+    m_threadPool->parallelFor(0, static_cast<size_t>(height), [&](size_t rowBegin, size_t rowEnd, size_t) {
+        for (size_t j = rowBegin; j < rowEnd; ++j) {
+            for (int i = 0; i < width; ++i) {
+                size_t c = j * width + i;
+                float sum = level.diagonal[c] * x[c];
+                if (i > 0) sum -= level.right[c - 1] * x[c - 1];
+                if (i < width - 1) sum -= level.right[c] * x[c + 1];
+                if (j > 0) sum -= level.up[c - width] * x[c - width];
+                if (static_cast<int>(j) < height - 1) sum -= level.up[c] * x[c + width];
+                result[c] = sum;
+            }
+        }
+    }, MIN_CELLS_PER_THREAD / width + 1);
+}
+
+void FlipFluidSolver::smooth(Level& level, int sweeps) const {
+    // Damped Jacobi: symmetric, so the V-cycle is a valid CG preconditioner
+    const float omega = 2.0f / 3.0f;
+    const size_t cells = level.solution.size();
+    for (int sweep = 0; sweep < sweeps; ++sweep) {
+        applyOperator(level, level.solution, level.residual);
+        m_threadPool->parallelFor(0, cells, [&](size_t begin, size_t end, size_t) {
+            for (size_t c = begin; c < end; ++c) {
+                float diagonal = level.diagonal[c];
+                level.solution[c] += diagonal > 0.0f ? omega * (level.rhs[c] - level.residual[c]) / diagonal : 0.0f;
+            }
+        }, MIN_CELLS_PER_THREAD);
+    }
+}
+
+void FlipFluidSolver::vCycle(size_t levelIndex) {
+    Level& level = m_levels[levelIndex];
+    std::fill(level.solution.begin(), level.solution.end(), 0.0f);
+    if (levelIndex + 1 == m_levels.size()) {
+        smooth(level, COARSEST_SWEEPS);
+        return;
+    }
+
+    smooth(level, SMOOTHING_SWEEPS);
+
+    // Restrict the residual: a coarse cell sums its children (P^T)
+    applyOperator(level, level.solution, level.residual);
+    Level& coarse = m_levels[levelIndex + 1];
+    m_threadPool->parallelFor(0, static_cast<size_t>(coarse.cellsY), [&](size_t rowBegin, size_t rowEnd, size_t) {
+        for (size_t J = rowBegin; J < rowEnd; ++J) {
+            for (int I = 0; I < coarse.cellsX; ++I) {
+                float sum = 0.0f;
+                for (int b = 0; b < 2; ++b) {
+                    int y = 2 * static_cast<int>(J) + b;
+                    if (y >= level.cellsY) break;
+                    for (int a = 0; a < 2; ++a) {
+                        int x = 2 * I + a;
+                        if (x >= level.cellsX) break;
+                        size_t c = static_cast<size_t>(y) * level.cellsX + x;
+                        sum += level.rhs[c] - level.residual[c];
+                    }
+                }
+                coarse.rhs[J * coarse.cellsX + I] = sum;
+            }
+        }
+    });
+
+    vCycle(levelIndex + 1);
+
+    // Prolong: every child takes its parent's correction (P)
+    m_threadPool->parallelFor(0, static_cast<size_t>(level.cellsY), [&](size_t rowBegin, size_t rowEnd, size_t) {
+        for (size_t j = rowBegin; j < rowEnd; ++j) {
+            const float* parentRow = &coarse.solution[(j / 2) * coarse.cellsX];
+            for (int i = 0; i < level.cellsX; ++i) {
+                size_t c = j * level.cellsX + i;
+                level.solution[c] += level.diagonal[c] > 0.0f ? parentRow[i / 2] : 0.0f;
+            }
+        }
+    });
+
+    smooth(level, SMOOTHING_SWEEPS);
+}
+
+void FlipFluidSolver::precondition(const std::vector<float>& residual, std::vector<float>& result) {
+    Level& fine = m_levels[0];
+    if (!m_useMultigrid) {
+        m_threadPool->parallelFor(0, residual.size(), [&](size_t begin, size_t end, size_t) {
+            for (size_t c = begin; c < end; ++c) {
+                result[c] = fine.diagonal[c] > 0.0f ? residual[c] / fine.diagonal[c] : 0.0f;
+            }
+        }, MIN_CELLS_PER_THREAD);
+        return;
+    }
+    fine.rhs = residual;
+    vCycle(0);
+    result = fine.solution;
+}
+
+void FlipFluidSolver::solvePressure() {
+    PROFILE_SCOPE(m_profiler, "flip_pressure");
+    buildLevels();
+    const Level& fine = m_levels[0];
+    const size_t cells = m_pressure.size();
+
+    // b = -divergence of the fluid cells (m_residual holds b on entry); p = 0
+    std::fill(m_pressure.begin(), m_pressure.end(), 0.0f);
+    const double rhsNormSq = parallelSum(cells, [&](size_t begin, size_t end) {
+        double sum = 0.0;
+        for (size_t c = begin; c < end; ++c) {
+            sum += static_cast<double>(m_residual[c]) * m_residual[c];
+        }
+        return sum;
+    });
+    m_lastIterations = 0;
+    m_lastResidual = 0.0f;
+    if (rhsNormSq == 0.0) return;
+
+    precondition(m_residual, m_preconditioned);
+    m_direction = m_preconditioned;
+    double residualDot = parallelSum(cells, [&](size_t begin, size_t end) {
+        double sum = 0.0;
+        for (size_t c = begin; c < end; ++c) {
+            sum += static_cast<double>(m_residual[c]) * m_preconditioned[c];
+        }
+        return sum;
+    });
+
+    const double targetSq = static_cast<double>(m_tolerance) * m_tolerance * rhsNormSq;
+    double residualNormSq = rhsNormSq;
+    while (m_lastIterations < m_maxIterations && residualNormSq > targetSq) {
+        applyOperator(fine, m_direction, m_product);
+        const double curvature = parallelSum(cells, [&](size_t begin, size_t end) {
+            double sum = 0.0;
+            for (size_t c = begin; c < end; ++c) {
+                sum += static_cast<double>(m_direction[c]) * m_product[c];
+            }
+            return sum;
+        });
+        if (!(curvature > 0.0)) break;
+
+        const float alpha = static_cast<float>(residualDot / curvature);
+        residualNormSq = parallelSum(cells, [&](size_t begin, size_t end) {
+            double sum = 0.0;
+            for (size_t c = begin; c < end; ++c) {
+                m_pressure[c] += alpha * m_direction[c];
+                m_residual[c] -= alpha * m_product[c];
+                sum += static_cast<double>(m_residual[c]) * m_residual[c];
+            }
+            return sum;
+        });
+        m_lastIterations++;
+        if (residualNormSq <= targetSq) break;
+
+        precondition(m_residual, m_preconditioned);
+        const double nextDot = parallelSum(cells, [&](size_t begin, size_t end) {
+            double sum = 0.0;
+            for (size_t c = begin; c < end; ++c) {
+                sum += static_cast<double>(m_residual[c]) * m_preconditioned[c];
+            }
+            return sum;
+        });
+        const float beta = static_cast<float>(nextDot / residualDot);
+        residualDot = nextDot;
+        m_threadPool->parallelFor(0, cells, [&](size_t begin, size_t end, size_t) {
+            for (size_t c = begin; c < end; ++c) {
+                m_direction[c] = m_preconditioned[c] + beta * m_direction[c];
+            }
+        }, MIN_CELLS_PER_THREAD);
+    }
+    m_lastResidual = static_cast<float>(std::sqrt(residualNormSq / rhsNormSq));
+}
+
+void FlipFluidSolver::project() {
+    const int width = m_cellsX, height = m_cellsY;
+    const int uWidth = width + 1;
+
+    // Pressure (scaled by dt / (density h)) makes the new divergence
+    // div + A p vanish, so A p = -div
+    m_threadPool->parallelFor(0, static_cast<size_t>(height), [&](size_t rowBegin, size_t rowEnd, size_t) {
+        for (size_t j = rowBegin; j < rowEnd; ++j) {
+            for (int i = 0; i < width; ++i) {
+                size_t c = j * width + i;
+                float divergence = m_u[j * uWidth + i + 1] - m_u[j * uWidth + i]
+                                 + m_v[(j + 1) * width + i] - m_v[j * width + i];
+                m_residual[c] = m_fluid[c] ? -divergence : 0.0f;
+            }
+        }
+    });
+
+    solvePressure();
+
+    // Subtract the pressure gradient on faces next to fluid (air pressure is 0;
+    // wall faces stay at zero velocity)
+    m_threadPool->parallelFor(0, static_cast<size_t>(height + 1), [&](size_t rowBegin, size_t rowEnd, size_t) {
+        for (size_t j = rowBegin; j < rowEnd; ++j) {
+            if (static_cast<int>(j) < height) {
+                for (int i = 1; i < width; ++i) {
+                    size_t left = j * width + i - 1, right = left + 1;
+                    if (m_fluid[left] || m_fluid[right]) {
+                        m_u[j * uWidth + i] -= m_pressure[right] - m_pressure[left];
+                    }
+                }
+            }
+            if (j > 0 && static_cast<int>(j) < height) {
+                for (int i = 0; i < width; ++i) {
+                    size_t below = (j - 1) * width + i, above = j * width + i;
+                    if (m_fluid[below] || m_fluid[above]) {
+                        m_v[j * width + i] -= m_pressure[above] - m_pressure[below];
+                    }
+                }
+            }
+        }
+    });
+}
+
+template <typename Precision>
+void FlipFluidSolver::transferToParticles(BasicParticleSystem<Precision>& system, float deltaTime) const {
+    PROFILE_SCOPE(m_profiler, "flip_to_particles");
+    using Position = typename BasicParticle<Precision>::Position;
+    using Vector = typename BasicParticle<Precision>::Vector;
+    using ScalarType = typename Precision::Scalar;
+
+    auto& particles = system.getParticles();
+    const int uWidth = m_cellsX + 1, uHeight = m_cellsY;
+    const int vWidth = m_cellsX, vHeight = m_cellsY + 1;
+    const float picRatio = m_picRatio;
+    const float margin = 1e-3f * m_cellSize;
+    const glm::vec2 lower = m_origin + margin;
+    const glm::vec2 upper = m_origin + glm::vec2(m_cellsX, m_cellsY) * m_cellSize - margin;
+
+    m_threadPool->parallelFor(0, particles.size(), [&](size_t begin, size_t end, size_t) {
+        for (size_t p = begin; p < end; ++p) {
+            auto& particle = particles[p];
+            float gx = (static_cast<float>(particle.position.x) - m_origin.x) * m_inverseCellSize;
+            float gy = (static_cast<float>(particle.position.y) - m_origin.y) * m_inverseCellSize;
+            float u = sampleFaces(m_u.data(), uWidth, uHeight, gx, gy - 0.5f);
+            float v = sampleFaces(m_v.data(), vWidth, vHeight, gx - 0.5f, gy);
+            float du = u - sampleFaces(m_uBefore.data(), uWidth, uHeight, gx, gy - 0.5f);
+            float dv = v - sampleFaces(m_vBefore.data(), vWidth, vHeight, gx - 0.5f, gy);
+
+            float vx = picRatio * u + (1.0f - picRatio) * (static_cast<float>(particle.velocity.x) + du);
+            float vy = picRatio * v + (1.0f - picRatio) * (static_cast<float>(particle.velocity.y) + dv);
+
+            // Advect, then keep inside the walls (losing the velocity into them)
+            float x = static_cast<float>(particle.position.x) + deltaTime * vx;
+            float y = static_cast<float>(particle.position.y) + deltaTime * vy;
+            if (x < lower.x) { x = lower.x; vx = std::max(vx, 0.0f); }
+            if (x > upper.x) { x = upper.x; vx = std::min(vx, 0.0f); }
+            if (y < lower.y) { y = lower.y; vy = std::max(vy, 0.0f); }
+            if (y > upper.y) { y = upper.y; vy = std::min(vy, 0.0f); }
+
+            particle.velocity = Vector(static_cast<ScalarType>(vx), static_cast<ScalarType>(vy));
+            particle.position = Position(x, y);
+        }
+    }, MIN_PARTICLES_PER_THREAD);
+}
+
+template <typename Precision>
+void FlipFluidSolver::step(BasicParticleSystem<Precision>& system, typename Precision::Scalar deltaTime) {
+    if (m_levels.empty() || system.getParticles().empty()) return;
+    const float dt = static_cast<float>(deltaTime);
+
+    transferToGrid(system);
+
+    // Walls, the FLIP reference, then body forces (walls again after them)
+    const int uWidth = m_cellsX + 1;
+    auto clearWalls = [&]() {
+        for (int j = 0; j < m_cellsY; ++j) {
+            m_u[static_cast<size_t>(j) * uWidth] = 0.0f;
+            m_u[static_cast<size_t>(j) * uWidth + m_cellsX] = 0.0f;
+        }
+        for (int i = 0; i < m_cellsX; ++i) {
+            m_v[i] = 0.0f;
+            m_v[static_cast<size_t>(m_cellsY) * m_cellsX + i] = 0.0f;
+        }
+    };
+    clearWalls();
+    m_uBefore = m_u;
+    m_vBefore = m_v;
+    for (size_t f = 0; f < m_u.size(); ++f) m_u[f] += dt * m_gravity.x;
+    for (size_t f = 0; f < m_v.size(); ++f) m_v[f] += dt * m_gravity.y;
+    clearWalls();
+
+    project();
+    transferToParticles(system, dt);
+}
+
+float FlipFluidSolver::getMaxDivergence() const {
+    float maxDivergence = 0.0f;
+    const int uWidth = m_cellsX + 1;
+    for (int j = 0; j < m_cellsY; ++j) {
+        for (int i = 0; i < m_cellsX; ++i) {
+            size_t c = static_cast<size_t>(j) * m_cellsX + i;
+            if (!m_fluid[c]) continue;
+            float divergence = m_u[j * uWidth + i + 1] - m_u[j * uWidth + i]
+                             + m_v[(j + 1) * m_cellsX + i] - m_v[c];
+            maxDivergence = std::max(maxDivergence, std::fabs(divergence));
+        }
+    }
+    return maxDivergence;
+}
+
+template void FlipFluidSolver::step(BasicParticleSystem<FloatPrecision>&, float);
+template void FlipFluidSolver::step(BasicParticleSystem<DoublePrecision>&, double);
+template void FlipFluidSolver::step(BasicParticleSystem<MixedPrecision>&, float);
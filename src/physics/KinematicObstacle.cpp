@@ -0,0 +1,185 @@
+#include "KinematicObstacle.h"
+#include <algorithm>
+#include <cmath>
+
+KinematicObstacle::KinematicObstacle(float halfLength, float radius)
+    : m_halfLength(halfLength)
+    , m_radius(radius)
+    , m_looping(true)
+    , m_center(0.0f, 0.0f)
+    , m_angle(0.0f)
+    , m_linearVelocity(0.0f, 0.0f)
+    , m_angularVelocity(0.0f)
+    , m_endpointA(-halfLength, 0.0f)
+    , m_endpointB(halfLength, 0.0f) {
+}
+
+void KinematicObstacle::addKeyframe(float time, const glm::vec2& position, float angle) {
+    m_keyframes.push_back(ObstacleKeyframe{time, position, angle});
+    if (m_keyframes.size() == 1) {
+        update(time);
+    }
+}
+
+void KinematicObstacle::update(float time) {
+    if (m_keyframes.empty()) return;
+
+    const ObstacleKeyframe& first = m_keyframes.front();
+    const ObstacleKeyframe& last = m_keyframes.back();
+    m_linearVelocity = glm::vec2(0.0f, 0.0f);
+    m_angularVelocity = 0.0f;
+
+    // Looping scripts repeat with the period of the last keyframe; a script that
+    // should loop smoothly ends on the pose it starts with
+    float duration = last.time - first.time;
+    if (m_looping && duration > 0.0f) {
+        time = first.time + std::fmod(std::max(time - first.time, 0.0f), duration);
+    }
+
+    if (time <= first.time || m_keyframes.size() == 1) {
+        m_center = first.position;
+        m_angle = first.angle;
+    } else if (time >= last.time) {
+        m_center = last.position;
+        m_angle = last.angle;
+    } else {
+        // Scripts have a handful of keyframes, so a linear scan is fine
+        size_t k = 0;
+        while (m_keyframes[k + 1].time <= time) {
+            k++;
+        }
+        const ObstacleKeyframe& a = m_keyframes[k];
+        const ObstacleKeyframe& b = m_keyframes[k + 1];
+        float span = b.time - a.time;
+        float alpha = (time - a.time) / span;
+        m_center = glm::mix(a.position, b.position, alpha);
+        m_angle = a.angle + (b.angle - a.angle) * alpha;
+
+        // Exact derivative of the interpolation, so the velocity has no jump at the loop seam
+        m_linearVelocity = (b.position - a.position) / span;
+        m_angularVelocity = (b.angle - a.angle) / span;
+    }
+
+    glm::vec2 axis(std::cos(m_angle) * m_halfLength, std::sin(m_angle) * m_halfLength);
+    m_endpointA = m_center - axis;
+    m_endpointB = m_center + axis;
+}
+
+AABB KinematicObstacle::getBounds() const {
+    return AABB{std::min(m_endpointA.x, m_endpointB.x) - m_radius, std::min(m_endpointA.y, m_endpointB.y) - m_radius,
+                std::max(m_endpointA.x, m_endpointB.x) + m_radius, std::max(m_endpointA.y, m_endpointB.y) + m_radius};
+}
+
+glm::vec2 KinematicObstacle::getVelocityAt(const glm::vec2& point) const {
+    glm::vec2 arm = point - m_center;
+    return m_linearVelocity + m_angularVelocity * glm::vec2(-arm.y, arm.x);
+}
+
+KinematicObstacleSet::KinematicObstacleSet(ThreadPool* threadPool)
+    : m_threadPool(threadPool ? threadPool : &ThreadPool::shared())
+    , m_bvhDirty(false)
+    , m_time(0.0f)
+    , m_profiler(nullptr)
+    , m_refitCount(0)
+    , m_rebuildCount(0)
+    , m_lastContactCount(0) {
+}
+
+size_t KinematicObstacleSet::addObstacle(const KinematicObstacle& obstacle) {
+    m_obstacles.push_back(obstacle);
+    m_bounds.push_back(obstacle.getBounds());
+    m_bvhDirty = true;
+    return m_obstacles.size() - 1;
+}
+
+void KinematicObstacleSet::advance(float deltaTime) {
+    m_time += deltaTime;
+    for (size_t i = 0; i < m_obstacles.size(); ++i) {
+        m_obstacles[i].update(m_time);
+        m_bounds[i] = m_obstacles[i].getBounds();
+    }
+
+    // Refit keeps the topology; rebuild only once the tree quality has degraded
+    if (!m_bvhDirty) {
+        PROFILE_SCOPE(m_profiler, "obstacle_bvh_refit");
+        m_bvh.refit(m_bounds);
+        m_refitCount++;
+    }
+    if (m_bvhDirty || m_bvh.needsRebuild()) {
+        rebuildBVH();
+    }
+}
+
+void KinematicObstacleSet::rebuildBVH() {
+    PROFILE_SCOPE(m_profiler, "obstacle_bvh_rebuild");
+    m_bvh.build(m_bounds);
+    m_bvhDirty = false;
+    m_rebuildCount++;
+}
+
+template <typename Precision>
+void KinematicObstacleSet::collide(BasicParticleSystem<Precision>& system, typename Precision::Scalar damping) {
+    using Position = typename BasicParticle<Precision>::Position;
+    using Vector = typename BasicParticle<Precision>::Vector;
+    using ScalarType = typename Precision::Scalar;
+
+    m_lastContactCount = 0;
+    if (m_obstacles.empty()) return;
+    if (m_bvhDirty) rebuildBVH();
+
+    auto& particles = system.getParticles();
+    m_threadContacts.assign(m_threadPool->getThreadCount(), 0);
+
+    // Obstacles are read-only here, so particles are independent
+    m_threadPool->parallelFor(0, particles.size(), [&](size_t begin, size_t end, size_t threadIndex) {
+        size_t localContacts = 0;
+        for (size_t i = begin; i < end; ++i) {
+            auto& particle = particles[i];
+            const float px = static_cast<float>(particle.position.x);
+            const float py = static_cast<float>(particle.position.y);
+            const float radius = static_cast<float>(particle.radius);
+            // Candidates come from the starting position; a push out of one obstacle
+            // into another that is not among them is resolved next step
+            AABB box{px - radius, py - radius, px + radius, py + radius};
+
+            m_bvh.query(box, [&](uint32_t index) {
+                const KinematicObstacle& obstacle = m_obstacles[index];
+
+                // Closest point on the capsule's core segment, from the current
+                // position: an earlier obstacle in this query may have pushed it
+                const glm::vec2 position(static_cast<float>(particle.position.x), static_cast<float>(particle.position.y));
+                glm::vec2 a = obstacle.getEndpointA();
+                glm::vec2 segment = obstacle.getEndpointB() - a;
+                float lengthSq = glm::dot(segment, segment);
+                float t = lengthSq > 0.0f ? glm::clamp(glm::dot(position - a, segment) / lengthSq, 0.0f, 1.0f) : 0.0f;
+                glm::vec2 closest = a + segment * t;
+
+                Vector offset = Vector(particle.position - Position(closest));
+                ScalarType distance = glm::length(offset);
+                ScalarType reach = particle.radius + obstacle.getRadius();
+                if (distance >= reach || distance == ScalarType(0)) return;
+                localContacts++;
+
+                // Push out along the normal, then reflect the velocity relative to the moving
+                // surface. The push is along the normal, so closest is still the contact point.
+                Vector normal = offset / distance;
+                particle.position += Position(normal * (reach - distance));
+
+                Vector surfaceVelocity = Vector(obstacle.getVelocityAt(closest));
+                ScalarType velAlongNormal = glm::dot(particle.velocity - surfaceVelocity, normal);
+                if (velAlongNormal < 0) {
+                    particle.velocity -= (1 + damping) * velAlongNormal * normal;
+                }
+            });
+        }
+        m_threadContacts[threadIndex] += localContacts;
+    }, MIN_PARTICLES_PER_THREAD);
+
+    for (size_t count : m_threadContacts) {
+        m_lastContactCount += count;
+    }
+}
+
+template void KinematicObstacleSet::collide(BasicParticleSystem<FloatPrecision>&, float);
+template void KinematicObstacleSet::collide(BasicParticleSystem<DoublePrecision>&, double);
+template void KinematicObstacleSet::collide(BasicParticleSystem<MixedPrecision>&, float);
@@ -0,0 +1,48 @@
+#include "LangevinThermostat.h"
+#include "../utils/CounterRNG.h"
+#include <algorithm>
+#include <cmath>
+
+LangevinThermostat::LangevinThermostat(ThreadPool* threadPool)
+    : m_threadPool(threadPool ? threadPool : &ThreadPool::shared())
+    , m_profiler(nullptr)
+    , m_temperature(1.0f)
+    , m_friction(1.0f)
+    , m_seed(1)
+    , m_stepIndex(0) {
+}
+
+template <typename Precision>
+void LangevinThermostat::apply(BasicParticleSystem<Precision>& system, typename Precision::Scalar deltaTime) {
+    using Scalar = typename Precision::Scalar;
+    using Vector = typename BasicParticle<Precision>::Vector;
+    PROFILE_SCOPE(m_profiler, "langevin");
+
+    auto& particles = system.getParticles();
+    const size_t count = particles.size();
+    const uint64_t stream = m_stepIndex++;
+    if (count == 0) return;
+
+    const Scalar decay = static_cast<Scalar>(std::exp(-static_cast<double>(m_friction) * deltaTime));
+    const Scalar noiseEnergy = (Scalar(1) - decay * decay) * static_cast<Scalar>(m_temperature);
+    const size_t batch = CounterRNG::BATCH_SIZE;
+    const size_t batchCount = (count + batch - 1) / batch;
+
+    m_threadPool->parallelFor(0, batchCount, [&](size_t begin, size_t end, size_t) {
+        float noiseX[CounterRNG::BATCH_SIZE], noiseY[CounterRNG::BATCH_SIZE];
+        for (size_t b = begin; b < end; ++b) {
+            const size_t first = b * batch;
+            CounterRNG::gaussianBatch(m_seed, stream, static_cast<uint32_t>(first), noiseX, noiseY);
+            const size_t lanes = std::min(batch, count - first);
+            for (size_t lane = 0; lane < lanes; ++lane) {
+                auto& particle = particles[first + lane];
+                Scalar sigma = std::sqrt(noiseEnergy / particle.mass);
+                particle.velocity = particle.velocity * decay + Vector(noiseX[lane], noiseY[lane]) * sigma;
+            }
+        }
+    }, std::max<size_t>(1, MIN_PARTICLES_PER_THREAD / batch));
+}
+
+template void LangevinThermostat::apply(BasicParticleSystem<FloatPrecision>&, FloatPrecision::Scalar);
+template void LangevinThermostat::apply(BasicParticleSystem<DoublePrecision>&, DoublePrecision::Scalar);
+template void LangevinThermostat::apply(BasicParticleSystem<MixedPrecision>&, MixedPrecision::Scalar);
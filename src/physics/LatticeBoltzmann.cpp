@@ -0,0 +1,359 @@
+#include "LatticeBoltzmann.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+namespace {
+
+// D2Q9 velocities, weights and opposite directions:
+// rest, the four axes, then the four diagonals
+const int CX[9] = {0, 1, 0, -1, 0, 1, -1, -1, 1};
+const int CY[9] = {0, 0, 1, 0, -1, 1, 1, -1, -1};
+const float WEIGHT[9] = {4.0f / 9.0f, 1.0f / 9.0f, 1.0f / 9.0f, 1.0f / 9.0f, 1.0f / 9.0f,
+                         1.0f / 36.0f, 1.0f / 36.0f, 1.0f / 36.0f, 1.0f / 36.0f};
+const int OPPOSITE[9] = {0, 3, 4, 1, 2, 7, 8, 5, 6};
+
+// BGK collision with Guo forcing of the streamed population deviations
+// g = f - w (rest density 1), in place. The force on the cell is the body
+// acceleration times rho plus the particle impulse; u is the force-corrected
+// velocity. The weights cancel from the first moment, so j is the same sum as
+// for f, and the equilibrium deviation is w * (rho - 1 + rho * (3 c.u + ...)).
+inline void collide(float g[9], float bodyX, float bodyY, float impulseX, float impulseY, float omega, float& ux, float& uy) {
+    float deltaRho = g[0] + g[1] + g[2] + g[3] + g[4] + g[5] + g[6] + g[7] + g[8];
+    float rho = 1.0f + deltaRho;
+    float jx = g[1] - g[3] + g[5] - g[6] - g[7] + g[8];
+    float jy = g[2] - g[4] + g[5] + g[6] - g[7] - g[8];
+    float forceX = rho * bodyX + impulseX;
+    float forceY = rho * bodyY + impulseY;
+    float inverseRho = 1.0f / rho;
+    ux = (jx + 0.5f * forceX) * inverseRho;
+    uy = (jy + 0.5f * forceY) * inverseRho;
+
+    const float velocityTerm = 1.5f * (ux * ux + uy * uy);
+    const float forceDotU = ux * forceX + uy * forceY;
+    const float forcePrefactor = 1.0f - 0.5f * omega;
+#pragma GCC unroll 9
+    for (int q = 0; q < 9; ++q) {
+        float cu = CX[q] * ux + CY[q] * uy;
+        float cf = CX[q] * forceX + CY[q] * forceY;
+        float equilibrium = WEIGHT[q] * (deltaRho + rho * (3.0f * cu + 4.5f * cu * cu - velocityTerm));
+        float source = forcePrefactor * WEIGHT[q] * (3.0f * (cf - forceDotU) + 9.0f * cu * cf);
+        g[q] += omega * (equilibrium - g[q]) + source;
+    }
+}
+
+// Fused pull-stream and collide over cells [begin, end) of one row, none of
+// which touches a wall or the periodic seam. Plain restrict pointers and no
+// branches, so the loop vectorizes.
+__attribute__((noinline))
+void streamCollideInterior(const float* __restrict source, float* __restrict target, size_t stride, size_t begin, size_t end,
+                           int width, const float* __restrict impulseX, const float* __restrict impulseY,
+                           float* __restrict velocityX, float* __restrict velocityY,
+                           float omega, float bodyX, float bodyY, float impulseScale) {
+    // Per-direction source rows (shifted by the pull offset) and target rows,
+    // spelled out so that every access is a plain pointer plus the cell index
+    const float* __restrict from0 = source + 0 * stride;
+    const float* __restrict from1 = source + 1 * stride - 1;
+    const float* __restrict from2 = source + 2 * stride - width;
+    const float* __restrict from3 = source + 3 * stride + 1;
+    const float* __restrict from4 = source + 4 * stride + width;
+    const float* __restrict from5 = source + 5 * stride - 1 - width;
+    const float* __restrict from6 = source + 6 * stride + 1 - width;
+    const float* __restrict from7 = source + 7 * stride + 1 + width;
+    const float* __restrict from8 = source + 8 * stride - 1 + width;
+    float* __restrict to0 = target + 0 * stride;
+    float* __restrict to1 = target + 1 * stride;
+    float* __restrict to2 = target + 2 * stride;
+    float* __restrict to3 = target + 3 * stride;
+    float* __restrict to4 = target + 4 * stride;
+    float* __restrict to5 = target + 5 * stride;
+    float* __restrict to6 = target + 6 * stride;
+    float* __restrict to7 = target + 7 * stride;
+    float* __restrict to8 = target + 8 * stride;
+    // The 18 direction rows never overlap, but proving it would take more
+    // run-time alias checks than GCC is willing to emit
+#pragma GCC ivdep
+    for (size_t cell = begin; cell < end; ++cell) {
+        float f[9] = {from0[cell], from1[cell], from2[cell], from3[cell], from4[cell],
+                      from5[cell], from6[cell], from7[cell], from8[cell]};
+        float ux, uy;
+        collide(f, bodyX, bodyY, impulseScale * impulseX[cell], impulseScale * impulseY[cell], omega, ux, uy);
+        to0[cell] = f[0]; to1[cell] = f[1]; to2[cell] = f[2];
+        to3[cell] = f[3]; to4[cell] = f[4]; to5[cell] = f[5];
+        to6[cell] = f[6]; to7[cell] = f[7]; to8[cell] = f[8];
+        velocityX[cell] = ux;
+        velocityY[cell] = uy;
+    }
+}
+
+// Bilinear stencil between cell centres: periodic in x, clamped in y
+struct Stencil {
+    size_t index[4];
+    float weight[4];
+};
+
+inline Stencil makeStencil(float gridX, float gridY, int cellsX, int cellsY) {
+    float baseX = std::floor(gridX);
+    float fractionX = gridX - baseX;
+    int x0 = static_cast<int>(baseX) % cellsX;
+    if (x0 < 0) x0 += cellsX;
+    int x1 = x0 + 1 == cellsX ? 0 : x0 + 1;
+
+    gridY = std::min(std::max(gridY, 0.0f), static_cast<float>(cellsY - 1));
+    int y0 = std::min(static_cast<int>(gridY), cellsY - 2);
+    float fractionY = gridY - y0;
+
+    Stencil stencil;
+    stencil.index[0] = static_cast<size_t>(y0) * cellsX + x0;
+    stencil.index[1] = static_cast<size_t>(y0) * cellsX + x1;
+    stencil.index[2] = static_cast<size_t>(y0 + 1) * cellsX + x0;
+    stencil.index[3] = static_cast<size_t>(y0 + 1) * cellsX + x1;
+    stencil.weight[0] = (1.0f - fractionX) * (1.0f - fractionY);
+    stencil.weight[1] = fractionX * (1.0f - fractionY);
+    stencil.weight[2] = (1.0f - fractionX) * fractionY;
+    stencil.weight[3] = fractionX * fractionY;
+    return stencil;
+}
+
+} // namespace
+
+LatticeBoltzmannSolver::LatticeBoltzmannSolver(ThreadPool* threadPool)
+    : m_threadPool(threadPool ? threadPool : &ThreadPool::shared())
+    , m_profiler(nullptr)
+    , m_viscosity(1.0f)
+    , m_latticeTimeStep(1.0f)
+    , m_density(1.0f)
+    , m_bodyForce(0.0f, 0.0f)
+    , m_dragCoefficient(1.0f)
+    , m_cellsX(0)
+    , m_cellsY(0)
+    , m_origin(0.0f, 0.0f)
+    , m_cellSize(1.0f)
+    , m_timeAccumulator(0.0f)
+    , m_latticeSteps(0) {
+}
+
+bool LatticeBoltzmannSolver::setDomain(const glm::vec2& minBounds, const glm::vec2& maxBounds, float cellSize) {
+    if (!(cellSize > 0.0f) || !(maxBounds.x > minBounds.x) || !(maxBounds.y > minBounds.y)) {
+        std::cerr << "[LBM] Invalid domain or cell size " << cellSize << std::endl;
+        return false;
+    }
+    const int cellsX = static_cast<int>(std::round((maxBounds.x - minBounds.x) / cellSize));
+    const int cellsY = static_cast<int>(std::round((maxBounds.y - minBounds.y) / cellSize));
+    if (cellsX < 3 || cellsY < 3) {
+        std::cerr << "[LBM] Domain needs at least 3x3 cells, got " << cellsX << "x" << cellsY << std::endl;
+        return false;
+    }
+
+    m_cellsX = cellsX;
+    m_cellsY = cellsY;
+    m_origin = minBounds;
+    m_cellSize = cellSize;
+
+    // Fluid at rest with unit lattice density: every deviation is zero
+    const size_t cells = static_cast<size_t>(cellsX) * cellsY;
+    m_populations.assign(DIRECTIONS * cells, 0.0f);
+    m_nextPopulations = m_populations;
+    m_velocityX.assign(cells, 0.0f);
+    m_velocityY.assign(cells, 0.0f);
+    m_impulseX.assign(cells, 0.0f);
+    m_impulseY.assign(cells, 0.0f);
+    m_timeAccumulator = 0.0f;
+    m_latticeSteps = 0;
+    return true;
+}
+
+float LatticeBoltzmannSolver::getRelaxationTime() const {
+    return 0.5f + 3.0f * m_viscosity * m_latticeTimeStep / (m_cellSize * m_cellSize);
+}
+
+void LatticeBoltzmannSolver::streamCollideCell(int x, int y, float omega, float bodyX, float bodyY, float impulseScale) {
+    const size_t stride = static_cast<size_t>(m_cellsX) * m_cellsY;
+    const size_t cell = static_cast<size_t>(y) * m_cellsX + x;
+    float f[9];
+    for (int q = 0; q < DIRECTIONS; ++q) {
+        int fromY = y - CY[q];
+        if (fromY < 0 || fromY >= m_cellsY) {
+            // Half-way bounce-back: what this cell sent into the wall comes back
+            // reversed (opposite directions share a weight, so this holds for g too)
+            f[q] = m_populations[OPPOSITE[q] * stride + cell];
+            continue;
+        }
+        int fromX = x - CX[q];
+        fromX = fromX < 0 ? fromX + m_cellsX : (fromX >= m_cellsX ? fromX - m_cellsX : fromX);
+        f[q] = m_populations[q * stride + static_cast<size_t>(fromY) * m_cellsX + fromX];
+    }
+    float ux, uy;
+    collide(f, bodyX, bodyY, impulseScale * m_impulseX[cell], impulseScale * m_impulseY[cell], omega, ux, uy);
+    for (int q = 0; q < DIRECTIONS; ++q) {
+        m_nextPopulations[q * stride + cell] = f[q];
+    }
+    m_velocityX[cell] = ux;
+    m_velocityY[cell] = uy;
+}
+
+void LatticeBoltzmannSolver::streamCollideRows(int rowBegin, int rowEnd, float omega, float bodyX, float bodyY, float impulseScale) {
+    const size_t stride = static_cast<size_t>(m_cellsX) * m_cellsY;
+    for (int y = rowBegin; y < rowEnd; ++y) {
+        if (y == 0 || y == m_cellsY - 1) {
+            for (int x = 0; x < m_cellsX; ++x) {
+                streamCollideCell(x, y, omega, bodyX, bodyY, impulseScale);
+            }
+            continue;
+        }
+        const size_t rowStart = static_cast<size_t>(y) * m_cellsX;
+        streamCollideCell(0, y, omega, bodyX, bodyY, impulseScale);
+        streamCollideInterior(m_populations.data(), m_nextPopulations.data(), stride, rowStart + 1, rowStart + m_cellsX - 1,
+                              m_cellsX, m_impulseX.data(), m_impulseY.data(), m_velocityX.data(), m_velocityY.data(),
+                              omega, bodyX, bodyY, impulseScale);
+        streamCollideCell(m_cellsX - 1, y, omega, bodyX, bodyY, impulseScale);
+    }
+}
+
+void LatticeBoltzmannSolver::stepLattice(int steps) {
+    if (m_cellsX == 0 || steps <= 0) return;
+    PROFILE_SCOPE(m_profiler, "lbm_stream_collide");
+
+    const float omega = 1.0f / getRelaxationTime();
+    // Body acceleration and particle momentum in lattice units
+    const float accelerationScale = m_latticeTimeStep * m_latticeTimeStep / m_cellSize;
+    const float bodyX = m_bodyForce.x * accelerationScale;
+    const float bodyY = m_bodyForce.y * accelerationScale;
+    const float impulseScale = 1.0f / steps;
+
+    for (int step = 0; step < steps; ++step) {
+        m_threadPool->parallelFor(0, static_cast<size_t>(m_cellsY), [&](size_t rowBegin, size_t rowEnd, size_t) {
+            streamCollideRows(static_cast<int>(rowBegin), static_cast<int>(rowEnd), omega, bodyX, bodyY, impulseScale);
+        }, MIN_ROWS_PER_THREAD);
+        m_populations.swap(m_nextPopulations);
+        m_latticeSteps++;
+    }
+    std::fill(m_impulseX.begin(), m_impulseX.end(), 0.0f);
+    std::fill(m_impulseY.begin(), m_impulseY.end(), 0.0f);
+}
+
+template <typename Precision>
+void LatticeBoltzmannSolver::step(BasicParticleSystem<Precision>& system, typename Precision::Scalar deltaTime) {
+    using Vector = typename BasicParticle<Precision>::Vector;
+    if (m_cellsX == 0) return;
+
+    {
+        PROFILE_SCOPE(m_profiler, "lbm_couple");
+        auto& particles = system.getParticles();
+        const size_t count = particles.size();
+        const size_t cells = static_cast<size_t>(m_cellsX) * m_cellsY;
+        const size_t threadCount = m_threadPool->getThreadCount();
+        m_threadImpulseX.assign(threadCount * cells, 0.0f);
+        m_threadImpulseY.assign(threadCount * cells, 0.0f);
+
+        // Lattice velocity -> world, world momentum -> lattice
+        const float velocityScale = m_cellSize / m_latticeTimeStep;
+        const float momentumScale = m_latticeTimeStep / (m_density * m_cellSize * m_cellSize * m_cellSize);
+        const float inverseCellSize = 1.0f / m_cellSize;
+        const float dt = static_cast<float>(deltaTime);
+
+        m_threadPool->parallelFor(0, count, [&](size_t begin, size_t end, size_t threadIndex) {
+            float* impulseX = &m_threadImpulseX[threadIndex * cells];
+            float* impulseY = &m_threadImpulseY[threadIndex * cells];
+            for (size_t i = begin; i < end; ++i) {
+                auto& particle = particles[i];
+                float gridX = (static_cast<float>(particle.position.x) - m_origin.x) * inverseCellSize - 0.5f;
+                float gridY = (static_cast<float>(particle.position.y) - m_origin.y) * inverseCellSize - 0.5f;
+                Stencil stencil = makeStencil(gridX, gridY, m_cellsX, m_cellsY);
+
+                float fluidX = 0.0f, fluidY = 0.0f;
+                for (int k = 0; k < 4; ++k) {
+                    fluidX += stencil.weight[k] * m_velocityX[stencil.index[k]];
+                    fluidY += stencil.weight[k] * m_velocityY[stencil.index[k]];
+                }
+                fluidX *= velocityScale;
+                fluidY *= velocityScale;
+
+                // Exact relaxation towards the fluid velocity
+                float mass = static_cast<float>(particle.mass);
+                float decay = std::exp(-m_dragCoefficient * static_cast<float>(particle.radius) / mass * dt);
+                float newX = fluidX + (static_cast<float>(particle.velocity.x) - fluidX) * decay;
+                float newY = fluidY + (static_cast<float>(particle.velocity.y) - fluidY) * decay;
+                float gainedX = mass * (newX - static_cast<float>(particle.velocity.x));
+                float gainedY = mass * (newY - static_cast<float>(particle.velocity.y));
+                particle.velocity = Vector(newX, newY);
+
+                for (int k = 0; k < 4; ++k) {
+                    impulseX[stencil.index[k]] -= stencil.weight[k] * gainedX * momentumScale;
+                    impulseY[stencil.index[k]] -= stencil.weight[k] * gainedY * momentumScale;
+                }
+            }
+        }, MIN_PARTICLES_PER_THREAD);
+
+        // Fixed thread order keeps the sum reproducible
+        m_threadPool->parallelFor(0, cells, [&](size_t begin, size_t end, size_t) {
+            for (size_t t = 0; t < threadCount; ++t) {
+                const float* sourceX = &m_threadImpulseX[t * cells];
+                const float* sourceY = &m_threadImpulseY[t * cells];
+                for (size_t c = begin; c < end; ++c) {
+                    m_impulseX[c] += sourceX[c];
+                    m_impulseY[c] += sourceY[c];
+                }
+            }
+        }, MIN_PARTICLES_PER_THREAD);
+    }
+
+    // Momentum given to the fluid waits for the next lattice step if dt is
+    // shorter than one
+    m_timeAccumulator += static_cast<float>(deltaTime);
+    int steps = static_cast<int>(m_timeAccumulator / m_latticeTimeStep);
+    if (steps > MAX_LATTICE_STEPS_PER_CALL) {
+        steps = MAX_LATTICE_STEPS_PER_CALL;
+        m_timeAccumulator = 0.0f;
+    } else {
+        m_timeAccumulator -= steps * m_latticeTimeStep;
+    }
+    stepLattice(steps);
+}
+
+template void LatticeBoltzmannSolver::step(BasicParticleSystem<FloatPrecision>&, FloatPrecision::Scalar);
+template void LatticeBoltzmannSolver::step(BasicParticleSystem<DoublePrecision>&, DoublePrecision::Scalar);
+template void LatticeBoltzmannSolver::step(BasicParticleSystem<MixedPrecision>&, MixedPrecision::Scalar);
+
+glm::vec2 LatticeBoltzmannSolver::sampleVelocity(const glm::vec2& position) const {
+    if (m_cellsX == 0) return glm::vec2(0.0f, 0.0f);
+    glm::vec2 grid = (position - m_origin) / m_cellSize - glm::vec2(0.5f, 0.5f);
+    Stencil stencil = makeStencil(grid.x, grid.y, m_cellsX, m_cellsY);
+    glm::vec2 velocity(0.0f, 0.0f);
+    for (int k = 0; k < 4; ++k) {
+        velocity.x += stencil.weight[k] * m_velocityX[stencil.index[k]];
+        velocity.y += stencil.weight[k] * m_velocityY[stencil.index[k]];
+    }
+    return velocity * (m_cellSize / m_latticeTimeStep);
+}
+
+float LatticeBoltzmannSolver::getMaxLatticeSpeed() const {
+    float maxSq = 0.0f;
+    for (size_t c = 0; c < m_velocityX.size(); ++c) {
+        maxSq = std::max(maxSq, m_velocityX[c] * m_velocityX[c] + m_velocityY[c] * m_velocityY[c]);
+    }
+    return std::sqrt(maxSq);
+}
+
+glm::dvec2 LatticeBoltzmannSolver::getFluidMomentum() const {
+    const size_t stride = static_cast<size_t>(m_cellsX) * m_cellsY;
+    glm::dvec2 momentum(0.0, 0.0);
+    for (int q = 0; q < DIRECTIONS; ++q) {
+        double sum = 0.0;
+        for (size_t c = 0; c < stride; ++c) {
+            sum += m_populations[q * stride + c];
+        }
+        momentum.x += CX[q] * sum;
+        momentum.y += CY[q] * sum;
+    }
+    return momentum * static_cast<double>(m_density * m_cellSize * m_cellSize * m_cellSize / m_latticeTimeStep);
+}
+
+double LatticeBoltzmannSolver::getFluidMass() const {
+    // Each cell holds its unit rest density plus the sum of its deviations
+    double sum = static_cast<double>(m_cellsX) * m_cellsY;
+    for (float deviation : m_populations) {
+        sum += deviation;
+    }
+    return sum * m_density * m_cellSize * m_cellSize;
+}
@@ -0,0 +1,453 @@
+#include "LennardJones.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <random>
+
+namespace {
+
+// Constants of the force kernel, passed by value so they live in registers
+struct PairConstants {
+    float cutoffSq, sigmaSq;
+    float forceScale, energyScale, energyShift;
+    float width, height, halfWidth, halfHeight;
+};
+
+// Pair forces and energies of particle (xi, yi) with its list, written to
+// scratch. Gathers only and no float reductions, so the loop vectorizes
+// without -ffast-math. Returns the number of pairs inside the cutoff.
+uint32_t computePairForces(const uint32_t* __restrict list, uint32_t listSize, float xi, float yi,
+                           const float* __restrict x, const float* __restrict y, const PairConstants c,
+                           float* __restrict pairFx, float* __restrict pairFy, float* __restrict pairEnergy) {
+    uint32_t inside = 0;
+    for (uint32_t k = 0; k < listSize; ++k) {
+        const uint32_t j = list[k];
+        float dx = xi - x[j];
+        float dy = yi - y[j];
+        // Minimum image by selects (floorf does not vectorize with trapping math);
+        // valid because positions are wrapped at every list build, so |dx| < 1.5 box
+        dx += (dx > c.halfWidth ? -c.width : 0.0f) + (dx < -c.halfWidth ? c.width : 0.0f);
+        dy += (dy > c.halfHeight ? -c.height : 0.0f) + (dy < -c.halfHeight ? c.height : 0.0f);
+        const float rSq = dx * dx + dy * dy;
+        const float invRSq = 1.0f / rSq;
+        const float s2 = c.sigmaSq * invRSq;
+        const float s6 = s2 * s2 * s2;
+        const float mask = rSq < c.cutoffSq ? 1.0f : 0.0f;
+        const float f = mask * c.forceScale * s6 * (2.0f * s6 - 1.0f) * invRSq;
+        pairFx[k] = f * dx;
+        pairFy[k] = f * dy;
+        pairEnergy[k] = mask * (c.energyScale * s6 * (s6 - 1.0f) - c.energyShift);
+        inside += rSq < c.cutoffSq ? 1u : 0u;
+    }
+    return inside;
+}
+
+} // namespace
+
+LennardJonesEngine::LennardJonesEngine(ThreadPool* threadPool)
+    : m_threadPool(threadPool ? threadPool : &ThreadPool::shared())
+    , m_profiler(nullptr)
+    , m_epsilon(1.0f)
+    , m_sigma(1.0f)
+    , m_cutoff(2.5f)
+    , m_skin(0.3f)
+    , m_timeStep(0.005f)
+    , m_mass(1.0f)
+    , m_minX(0.0f)
+    , m_minY(0.0f)
+    , m_width(10.0f)
+    , m_height(10.0f)
+    , m_cellsX(1)
+    , m_cellsY(1)
+    , m_maxNeighbors(32)
+    , m_listValid(false)
+    , m_potentialEnergy(0.0)
+    , m_neighborPairCount(0)
+    , m_interactionCount(0)
+    , m_buildCount(0) {
+}
+
+void LennardJonesEngine::setPotential(float epsilon, float sigma, float cutoff) {
+    m_epsilon = epsilon;
+    m_sigma = sigma;
+    m_cutoff = cutoff;
+    m_listValid = false;
+}
+
+void LennardJonesEngine::setBox(float minX, float minY, float maxX, float maxY) {
+    m_minX = minX;
+    m_minY = minY;
+    m_width = maxX - minX;
+    m_height = maxY - minY;
+    m_listValid = false;
+}
+
+void LennardJonesEngine::clear() {
+    m_posX.clear(); m_posY.clear();
+    m_velX.clear(); m_velY.clear();
+    m_ids.clear();
+    m_slotOfId.clear();
+    m_listValid = false;
+}
+
+void LennardJonesEngine::addParticle(float x, float y, float vx, float vy) {
+    m_ids.push_back(static_cast<uint32_t>(m_ids.size()));
+    m_slotOfId.push_back(static_cast<uint32_t>(m_posX.size()));
+    m_posX.push_back(x);
+    m_posY.push_back(y);
+    m_velX.push_back(vx);
+    m_velY.push_back(vy);
+    m_listValid = false;
+}
+
+void LennardJonesEngine::createLattice(size_t count, float density, float temperature, uint32_t seed) {
+    clear();
+    if (count == 0) return;
+
+    const float side = std::sqrt(static_cast<float>(count) / density);
+    const size_t perRow = static_cast<size_t>(std::ceil(std::sqrt(static_cast<double>(count))));
+    const float spacing = side / perRow;
+    setBox(0.0f, 0.0f, side, side);
+
+    std::mt19937 generator(seed);
+    std::normal_distribution<float> velocity(0.0f, std::sqrt(temperature / m_mass));
+    double sumX = 0.0, sumY = 0.0;
+    for (size_t i = 0; i < count; ++i) {
+        float vx = velocity(generator);
+        float vy = velocity(generator);
+        addParticle((i % perRow + 0.5f) * spacing, (i / perRow + 0.5f) * spacing, vx, vy);
+        sumX += vx;
+        sumY += vy;
+    }
+
+    // Remove net momentum, then rescale to the exact temperature (2 degrees of freedom each)
+    const float meanX = static_cast<float>(sumX / count);
+    const float meanY = static_cast<float>(sumY / count);
+    for (size_t i = 0; i < count; ++i) {
+        m_velX[i] -= meanX;
+        m_velY[i] -= meanY;
+    }
+    double kinetic = getKineticEnergy();
+    if (kinetic > 0.0) {
+        float scale = static_cast<float>(std::sqrt(count * static_cast<double>(temperature) / kinetic));
+        for (size_t i = 0; i < count; ++i) {
+            m_velX[i] *= scale;
+            m_velY[i] *= scale;
+        }
+    }
+}
+
+template <typename Precision>
+void LennardJonesEngine::loadFrom(const BasicParticleSystem<Precision>& system) {
+    clear();
+    for (const auto& particle : system.getParticles()) {
+        addParticle(static_cast<float>(particle.position.x), static_cast<float>(particle.position.y),
+                    static_cast<float>(particle.velocity.x), static_cast<float>(particle.velocity.y));
+    }
+}
+
+template <typename Precision>
+void LennardJonesEngine::storeTo(BasicParticleSystem<Precision>& system) const {
+    using Position = typename BasicParticle<Precision>::Position;
+    using Vector = typename BasicParticle<Precision>::Vector;
+    auto& particles = system.getParticles();
+    for (size_t slot = 0; slot < m_posX.size(); ++slot) {
+        uint32_t id = m_ids[slot];
+        if (id >= particles.size()) continue;
+        // Slots are only wrapped at list builds, so wrap here as well
+        float x = m_posX[slot] - m_width * std::floor((m_posX[slot] - m_minX) / m_width);
+        float y = m_posY[slot] - m_height * std::floor((m_posY[slot] - m_minY) / m_height);
+        particles[id].position = Position(x, y);
+        particles[id].velocity = Vector(m_velX[slot], m_velY[slot]);
+        particles[id].acceleration = Vector(0.0f, 0.0f);
+    }
+}
+
+template void LennardJonesEngine::loadFrom(const BasicParticleSystem<FloatPrecision>&);
+template void LennardJonesEngine::loadFrom(const BasicParticleSystem<DoublePrecision>&);
+template void LennardJonesEngine::loadFrom(const BasicParticleSystem<MixedPrecision>&);
+template void LennardJonesEngine::storeTo(BasicParticleSystem<FloatPrecision>&) const;
+template void LennardJonesEngine::storeTo(BasicParticleSystem<DoublePrecision>&) const;
+template void LennardJonesEngine::storeTo(BasicParticleSystem<MixedPrecision>&) const;
+
+void LennardJonesEngine::step() {
+    const size_t count = m_posX.size();
+    if (count == 0) return;
+
+    if (!m_listValid) {
+        buildNeighborList();
+        computeForces();
+    }
+
+    // Velocity Verlet: half kick and drift
+    const float halfKick = 0.5f * m_timeStep / m_mass;
+    const float dt = m_timeStep;
+    float* posX = m_posX.data();
+    float* posY = m_posY.data();
+    float* velX = m_velX.data();
+    float* velY = m_velY.data();
+    const float* forceX = m_forceX.data();
+    const float* forceY = m_forceY.data();
+    for (size_t i = 0; i < count; ++i) {
+        velX[i] += halfKick * forceX[i];
+        velY[i] += halfKick * forceY[i];
+        posX[i] += dt * velX[i];
+        posY[i] += dt * velY[i];
+    }
+
+    if (needsRebuild()) {
+        buildNeighborList();
+    }
+    computeForces();
+
+    // Second half kick (a rebuild reorders the arrays, so fetch them again)
+    velX = m_velX.data();
+    velY = m_velY.data();
+    for (size_t i = 0; i < count; ++i) {
+        velX[i] += halfKick * forceX[i];
+        velY[i] += halfKick * forceY[i];
+    }
+}
+
+double LennardJonesEngine::getKineticEnergy() const {
+    double sum = 0.0;
+    for (size_t i = 0; i < m_velX.size(); ++i) {
+        sum += static_cast<double>(m_velX[i]) * m_velX[i] + static_cast<double>(m_velY[i]) * m_velY[i];
+    }
+    return 0.5 * m_mass * sum;
+}
+
+void LennardJonesEngine::getPosition(size_t index, float& x, float& y) const {
+    size_t slot = m_slotOfId[index];
+    x = m_posX[slot];
+    y = m_posY[slot];
+}
+
+bool LennardJonesEngine::needsRebuild() const {
+    // Lists stay exact while no particle has moved more than half the skin
+    const float limitSq = 0.25f * m_skin * m_skin;
+    float maxSq = 0.0f;
+    for (size_t i = 0; i < m_posX.size(); ++i) {
+        float dx = m_posX[i] - m_refX[i];
+        float dy = m_posY[i] - m_refY[i];
+        maxSq = std::max(maxSq, dx * dx + dy * dy);
+    }
+    return maxSq > limitSq;
+}
+
+void LennardJonesEngine::buildNeighborList() {
+    PROFILE_SCOPE(m_profiler, "lj_neighbor_list");
+    const size_t count = m_posX.size();
+
+    // Wrap into the box; positions drift freely between builds
+    for (size_t i = 0; i < count; ++i) {
+        m_posX[i] -= m_width * std::floor((m_posX[i] - m_minX) / m_width);
+        m_posY[i] -= m_height * std::floor((m_posY[i] - m_minY) / m_height);
+    }
+
+    // Cells tile the box exactly, so the periodic seam needs no special case
+    const float listRange = m_cutoff + m_skin;
+    m_cellsX = std::max(1, static_cast<int>(m_width / listRange));
+    m_cellsY = std::max(1, static_cast<int>(m_height / listRange));
+    sortByCell();
+
+    m_refX = m_posX;
+    m_refY = m_posY;
+    m_forceX.resize(count);
+    m_forceY.resize(count);
+    m_neighborCounts.resize(count);
+
+    const float listRangeSq = listRange * listRange;
+    const float width = m_width, height = m_height;
+    const float invWidth = 1.0f / width, invHeight = 1.0f / height;
+    const int cellsX = m_cellsX, cellsY = m_cellsY;
+
+    // Fixed stride per particle; grow and retry if any particle overflows
+    while (true) {
+        m_neighbors.resize(count * m_maxNeighbors);
+        std::atomic<bool> overflow(false);
+
+        m_threadPool->parallelFor(0, count, [&](size_t begin, size_t end, size_t) {
+            for (size_t i = begin; i < end; ++i) {
+                const int cell = static_cast<int>(m_cellKeys[i]);
+                const int cellX = cell % cellsX;
+                const int cellY = cell / cellsX;
+
+                // Distinct neighbor cells (small boxes wrap onto the same cell)
+                int cells[9];
+                int cellCount = 0;
+                for (int oy = -1; oy <= 1; ++oy) {
+                    for (int ox = -1; ox <= 1; ++ox) {
+                        int c = ((cellY + oy + cellsY) % cellsY) * cellsX + (cellX + ox + cellsX) % cellsX;
+                        if (std::find(cells, cells + cellCount, c) == cells + cellCount) cells[cellCount++] = c;
+                    }
+                }
+
+                uint32_t* list = &m_neighbors[i * m_maxNeighbors];
+                size_t listSize = 0;
+                const float xi = m_posX[i], yi = m_posY[i];
+                for (int c = 0; c < cellCount; ++c) {
+                    // Half list: only partners stored after i
+                    uint32_t j = std::max(m_cellOffsets[cells[c]], static_cast<uint32_t>(i + 1));
+                    uint32_t jEnd = m_cellOffsets[cells[c] + 1];
+                    for (; j < jEnd; ++j) {
+                        float dx = xi - m_posX[j];
+                        float dy = yi - m_posY[j];
+                        dx -= width * std::floor(dx * invWidth + 0.5f);
+                        dy -= height * std::floor(dy * invHeight + 0.5f);
+                        if (dx * dx + dy * dy < listRangeSq) {
+                            if (listSize < m_maxNeighbors) list[listSize] = j;
+                            listSize++;
+                        }
+                    }
+                }
+                if (listSize > m_maxNeighbors) overflow = true;
+                m_neighborCounts[i] = static_cast<uint32_t>(std::min(listSize, m_maxNeighbors));
+            }
+        }, MIN_PARTICLES_PER_THREAD);
+
+        if (!overflow) break;
+        m_maxNeighbors *= 2;
+    }
+
+    m_neighborPairCount = 0;
+    for (size_t i = 0; i < count; ++i) {
+        m_neighborPairCount += m_neighborCounts[i];
+    }
+    m_listValid = true;
+    m_buildCount++;
+}
+
+void LennardJonesEngine::sortByCell() {
+    const size_t count = m_posX.size();
+    const size_t cellCount = static_cast<size_t>(m_cellsX) * m_cellsY;
+    const float cellWidth = m_width / m_cellsX;
+    const float cellHeight = m_height / m_cellsY;
+
+    // Counting sort of slots by cell (stable)
+    m_cellKeys.resize(count);
+    m_cellOffsets.assign(cellCount + 1, 0);
+    for (size_t i = 0; i < count; ++i) {
+        int cellX = std::min(static_cast<int>((m_posX[i] - m_minX) / cellWidth), m_cellsX - 1);
+        int cellY = std::min(static_cast<int>((m_posY[i] - m_minY) / cellHeight), m_cellsY - 1);
+        m_cellKeys[i] = static_cast<uint32_t>(std::max(cellY, 0) * m_cellsX + std::max(cellX, 0));
+        m_cellOffsets[m_cellKeys[i] + 1]++;
+    }
+    for (size_t c = 0; c < cellCount; ++c) {
+        m_cellOffsets[c + 1] += m_cellOffsets[c];
+    }
+    m_order.resize(count);
+    m_reorderIdScratch.assign(m_cellOffsets.begin(), m_cellOffsets.end() - 1); // write cursors
+    for (size_t i = 0; i < count; ++i) {
+        m_order[m_reorderIdScratch[m_cellKeys[i]]++] = static_cast<uint32_t>(i);
+    }
+
+    // Permute every per-particle array into cell order
+    auto permute = [&](std::vector<float>& values) {
+        m_reorderScratch.resize(count);
+        for (size_t k = 0; k < count; ++k) m_reorderScratch[k] = values[m_order[k]];
+        values.swap(m_reorderScratch);
+    };
+    permute(m_posX);
+    permute(m_posY);
+    permute(m_velX);
+    permute(m_velY);
+
+    m_reorderIdScratch.resize(count);
+    for (size_t k = 0; k < count; ++k) m_reorderIdScratch[k] = m_ids[m_order[k]];
+    m_ids.swap(m_reorderIdScratch);
+
+    for (size_t c = 0; c < cellCount; ++c) {
+        std::fill(m_cellKeys.begin() + m_cellOffsets[c], m_cellKeys.begin() + m_cellOffsets[c + 1], static_cast<uint32_t>(c));
+    }
+
+    m_slotOfId.resize(count);
+    for (size_t k = 0; k < count; ++k) m_slotOfId[m_ids[k]] = static_cast<uint32_t>(k);
+}
+
+void LennardJonesEngine::ensureThreadBuffers() {
+    const size_t threads = m_threadPool->getThreadCount();
+    const size_t count = m_posX.size();
+    // Buffers are kept zeroed by the reduction, so only new storage is cleared here
+    if (m_threadForceX.size() != threads * count) {
+        m_threadForceX.assign(threads * count, 0.0f);
+        m_threadForceY.assign(threads * count, 0.0f);
+    }
+    m_threadPairScratch.resize(threads * 3 * m_maxNeighbors);
+    m_threadEnergy.assign(threads, 0.0);
+    m_threadInteractions.assign(threads, 0);
+}
+
+void LennardJonesEngine::computeForces() {
+    PROFILE_SCOPE(m_profiler, "lj_forces");
+    const size_t count = m_posX.size();
+    ensureThreadBuffers();
+
+    PairConstants constants;
+    constants.cutoffSq = m_cutoff * m_cutoff;
+    constants.sigmaSq = m_sigma * m_sigma;
+    constants.forceScale = 24.0f * m_epsilon;
+    constants.energyScale = 4.0f * m_epsilon;
+    const float cutoffS6 = std::pow(constants.sigmaSq / constants.cutoffSq, 3.0f);
+    constants.energyShift = constants.energyScale * cutoffS6 * (cutoffS6 - 1.0f);
+    constants.width = m_width;
+    constants.height = m_height;
+    constants.halfWidth = 0.5f * m_width;
+    constants.halfHeight = 0.5f * m_height;
+    const size_t stride = m_maxNeighbors;
+
+    m_threadPool->parallelFor(0, count, [&](size_t begin, size_t end, size_t threadIndex) {
+        float* fx = &m_threadForceX[threadIndex * count];
+        float* fy = &m_threadForceY[threadIndex * count];
+        float* pairFx = &m_threadPairScratch[threadIndex * 3 * stride];
+        float* pairFy = pairFx + stride;
+        float* pairEnergy = pairFy + stride;
+        double energy = 0.0;
+        size_t interactions = 0;
+
+        for (size_t i = begin; i < end; ++i) {
+            const uint32_t* list = &m_neighbors[i * stride];
+            const uint32_t listSize = m_neighborCounts[i];
+            interactions += computePairForces(list, listSize, m_posX[i], m_posY[i], m_posX.data(), m_posY.data(),
+                                              constants, pairFx, pairFy, pairEnergy);
+
+            // Accumulate on i and scatter the reactions (Newton's third law) into this thread's buffer
+            float fxi = 0.0f, fyi = 0.0f, energyI = 0.0f;
+            for (uint32_t k = 0; k < listSize; ++k) {
+                fxi += pairFx[k];
+                fyi += pairFy[k];
+                energyI += pairEnergy[k];
+                fx[list[k]] -= pairFx[k];
+                fy[list[k]] -= pairFy[k];
+            }
+            fx[i] += fxi;
+            fy[i] += fyi;
+            energy += energyI;
+        }
+        m_threadEnergy[threadIndex] += energy;
+        m_threadInteractions[threadIndex] += interactions;
+    }, MIN_PARTICLES_PER_THREAD);
+
+    // Sum the per-thread buffers and leave them zeroed for the next step
+    const size_t threads = m_threadPool->getThreadCount();
+    m_threadPool->parallelFor(0, count, [&](size_t begin, size_t end, size_t) {
+        for (size_t i = begin; i < end; ++i) {
+            float sumX = 0.0f, sumY = 0.0f;
+            for (size_t t = 0; t < threads; ++t) {
+                sumX += m_threadForceX[t * count + i];
+                sumY += m_threadForceY[t * count + i];
+                m_threadForceX[t * count + i] = 0.0f;
+                m_threadForceY[t * count + i] = 0.0f;
+            }
+            m_forceX[i] = sumX;
+            m_forceY[i] = sumY;
+        }
+    }, MIN_PARTICLES_PER_THREAD);
+
+    m_potentialEnergy = 0.0;
+    m_interactionCount = 0;
+    for (size_t t = 0; t < threads; ++t) {
+        m_potentialEnergy += m_threadEnergy[t];
+        m_interactionCount += m_threadInteractions[t];
+    }
+}
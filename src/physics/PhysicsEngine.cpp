@@ -2,67 +2,470 @@
 #include <algorithm>
 #include <cmath>
 
-PhysicsEngine::PhysicsEngine() 
-    : m_gravity(glm::vec2(0.0f, -9.81f))
+template <typename Precision>
+BasicPhysicsEngine<Precision>::BasicPhysicsEngine()
+    : m_gravity(Vector(0.0f, -9.81f))
     , m_airResistance(0.01f)
-    , m_collisionDamping(0.8f) {
+    , m_collisionDamping(0.8f)
+    , m_broadPhase(BroadPhase::BruteForce)
+    , m_obstacles(nullptr)
+    , m_profiler(nullptr)
+    , m_countersEnabled(false)
+    , m_lastContactCount(0)
+    , m_lastPairTestCount(0)
+    , m_lastFilteredPairCount(0)
+    , m_contactLog(nullptr)
+    , m_candidateLog(nullptr)
+    , m_cellSize(1.0f)
+    , m_filterPairs(false) {
 }
 
-void PhysicsEngine::applyGravity(ParticleSystem& system, const glm::vec2& gravity) {
+template <typename Precision>
+bool BasicPhysicsEngine<Precision>::enableHardwareCounters() {
+    m_countersEnabled = m_counters.open();
+    return m_countersEnabled;
+}
+
+template <typename Precision>
+void BasicPhysicsEngine<Precision>::applyGravity(SystemType& system, const Vector& gravity) {
     // Access particles through the non-const method
     for (auto& particle : system.getParticles()) {
-        glm::vec2 gravityForce = gravity * particle.mass;
+        Vector gravityForce = gravity * particle.mass;
         particle.applyForce(gravityForce);
     }
 }
 
-void PhysicsEngine::applyAirResistance(ParticleSystem& system, float resistance) {
+template <typename Precision>
+void BasicPhysicsEngine<Precision>::applyAirResistance(SystemType& system, ScalarType resistance) {
     for (auto& particle : system.getParticles()) {
         // Air resistance opposes velocity: F = -k * v^2 * direction
-        float speed = glm::length(particle.velocity);
+        ScalarType speed = glm::length(particle.velocity);
         if (speed > 0.0f) {
-            glm::vec2 dragDirection = -glm::normalize(particle.velocity);
-            glm::vec2 dragForce = dragDirection * resistance * speed * speed;
+            Vector dragDirection = -glm::normalize(particle.velocity);
+            Vector dragForce = dragDirection * resistance * speed * speed;
             particle.applyForce(dragForce);
         }
     }
 }
 
-void PhysicsEngine::handleCollisions(ParticleSystem& system, float damping) {
+template <typename Precision>
+void BasicPhysicsEngine<Precision>::handleCollisions(SystemType& system, ScalarType damping) {
+    PROFILE_SCOPE(m_profiler, "collisions");
+    m_lastContactCount = 0;
+    m_lastPairTestCount = 0;
+    m_lastFilteredPairCount = 0;
+    if (m_contactLog) m_contactLog->clear();
+    if (m_candidateLog) m_candidateLog->clear();
+    if (system.hasCollisionFilters()) system.syncCollisionFilters();
+
+    if (m_broadPhase == BroadPhase::CellList) {
+        handleCollisionsGrid(system, damping);
+    } else {
+        handleCollisionsBruteForce(system, damping);
+    }
+    // Filtered candidates never reach the distance test
+    m_lastPairTestCount -= m_lastFilteredPairCount;
+}
+
+template <typename Precision>
+void BasicPhysicsEngine<Precision>::handleCollisionsBruteForce(SystemType& system, ScalarType damping) {
     auto& particles = system.getParticles();
-    
+    m_lastPairTestCount = particles.size() * (particles.size() - std::min<size_t>(particles.size(), 1)) / 2;
+    const bool filtered = system.hasCollisionFilters();
+    const auto& groups = system.getCollisionGroups();
+    const auto& masks = system.getCollisionMasks();
+
+    // Candidates are collected before the resolving loop starts moving particles
+    if (m_candidateLog) {
+        for (size_t i = 0; i < particles.size(); ++i) {
+            for (size_t j = i + 1; j < particles.size(); ++j) {
+                if (filtered && !canCollide(groups[i], masks[i], groups[j], masks[j])) continue;
+                if (checkCollision(particles[i], particles[j])) {
+                    m_candidateLog->emplace_back(static_cast<uint32_t>(i), static_cast<uint32_t>(j));
+                }
+            }
+        }
+    }
+
     for (size_t i = 0; i < particles.size(); ++i) {
         for (size_t j = i + 1; j < particles.size(); ++j) {
+            if (filtered && !canCollide(groups[i], masks[i], groups[j], masks[j])) {
+                m_lastFilteredPairCount++;
+                continue;
+            }
             if (checkCollision(particles[i], particles[j])) {
                 resolveCollision(particles[i], particles[j], damping);
+                m_lastContactCount++;
+                if (m_contactLog) m_contactLog->emplace_back(static_cast<uint32_t>(i), static_cast<uint32_t>(j));
+            }
+        }
+    }
+}
+
+template <typename Precision>
+void BasicPhysicsEngine<Precision>::handleCollisionsGrid(SystemType& system, ScalarType damping) {
+    auto& particles = system.getParticles();
+
+    // With filters, particles split three ways:
+    //  - group or mask zero: collide with nothing, skipped entirely;
+    //  - members: binned in the grid. These are particles whose mask admits their
+    //    own group, plus any whose mask admits the group of another non-member;
+    //  - queries: everything else. No query can collide with another query, so
+    //    queries are not binned. Each one only looks up its 3x3 cells in the grid.
+    // A population that skips itself (tracers) costs one lookup per particle
+    // and never enumerates its internal pairs.
+    m_filterPairs = system.hasCollisionFilters();
+    const auto& groups = system.getCollisionGroups();
+    const auto& masks = system.getCollisionMasks();
+    m_queries.clear();
+    if (m_filterPairs) {
+        uint32_t crossGroups = 0; // groups of particles that do not collide with their own group
+        for (size_t i = 0; i < particles.size(); ++i) {
+            if (groups[i] != 0 && masks[i] != 0 && (groups[i] & masks[i]) == 0) {
+                crossGroups |= groups[i];
+            }
+        }
+        m_members.clear();
+        for (size_t i = 0; i < particles.size(); ++i) {
+            if (groups[i] == 0 || masks[i] == 0) continue;
+            if ((groups[i] & masks[i]) != 0 || (masks[i] & crossGroups) != 0) {
+                m_members.push_back(static_cast<uint32_t>(i));
+            } else {
+                m_queries.push_back(static_cast<uint32_t>(i));
+            }
+        }
+    }
+    const size_t count = m_filterPairs ? m_members.size() : particles.size();
+    const size_t queryCount = m_queries.size();
+    if (count == 0 || count + queryCount < 2) return;
+    auto particleAt = [&](size_t slot) -> uint32_t {
+        return m_filterPairs ? m_members[slot] : static_cast<uint32_t>(slot);
+    };
+
+    // Broad phase: bin particles into cells no smaller than the largest diameter.
+    // Binning is done in float relative to the first particle, which keeps it
+    // accurate for a compact cloud whatever its distance from (0, 0).
+    const Position reference = particles[particleAt(0)].position;
+    {
+        PROFILE_SCOPE(m_profiler, "collision_grid_build");
+        m_posX.resize(count);
+        m_posY.resize(count);
+        ScalarType maxRadius = 0.0f;
+        for (size_t i = 0; i < count; ++i) {
+            const ParticleType& p = particles[particleAt(i)];
+            m_posX[i] = static_cast<float>(p.position.x - reference.x);
+            m_posY[i] = static_cast<float>(p.position.y - reference.y);
+            maxRadius = std::max(maxRadius, p.radius);
+        }
+        for (uint32_t index : m_queries) {
+            maxRadius = std::max(maxRadius, particles[index].radius);
+        }
+        // Queries look up the grid too, so it gets the resolution of a grid over everyone
+        m_grid.build(m_posX.data(), m_posY.data(), count, static_cast<float>(2.0f * maxRadius), count + queryCount);
+    }
+
+    // Gather into cell order so each cell (and each run of cells in a row) is contiguous.
+    // Positions become offsets from the particle's own cell origin.
+    const auto& sorted = m_grid.getSortedIndices();
+    const auto& cellKeys = m_grid.getCellKeys();
+    const int cellsX = m_grid.getCellsX();
+    const int cellsY = m_grid.getCellsY();
+    const PositionType originX = reference.x + m_grid.getOriginX();
+    const PositionType originY = reference.y + m_grid.getOriginY();
+    const PositionType cellSize = m_grid.getCellSize();
+    m_cellSize = static_cast<ScalarType>(cellSize);
+
+    // Query particles follow the members in slots [count, total); their cell
+    // may lie just outside the grid
+    const size_t total = count + queryCount;
+    m_sortedPosX.resize(total);
+    m_sortedPosY.resize(total);
+    m_gatheredPosX.resize(total);
+    m_gatheredPosY.resize(total);
+    m_sortedVelX.resize(total);
+    m_sortedVelY.resize(total);
+    m_sortedRadius.resize(total);
+    m_sortedInvMass.resize(total);
+    m_sortedCellX.resize(total);
+    m_sortedCellY.resize(total);
+    m_sortedParticle.resize(total);
+    for (size_t k = 0; k < total; ++k) {
+        int32_t cellX, cellY;
+        if (k < count) {
+            m_sortedParticle[k] = particleAt(sorted[k]);
+            cellX = static_cast<int32_t>(cellKeys[sorted[k]] % cellsX);
+            cellY = static_cast<int32_t>(cellKeys[sorted[k]] / cellsX);
+        } else {
+            m_sortedParticle[k] = m_queries[k - count];
+            const Position& position = particles[m_sortedParticle[k]].position;
+            cellX = static_cast<int32_t>(std::max(PositionType(-2), std::min(PositionType(cellsX + 1),
+                        std::floor((position.x - originX) / cellSize))));
+            cellY = static_cast<int32_t>(std::max(PositionType(-2), std::min(PositionType(cellsY + 1),
+                        std::floor((position.y - originY) / cellSize))));
+        }
+        const ParticleType& p = particles[m_sortedParticle[k]];
+        m_sortedCellX[k] = cellX;
+        m_sortedCellY[k] = cellY;
+        m_sortedPosX[k] = m_gatheredPosX[k] = static_cast<ScalarType>(p.position.x - (originX + cellX * cellSize));
+        m_sortedPosY[k] = m_gatheredPosY[k] = static_cast<ScalarType>(p.position.y - (originY + cellY * cellSize));
+        m_sortedVelX[k] = p.velocity.x;
+        m_sortedVelY[k] = p.velocity.y;
+        m_sortedRadius[k] = p.radius;
+        m_sortedInvMass[k] = ScalarType(1) / p.mass;
+    }
+    if (m_filterPairs) {
+        m_sortedGroup.resize(total);
+        m_sortedMask.resize(total);
+        for (size_t k = 0; k < total; ++k) {
+            m_sortedGroup[k] = groups[m_sortedParticle[k]];
+            m_sortedMask[k] = masks[m_sortedParticle[k]];
+        }
+    }
+
+    // Narrow phase over L1-sized tiles of consecutive cells, prefetching the next tile
+    {
+        PROFILE_SCOPE(m_profiler, "collision_narrow_phase");
+        if (m_countersEnabled) m_counters.start();
+
+        const size_t tileCapacity = L1_TILE_BYTES / BYTES_PER_PARTICLE;
+
+        // Working set of a tile: its own row span plus the row above (half-shell stencil)
+        auto tileWorkingSet = [&](int row, int firstCell, int lastCell, uint32_t spans[4]) {
+            int right = std::min(lastCell + 1, cellsX - 1);
+            spans[0] = m_grid.cellStart(m_grid.cellIndex(firstCell, row));
+            spans[1] = m_grid.cellEnd(m_grid.cellIndex(right, row));
+            spans[2] = spans[3] = 0;
+            if (row + 1 < cellsY) {
+                spans[2] = m_grid.cellStart(m_grid.cellIndex(std::max(firstCell - 1, 0), row + 1));
+                spans[3] = m_grid.cellEnd(m_grid.cellIndex(right, row + 1));
+            }
+            return static_cast<size_t>(spans[1] - spans[0]) + (spans[3] - spans[2]);
+        };
+        auto tileEnd = [&](int row, int firstCell) {
+            uint32_t spans[4];
+            int lastCell = firstCell;
+            while (lastCell + 1 < cellsX && tileWorkingSet(row, firstCell, lastCell + 1, spans) <= tileCapacity) {
+                lastCell++;
             }
+            return lastCell;
+        };
+
+        int row = 0;
+        int firstCell = 0;
+        int lastCell = tileEnd(row, firstCell);
+        while (row < cellsY) {
+            // Locate and prefetch the next tile before working on this one
+            int nextRow = row;
+            int nextFirst = lastCell + 1;
+            if (nextFirst >= cellsX) {
+                nextRow++;
+                nextFirst = 0;
+            }
+            int nextLast = 0;
+            if (nextRow < cellsY) {
+                nextLast = tileEnd(nextRow, nextFirst);
+                uint32_t spans[4];
+                tileWorkingSet(nextRow, nextFirst, nextLast, spans);
+                prefetchRange(spans[0], spans[1]);
+                prefetchRange(spans[2], spans[3]);
+            }
+
+            processTile(row, firstCell, lastCell, damping);
+
+            row = nextRow;
+            firstCell = nextFirst;
+            lastCell = nextLast;
+        }
+
+        // Each query against the members in its 3x3 cells (three contiguous row spans)
+        for (size_t q = count; q < total; ++q) {
+            int firstX = std::max(m_sortedCellX[q] - 1, 0);
+            int lastX = std::min(m_sortedCellX[q] + 1, cellsX - 1);
+            int firstY = std::max(m_sortedCellY[q] - 1, 0);
+            int lastY = std::min(m_sortedCellY[q] + 1, cellsY - 1);
+            for (int cellY = firstY; cellY <= lastY && firstX <= lastX; ++cellY) {
+                uint32_t begin = m_grid.cellStart(m_grid.cellIndex(firstX, cellY));
+                uint32_t end = m_grid.cellEnd(m_grid.cellIndex(lastX, cellY));
+                m_lastPairTestCount += end - begin;
+                for (uint32_t b = begin; b < end; ++b) {
+                    resolveSortedPair(static_cast<uint32_t>(q), b, damping);
+                }
+            }
+        }
+
+        if (m_countersEnabled && m_profiler) {
+            m_profiler->recordCacheCounters("collision_narrow_phase", m_counters.stop());
+        }
+    }
+
+    // Scatter results back; positions receive only the separation delta, so
+    // their full storage precision is kept
+    for (size_t k = 0; k < total; ++k) {
+        ParticleType& p = particles[m_sortedParticle[k]];
+        p.position.x += static_cast<PositionType>(m_sortedPosX[k] - m_gatheredPosX[k]);
+        p.position.y += static_cast<PositionType>(m_sortedPosY[k] - m_gatheredPosY[k]);
+        p.velocity = Vector(m_sortedVelX[k], m_sortedVelY[k]);
+    }
+}
+
+template <typename Precision>
+void BasicPhysicsEngine<Precision>::processTile(int row, int firstCell, int lastCell, ScalarType damping) {
+    const int cellsX = m_grid.getCellsX();
+    const bool hasRowAbove = row + 1 < m_grid.getCellsY();
+
+    for (int cellX = firstCell; cellX <= lastCell; ++cellX) {
+        int cell = m_grid.cellIndex(cellX, row);
+        uint32_t begin = m_grid.cellStart(cell);
+        uint32_t end = m_grid.cellEnd(cell);
+        if (begin == end) continue;
+
+        // Half-shell stencil: self, east, and the three cells above (NW, N, NE).
+        // The remaining neighbours see this cell through their own half shell.
+        processPairsSelf(begin, end, damping);
+        if (cellX + 1 < cellsX) {
+            int east = m_grid.cellIndex(cellX + 1, row);
+            processPairsCross(begin, end, m_grid.cellStart(east), m_grid.cellEnd(east), damping);
+        }
+        if (hasRowAbove) {
+            // NW, N and NE are consecutive cells, so they form one contiguous span
+            int aboveLeft = m_grid.cellIndex(std::max(cellX - 1, 0), row + 1);
+            int aboveRight = m_grid.cellIndex(std::min(cellX + 1, cellsX - 1), row + 1);
+            processPairsCross(begin, end, m_grid.cellStart(aboveLeft), m_grid.cellEnd(aboveRight), damping);
+        }
+    }
+}
+
+template <typename Precision>
+void BasicPhysicsEngine<Precision>::processPairsSelf(uint32_t begin, uint32_t end, ScalarType damping) {
+    m_lastPairTestCount += static_cast<size_t>(end - begin) * (end - begin - 1) / 2;
+    for (uint32_t a = begin; a < end; ++a) {
+        for (uint32_t b = a + 1; b < end; ++b) {
+            resolveSortedPair(a, b, damping);
+        }
+    }
+}
+
+template <typename Precision>
+void BasicPhysicsEngine<Precision>::processPairsCross(uint32_t beginA, uint32_t endA, uint32_t beginB, uint32_t endB, ScalarType damping) {
+    m_lastPairTestCount += static_cast<size_t>(endA - beginA) * (endB - beginB);
+    for (uint32_t a = beginA; a < endA; ++a) {
+        for (uint32_t b = beginB; b < endB; ++b) {
+            resolveSortedPair(a, b, damping);
+        }
+    }
+}
+
+template <typename Precision>
+void BasicPhysicsEngine<Precision>::resolveSortedPair(uint32_t a, uint32_t b, ScalarType damping) {
+    // Same response as resolveCollision, on the cell-ordered SoA copies.
+    // Neighbouring cells differ by at most one cell per axis.
+    if (m_filterPairs && !canCollide(m_sortedGroup[a], m_sortedMask[a], m_sortedGroup[b], m_sortedMask[b])) {
+        m_lastFilteredPairCount++;
+        return;
+    }
+    ScalarType radiusSum = m_sortedRadius[a] + m_sortedRadius[b];
+    if (m_candidateLog) {
+        // Overlap at the gathered (pre-resolution) positions
+        ScalarType startX = (m_gatheredPosX[b] - m_gatheredPosX[a]) + static_cast<ScalarType>(m_sortedCellX[b] - m_sortedCellX[a]) * m_cellSize;
+        ScalarType startY = (m_gatheredPosY[b] - m_gatheredPosY[a]) + static_cast<ScalarType>(m_sortedCellY[b] - m_sortedCellY[a]) * m_cellSize;
+        if (startX * startX + startY * startY < radiusSum * radiusSum) {
+            uint32_t i = m_sortedParticle[a];
+            uint32_t j = m_sortedParticle[b];
+            m_candidateLog->emplace_back(std::min(i, j), std::max(i, j));
+        }
+    }
+    ScalarType dx = (m_sortedPosX[b] - m_sortedPosX[a]) + static_cast<ScalarType>(m_sortedCellX[b] - m_sortedCellX[a]) * m_cellSize;
+    ScalarType dy = (m_sortedPosY[b] - m_sortedPosY[a]) + static_cast<ScalarType>(m_sortedCellY[b] - m_sortedCellY[a]) * m_cellSize;
+    ScalarType distanceSq = dx * dx + dy * dy;
+
+    // Squared test first so separated pairs never pay for the square root
+    if (distanceSq >= radiusSum * radiusSum || distanceSq == ScalarType(0)) return;
+    m_lastContactCount++;
+    if (m_contactLog) {
+        uint32_t i = m_sortedParticle[a];
+        uint32_t j = m_sortedParticle[b];
+        m_contactLog->emplace_back(std::min(i, j), std::max(i, j));
+    }
+
+    ScalarType distance = std::sqrt(distanceSq);
+    ScalarType nx = dx / distance;
+    ScalarType ny = dy / distance;
+
+    // Separate overlapping particles
+    ScalarType separation = (radiusSum - distance) * ScalarType(0.5);
+    m_sortedPosX[a] -= nx * separation;
+    m_sortedPosY[a] -= ny * separation;
+    m_sortedPosX[b] += nx * separation;
+    m_sortedPosY[b] += ny * separation;
+
+    // Don't resolve if velocities are separating
+    ScalarType velAlongNormal = (m_sortedVelX[b] - m_sortedVelX[a]) * nx + (m_sortedVelY[b] - m_sortedVelY[a]) * ny;
+    if (velAlongNormal > 0) return;
+
+    ScalarType j = -(1 + damping) * velAlongNormal;
+    j /= m_sortedInvMass[a] + m_sortedInvMass[b];
+
+    m_sortedVelX[a] -= j * nx * m_sortedInvMass[a];
+    m_sortedVelY[a] -= j * ny * m_sortedInvMass[a];
+    m_sortedVelX[b] += j * nx * m_sortedInvMass[b];
+    m_sortedVelY[b] += j * ny * m_sortedInvMass[b];
+}
+
+template <typename Precision>
+void BasicPhysicsEngine<Precision>::prefetchRange(uint32_t begin, uint32_t end) const {
+#if defined(__GNUC__) || defined(__clang__)
+    const uint32_t valuesPerLine = 64 / sizeof(ScalarType);
+    for (uint32_t k = begin; k < end; k += valuesPerLine) {
+        __builtin_prefetch(&m_sortedPosX[k], 1);
+        __builtin_prefetch(&m_sortedPosY[k], 1);
+        __builtin_prefetch(&m_sortedVelX[k], 1);
+        __builtin_prefetch(&m_sortedVelY[k], 1);
+        __builtin_prefetch(&m_sortedRadius[k], 0);
+        __builtin_prefetch(&m_sortedInvMass[k], 0);
+        if (m_filterPairs) {
+            __builtin_prefetch(&m_sortedGroup[k], 0);
+            __builtin_prefetch(&m_sortedMask[k], 0);
         }
     }
+#else
+    (void)begin;
+    (void)end;
+#endif
 }
 
-void PhysicsEngine::integrateParticles(ParticleSystem& system, float deltaTime) {
+template <typename Precision>
+void BasicPhysicsEngine<Precision>::integrateParticles(SystemType& system, ScalarType deltaTime) {
     // Apply global forces first
     applyGravity(system, m_gravity);
     applyAirResistance(system, m_airResistance);
-    
+
     // Handle collisions
     handleCollisions(system, m_collisionDamping);
-    
+
+    // Move scripted obstacles and push particles out of them
+    if (m_obstacles) {
+        m_obstacles->advance(static_cast<float>(deltaTime));
+        m_obstacles->collide(system, m_collisionDamping);
+    }
+
     // Update particle physics
     system.update(deltaTime);
 }
 
-void PhysicsEngine::applyForceToParticle(Particle& particle, const glm::vec2& force) {
+template <typename Precision>
+void BasicPhysicsEngine<Precision>::applyForceToParticle(ParticleType& particle, const Vector& force) {
     particle.applyForce(force);
 }
 
-void PhysicsEngine::applyGlobalForce(ParticleSystem& system, const glm::vec2& force) {
+template <typename Precision>
+void BasicPhysicsEngine<Precision>::applyGlobalForce(SystemType& system, const Vector& force) {
     for (auto& particle : system.getParticles()) {
         particle.applyForce(force);
     }
 }
 
-void PhysicsEngine::applyBoundaryConstraints(ParticleSystem& system, const glm::vec2& minBounds, const glm::vec2& maxBounds) {
+template <typename Precision>
+void BasicPhysicsEngine<Precision>::applyBoundaryConstraints(SystemType& system, const Position& minBounds, const Position& maxBounds) {
     for (auto& particle : system.getParticles()) {
         // Check X boundaries
         if (particle.position.x - particle.radius < minBounds.x) {
@@ -73,7 +476,7 @@ void PhysicsEngine::applyBoundaryConstraints(ParticleSystem& system, const glm::
             particle.position.x = maxBounds.x - particle.radius;
             particle.velocity.x = -particle.velocity.x * m_collisionDamping;
         }
-        
+
         // Check Y boundaries
         if (particle.position.y - particle.radius < minBounds.y) {
             particle.position.y = minBounds.y + particle.radius;
@@ -86,46 +489,59 @@ void PhysicsEngine::applyBoundaryConstraints(ParticleSystem& system, const glm::
     }
 }
 
-bool PhysicsEngine::checkCollision(const Particle& p1, const Particle& p2) {
-    float distance = calculateDistance(p1, p2);
+template <typename Precision>
+void BasicPhysicsEngine<Precision>::applyBoundaryConstraints(SystemType& system, const SignedDistanceField& field) {
+    field.collide(system, m_collisionDamping);
+}
+
+template <typename Precision>
+bool BasicPhysicsEngine<Precision>::checkCollision(const ParticleType& p1, const ParticleType& p2) {
+    ScalarType distance = calculateDistance(p1, p2);
     return distance < (p1.radius + p2.radius);
 }
 
-void PhysicsEngine::resolveCollision(Particle& p1, Particle& p2, float damping) {
-    // Calculate collision normal
-    glm::vec2 collisionNormal = p2.position - p1.position;
-    float distance = glm::length(collisionNormal);
-    
-    if (distance == 0.0f) return; // Avoid division by zero
-    
+template <typename Precision>
+void BasicPhysicsEngine<Precision>::resolveCollision(ParticleType& p1, ParticleType& p2, ScalarType damping) {
+    // Calculate collision normal (the difference is small, so Scalar precision is enough)
+    Vector collisionNormal = Vector(p2.position - p1.position);
+    ScalarType distance = glm::length(collisionNormal);
+
+    if (distance == ScalarType(0)) return; // Avoid division by zero
+
     collisionNormal = glm::normalize(collisionNormal);
-    
+
     // Separate overlapping particles
-    float overlap = (p1.radius + p2.radius) - distance;
-    float separation = overlap * 0.5f;
-    p1.position -= collisionNormal * separation;
-    p2.position += collisionNormal * separation;
-    
+    ScalarType overlap = (p1.radius + p2.radius) - distance;
+    ScalarType separation = overlap * ScalarType(0.5);
+    p1.position -= Position(collisionNormal * separation);
+    p2.position += Position(collisionNormal * separation);
+
     // Calculate relative velocity
-    glm::vec2 relativeVelocity = p2.velocity - p1.velocity;
-    float velAlongNormal = glm::dot(relativeVelocity, collisionNormal);
-    
+    Vector relativeVelocity = p2.velocity - p1.velocity;
+    ScalarType velAlongNormal = glm::dot(relativeVelocity, collisionNormal);
+
     // Don't resolve if velocities are separating
     if (velAlongNormal > 0) return;
-    
+
     // Calculate restitution (bounciness)
-    float restitution = damping;
-    
+    ScalarType restitution = damping;
+
     // Calculate impulse scalar
-    float j = -(1 + restitution) * velAlongNormal;
-    j /= (1.0f / p1.mass) + (1.0f / p2.mass);
-    
+    ScalarType j = -(1 + restitution) * velAlongNormal;
+    j /= (ScalarType(1) / p1.mass) + (ScalarType(1) / p2.mass);
+
     // Apply impulse
-    glm::vec2 impulse = j * collisionNormal;
+    Vector impulse = j * collisionNormal;
     p1.velocity -= impulse / p1.mass;
     p2.velocity += impulse / p2.mass;
 }
 
-float PhysicsEngine::calculateDistance(const Particle& p1, const Particle& p2) {
-    return glm::length(p2.position - p1.position);
+template <typename Precision>
+typename BasicPhysicsEngine<Precision>::ScalarType
+BasicPhysicsEngine<Precision>::calculateDistance(const ParticleType& p1, const ParticleType& p2) {
+    return static_cast<ScalarType>(glm::length(p2.position - p1.position));
 }
+
+template class BasicPhysicsEngine<FloatPrecision>;
+template class BasicPhysicsEngine<DoublePrecision>;
+template class BasicPhysicsEngine<MixedPrecision>;
@@ -2,39 +2,134 @@
 #define PHYSICS_ENGINE_H
 
 #include "../particle/ParticleSystem.h"
+#include "KinematicObstacle.h"
+#include "SignedDistanceField.h"
+#include "../optimization/UniformGrid.h"
+#include "../utils/HardwareCounters.h"
+#include "../utils/PerformanceProfiler.h"
 #include <glm/glm.hpp>
+#include <cstdint>
+#include <utility>
+#include <vector>
 
-class PhysicsEngine {
+// Collision broad phase
+enum class CollisionBroadPhase {
+    BruteForce,   // all pairs, O(n^2)
+    CellList      // uniform grid with cache-blocked tiles, O(n)
+};
+
+template <typename Precision>
+class BasicPhysicsEngine {
 public:
-    PhysicsEngine();
-    
+    using BroadPhase = CollisionBroadPhase;
+    using ParticleType = BasicParticle<Precision>;
+    using SystemType = BasicParticleSystem<Precision>;
+    using PositionType = typename Precision::Position;
+    using ScalarType = typename Precision::Scalar;
+    using Position = typename ParticleType::Position;
+    using Vector = typename ParticleType::Vector;
+
+    BasicPhysicsEngine();
+
     // Core physics functions
-    void applyGravity(ParticleSystem& system, const glm::vec2& gravity);
-    void applyAirResistance(ParticleSystem& system, float resistance);
-    void handleCollisions(ParticleSystem& system, float damping = 0.8f);
-    void integrateParticles(ParticleSystem& system, float deltaTime);
-    
+    void applyGravity(SystemType& system, const Vector& gravity);
+    void applyAirResistance(SystemType& system, ScalarType resistance);
+    void handleCollisions(SystemType& system, ScalarType damping = 0.8f);
+    void integrateParticles(SystemType& system, ScalarType deltaTime);
+
     // Force application
-    void applyForceToParticle(Particle& particle, const glm::vec2& force);
-    void applyGlobalForce(ParticleSystem& system, const glm::vec2& force);
-    
+    void applyForceToParticle(ParticleType& particle, const Vector& force);
+    void applyGlobalForce(SystemType& system, const Vector& force);
+
     // Boundary handling
-    void applyBoundaryConstraints(ParticleSystem& system, const glm::vec2& minBounds, const glm::vec2& maxBounds);
-    
+    void applyBoundaryConstraints(SystemType& system, const Position& minBounds, const Position& maxBounds);
+    void applyBoundaryConstraints(SystemType& system, const SignedDistanceField& field); // static geometry instead of the box
+
     // Configuration
-    void setGravity(const glm::vec2& gravity) { m_gravity = gravity; }
-    void setAirResistance(float resistance) { m_airResistance = resistance; }
-    void setCollisionDamping(float damping) { m_collisionDamping = damping; }
-    
+    void setGravity(const Vector& gravity) { m_gravity = gravity; }
+    void setAirResistance(ScalarType resistance) { m_airResistance = resistance; }
+    void setCollisionDamping(ScalarType damping) { m_collisionDamping = damping; }
+    void setBroadPhase(BroadPhase broadPhase) { m_broadPhase = broadPhase; }
+    BroadPhase getBroadPhase() const { return m_broadPhase; }
+    void setObstacles(KinematicObstacleSet* obstacles) { m_obstacles = obstacles; } // advanced and collided each step
+
+    // Instrumentation (profiler is optional; counters need perf_event access)
+    void setProfiler(PerformanceProfiler* profiler) { m_profiler = profiler; }
+    bool enableHardwareCounters();
+    size_t getLastContactCount() const { return m_lastContactCount; }
+    size_t getLastPairTestCount() const { return m_lastPairTestCount; } // narrow-phase distance tests
+    size_t getLastFilteredPairCount() const { return m_lastFilteredPairCount; } // candidates rejected by group/mask
+
+    // Optional log of resolved contacts (particle index pairs, lower index first),
+    // refilled by every handleCollisions(); used by the differential validator
+    using ContactLog = std::vector<std::pair<uint32_t, uint32_t>>;
+    void setContactLog(ContactLog* log) { m_contactLog = log; }
+    // Optional log of candidate pairs that overlapped at the positions the step
+    // started from, before any resolution moved them. Unlike resolved contacts
+    // this set does not depend on visiting order, so paths compare it exactly.
+    void setCandidateLog(ContactLog* log) { m_candidateLog = log; }
+
 private:
-    glm::vec2 m_gravity;
-    float m_airResistance;
-    float m_collisionDamping;
-    
+    Vector m_gravity;
+    ScalarType m_airResistance;
+    ScalarType m_collisionDamping;
+    BroadPhase m_broadPhase;
+    KinematicObstacleSet* m_obstacles;
+
+    PerformanceProfiler* m_profiler;
+    HardwareCounters m_counters;
+    bool m_countersEnabled;
+    size_t m_lastContactCount;
+    size_t m_lastPairTestCount;
+    size_t m_lastFilteredPairCount;
+    ContactLog* m_contactLog;
+    ContactLog* m_candidateLog;
+
+    // Cell list and particle data gathered into cell order (SoA, reused every step).
+    // Sorted positions are local to each particle's cell origin, so pair math in
+    // ScalarType stays accurate however far the world extends from (0, 0).
+    UniformGrid m_grid;
+    std::vector<float> m_posX, m_posY;
+    std::vector<ScalarType> m_sortedPosX, m_sortedPosY;
+    std::vector<ScalarType> m_gatheredPosX, m_gatheredPosY;
+    std::vector<ScalarType> m_sortedVelX, m_sortedVelY;
+    std::vector<ScalarType> m_sortedRadius, m_sortedInvMass;
+    std::vector<int32_t> m_sortedCellX, m_sortedCellY;
+    ScalarType m_cellSize;
+
+    // With collision filters, m_members lists the particles binned in the grid
+    // and m_queries those that only look up the grid (see handleCollisionsGrid).
+    // Sorted slots map back through m_sortedParticle and carry their group / mask.
+    std::vector<uint32_t> m_members;
+    std::vector<uint32_t> m_queries;
+    std::vector<uint32_t> m_sortedParticle;
+    std::vector<uint32_t> m_sortedGroup, m_sortedMask;
+    bool m_filterPairs;
+
+    // Tiles are sized so the particles they touch stay resident in a 32 KB L1D
+    static const size_t L1_TILE_BYTES = 24 * 1024;
+    static const size_t BYTES_PER_PARTICLE = 6 * sizeof(ScalarType) + 2 * sizeof(int32_t);
+
+    // Collision paths
+    void handleCollisionsBruteForce(SystemType& system, ScalarType damping);
+    void handleCollisionsGrid(SystemType& system, ScalarType damping);
+    void processTile(int row, int firstCell, int lastCell, ScalarType damping);
+    void processPairsSelf(uint32_t begin, uint32_t end, ScalarType damping);
+    void processPairsCross(uint32_t beginA, uint32_t endA, uint32_t beginB, uint32_t endB, ScalarType damping);
+    void resolveSortedPair(uint32_t a, uint32_t b, ScalarType damping);
+    void prefetchRange(uint32_t begin, uint32_t end) const;
+
     // Helper functions
-    bool checkCollision(const Particle& p1, const Particle& p2);
-    void resolveCollision(Particle& p1, Particle& p2, float damping);
-    float calculateDistance(const Particle& p1, const Particle& p2);
+    static bool canCollide(uint32_t groupA, uint32_t maskA, uint32_t groupB, uint32_t maskB) {
+        return (groupA & maskB) != 0 && (groupB & maskA) != 0;
+    }
+    bool checkCollision(const ParticleType& p1, const ParticleType& p2);
+    void resolveCollision(ParticleType& p1, ParticleType& p2, ScalarType damping);
+    ScalarType calculateDistance(const ParticleType& p1, const ParticleType& p2);
 };
 
+using PhysicsEngine = BasicPhysicsEngine<FloatPrecision>;
+using DoublePhysicsEngine = BasicPhysicsEngine<DoublePrecision>;
+using MixedPhysicsEngine = BasicPhysicsEngine<MixedPrecision>;
+
 #endif // PHYSICS_ENGINE_H
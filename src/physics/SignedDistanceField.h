@@ -0,0 +1,94 @@
+#ifndef SIGNED_DISTANCE_FIELD_H
+#define SIGNED_DISTANCE_FIELD_H
+
+#include "../particle/ParticleSystem.h"
+#include "../utils/PerformanceProfiler.h"
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <vector>
+
+// Static collision geometry (terrain, mazes, containers) baked into a signed
+// distance grid at load time: negative inside solids, positive in free space.
+// A particle-vs-world query is then one bilinear lookup plus its gradient,
+// whatever the number of segments in the scene, instead of a test per segment.
+//
+// Distances are exact at the grid nodes within `band` of a surface and clamped
+// to +/-band beyond it, so the band must exceed the largest particle radius.
+// Between nodes the field is bilinear, which rounds corners by about a cell.
+//
+// Profiler scopes: "sdf_build" and "sdf_collide".
+class SignedDistanceField {
+public:
+    SignedDistanceField();
+
+    // Geometry, added before build(). Solids are unioned.
+    void addPolygon(const std::vector<glm::vec2>& vertices);          // closed, any winding
+    void addSegment(const glm::vec2& a, const glm::vec2& b, float halfThickness); // capsule
+    void addCircle(const glm::vec2& center, float radius);
+    void addContainer(const glm::vec2& minBounds, const glm::vec2& maxBounds); // solid outside the box
+
+    // Samples the geometry on nodes spaced cellSize apart over [minBounds, maxBounds].
+    // Returns false (and keeps the previous field) for an empty or oversized grid.
+    bool build(const glm::vec2& minBounds, const glm::vec2& maxBounds, float cellSize, float band);
+
+    // Queries (positions outside the grid are measured from its border)
+    float sample(const glm::vec2& position) const;
+    glm::vec2 gradient(const glm::vec2& position) const; // unnormalized
+
+    // Push particles out of the geometry, reflecting the normal velocity with
+    // the same damping as the box walls. Returns the contact count.
+    template <typename Precision>
+    size_t collide(BasicParticleSystem<Precision>& system, typename Precision::Scalar damping) const;
+
+    // Geometry for rendering and for the per-segment reference in benchmarks
+    struct Segment {
+        glm::vec2 a, b;
+        float halfThickness;
+    };
+    struct Circle {
+        glm::vec2 center;
+        float radius;
+    };
+    const std::vector<std::vector<glm::vec2>>& getPolygons() const { return m_polygons; }
+    const std::vector<Segment>& getSegments() const { return m_segments; }
+    const std::vector<Circle>& getCircles() const { return m_circles; }
+    bool hasContainer() const { return m_hasContainer; }
+    const glm::vec2& getContainerMin() const { return m_containerMin; }
+    const glm::vec2& getContainerMax() const { return m_containerMax; }
+
+    bool isBuilt() const { return !m_values.empty(); }
+    int getNodesX() const { return m_nodesX; }
+    int getNodesY() const { return m_nodesY; }
+    float getCellSize() const { return m_cellSize; }
+
+    void setProfiler(PerformanceProfiler* profiler) { m_profiler = profiler; }
+
+private:
+    std::vector<std::vector<glm::vec2>> m_polygons;
+    std::vector<Segment> m_segments;
+    std::vector<Circle> m_circles;
+    bool m_hasContainer;
+    glm::vec2 m_containerMin, m_containerMax;
+
+    // Node values, row-major, m_nodesX * m_nodesY
+    std::vector<float> m_values;
+    int m_nodesX, m_nodesY;
+    glm::vec2 m_origin;
+    float m_cellSize;
+    float m_inverseCellSize;
+    float m_band;
+
+    PerformanceProfiler* m_profiler;
+
+    // Particles are processed in blocks: positions are gathered into SoA arrays
+    // and the lookups run as straight-line loops the compiler vectorizes
+    static const size_t BLOCK_SIZE = 256;
+    // A blocked lookup plus response is ~7 ns per particle, ~27 us per chunk
+    static const size_t MIN_PARTICLES_PER_THREAD = 4096;
+    // Guard against a cell size that would allocate an enormous grid
+    static const size_t MAX_NODES = size_t(1) << 26;
+
+    void lookupBlock(const float* x, const float* y, size_t count, float* distance, float* normalX, float* normalY) const;
+};
+
+#endif // SIGNED_DISTANCE_FIELD_H
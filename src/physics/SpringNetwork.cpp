@@ -0,0 +1,395 @@
+#include "SpringNetwork.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+SpringNetwork::SpringNetwork(ThreadPool* threadPool)
+    : m_threadPool(threadPool ? threadPool : &ThreadPool::shared())
+    , m_profiler(nullptr)
+    , m_timeStep(1.0f / 60.0f)
+    , m_gravityX(0.0f)
+    , m_gravityY(-9.81f)
+    , m_tolerance(1e-3f)
+    , m_maxIterations(200)
+    , m_adjacencyValid(false)
+    , m_lastIterations(0)
+    , m_lastResidual(0.0f) {
+}
+
+void SpringNetwork::setSolverTolerance(float tolerance, int maxIterations) {
+    m_tolerance = tolerance;
+    m_maxIterations = std::max(1, maxIterations);
+}
+
+void SpringNetwork::clear() {
+    m_posX.clear(); m_posY.clear();
+    m_velX.clear(); m_velY.clear();
+    m_mass.clear();
+    m_free.clear();
+    m_springA.clear(); m_springB.clear();
+    m_stiffness.clear(); m_damping.clear(); m_restLength.clear();
+    m_adjacencyValid = false;
+}
+
+uint32_t SpringNetwork::addParticle(float x, float y, float mass) {
+    m_posX.push_back(x);
+    m_posY.push_back(y);
+    m_velX.push_back(0.0f);
+    m_velY.push_back(0.0f);
+    m_mass.push_back(mass);
+    m_free.push_back(1.0f);
+    m_adjacencyValid = false;
+    return static_cast<uint32_t>(m_posX.size() - 1);
+}
+
+void SpringNetwork::setPinned(uint32_t index, bool pinned) {
+    m_free[index] = pinned ? 0.0f : 1.0f;
+    if (pinned) {
+        m_velX[index] = 0.0f;
+        m_velY[index] = 0.0f;
+    }
+}
+
+void SpringNetwork::addSpring(uint32_t a, uint32_t b, float stiffness, float damping) {
+    float dx = m_posX[a] - m_posX[b];
+    float dy = m_posY[a] - m_posY[b];
+    float restLength = std::sqrt(dx * dx + dy * dy);
+    if (a == b || restLength == 0.0f) {
+        std::cerr << "[SPRINGS] Ignoring degenerate spring " << a << "-" << b << std::endl;
+        return;
+    }
+    m_springA.push_back(a);
+    m_springB.push_back(b);
+    m_stiffness.push_back(stiffness);
+    m_damping.push_back(damping);
+    m_restLength.push_back(restLength);
+    m_adjacencyValid = false;
+}
+
+void SpringNetwork::createCloth(int columns, int rows, float spacing, float mass, float stiffness, float damping) {
+    clear();
+    if (columns < 2 || rows < 2) return;
+
+    // Top row at y = 0, hanging downwards
+    const float left = -0.5f * spacing * (columns - 1);
+    for (int row = 0; row < rows; ++row) {
+        for (int column = 0; column < columns; ++column) {
+            addParticle(left + column * spacing, -row * spacing, mass);
+        }
+    }
+    auto index = [columns](int column, int row) { return static_cast<uint32_t>(row * columns + column); };
+
+    for (int row = 0; row < rows; ++row) {
+        for (int column = 0; column < columns; ++column) {
+            // Structural
+            if (column + 1 < columns) addSpring(index(column, row), index(column + 1, row), stiffness, damping);
+            if (row + 1 < rows) addSpring(index(column, row), index(column, row + 1), stiffness, damping);
+            // Shear
+            if (column + 1 < columns && row + 1 < rows) {
+                addSpring(index(column, row), index(column + 1, row + 1), stiffness, damping);
+                addSpring(index(column + 1, row), index(column, row + 1), stiffness, damping);
+            }
+            // Bend, softer
+            if (column + 2 < columns) addSpring(index(column, row), index(column + 2, row), 0.1f * stiffness, damping);
+            if (row + 2 < rows) addSpring(index(column, row), index(column, row + 2), 0.1f * stiffness, damping);
+        }
+    }
+
+    setPinned(index(0, 0), true);
+    setPinned(index(columns - 1, 0), true);
+}
+
+template <typename Body>
+void SpringNetwork::parallelSums(size_t count, const Body& body, double& first, double& second) {
+    const size_t threads = m_threadPool->getThreadCount();
+    m_threadSums.assign(2 * threads, 0.0);
+    m_threadPool->parallelFor(0, count, [&](size_t begin, size_t end, size_t threadIndex) {
+        body(begin, end, m_threadSums[2 * threadIndex], m_threadSums[2 * threadIndex + 1]);
+    }, MIN_PARTICLES_PER_THREAD);
+
+    first = 0.0;
+    second = 0.0;
+    for (size_t t = 0; t < threads; ++t) {
+        first += m_threadSums[2 * t];
+        second += m_threadSums[2 * t + 1];
+    }
+}
+
+void SpringNetwork::buildAdjacency() {
+    const size_t count = m_posX.size();
+    m_adjacencyOffsets.assign(count + 1, 0);
+    for (size_t s = 0; s < m_springA.size(); ++s) {
+        m_adjacencyOffsets[m_springA[s] + 1]++;
+        m_adjacencyOffsets[m_springB[s] + 1]++;
+    }
+    for (size_t i = 0; i < count; ++i) {
+        m_adjacencyOffsets[i + 1] += m_adjacencyOffsets[i];
+    }
+
+    m_adjacencySprings.resize(2 * m_springA.size());
+    m_adjacencyOthers.resize(2 * m_springA.size());
+    std::vector<uint32_t> cursor(m_adjacencyOffsets.begin(), m_adjacencyOffsets.end() - 1);
+    for (size_t s = 0; s < m_springA.size(); ++s) {
+        uint32_t a = m_springA[s], b = m_springB[s];
+        m_adjacencySprings[cursor[a]] = static_cast<uint32_t>(s);
+        m_adjacencyOthers[cursor[a]++] = b;
+        m_adjacencySprings[cursor[b]] = static_cast<uint32_t>(s);
+        m_adjacencyOthers[cursor[b]++] = a;
+    }
+
+    // The new topology has no previous solution to warm start from
+    m_deltaX.assign(count, 0.0f);
+    m_deltaY.assign(count, 0.0f);
+    for (std::vector<float>* vector : {&m_rhsX, &m_rhsY, &m_residualX, &m_residualY,
+                                       &m_directionX, &m_directionY, &m_productX, &m_productY,
+                                       &m_inverseDiagonalX, &m_inverseDiagonalY}) {
+        vector->resize(count);
+    }
+    const size_t springs = m_springA.size();
+    for (std::vector<float>* vector : {&m_normalX, &m_normalY, &m_force, &m_along, &m_across, &m_stiffTerm}) {
+        vector->resize(springs);
+    }
+    m_adjacencyValid = true;
+}
+
+void SpringNetwork::computeSpringTerms(bool implicit) {
+    const float h = m_timeStep;
+    m_threadPool->parallelFor(0, m_springA.size(), [&](size_t begin, size_t end, size_t) {
+        for (size_t s = begin; s < end; ++s) {
+            const uint32_t a = m_springA[s], b = m_springB[s];
+            float dx = m_posX[a] - m_posX[b];
+            float dy = m_posY[a] - m_posY[b];
+            float length = std::sqrt(dx * dx + dy * dy);
+            float inverseLength = length > 0.0f ? 1.0f / length : 0.0f;
+            float nx = dx * inverseLength;
+            float ny = dy * inverseLength;
+            float closing = nx * (m_velX[a] - m_velX[b]) + ny * (m_velY[a] - m_velY[b]);
+
+            m_normalX[s] = nx;
+            m_normalY[s] = ny;
+            m_force[s] = -m_stiffness[s] * (length - m_restLength[s]) - m_damping[s] * closing;
+            if (implicit) {
+                float stiffTerm = h * h * m_stiffness[s];
+                m_stiffTerm[s] = stiffTerm;
+                m_along[s] = h * m_damping[s] + stiffTerm;
+                m_across[s] = stiffTerm * std::max(0.0f, 1.0f - m_restLength[s] * inverseLength);
+            }
+        }
+    }, MIN_PARTICLES_PER_THREAD);
+}
+
+void SpringNetwork::assembleSystem() {
+    PROFILE_SCOPE(m_profiler, "spring_assemble");
+    const float h = m_timeStep;
+
+    // b = h f + h^2 K v, and the diagonal of A for the preconditioner
+    m_threadPool->parallelFor(0, m_posX.size(), [&](size_t begin, size_t end, size_t) {
+        for (size_t i = begin; i < end; ++i) {
+            float forceX = m_mass[i] * m_gravityX;
+            float forceY = m_mass[i] * m_gravityY;
+            float stiffX = 0.0f, stiffY = 0.0f;
+            float diagonalX = m_mass[i], diagonalY = m_mass[i];
+            for (uint32_t k = m_adjacencyOffsets[i]; k < m_adjacencyOffsets[i + 1]; ++k) {
+                const uint32_t s = m_adjacencySprings[k];
+                const uint32_t j = m_adjacencyOthers[k];
+                const float nx = m_normalX[s], ny = m_normalY[s];
+                const float sign = m_springA[s] == i ? 1.0f : -1.0f;
+                forceX += sign * m_force[s] * nx;
+                forceY += sign * m_force[s] * ny;
+
+                float ux = m_velX[i] - m_velX[j];
+                float uy = m_velY[i] - m_velY[j];
+                float alongU = nx * ux + ny * uy;
+                stiffX -= m_stiffTerm[s] * alongU * nx + m_across[s] * (ux - alongU * nx);
+                stiffY -= m_stiffTerm[s] * alongU * ny + m_across[s] * (uy - alongU * ny);
+
+                diagonalX += m_along[s] * nx * nx + m_across[s] * (1.0f - nx * nx);
+                diagonalY += m_along[s] * ny * ny + m_across[s] * (1.0f - ny * ny);
+            }
+            m_rhsX[i] = m_free[i] * (h * forceX + stiffX);
+            m_rhsY[i] = m_free[i] * (h * forceY + stiffY);
+            m_inverseDiagonalX[i] = 1.0f / diagonalX;
+            m_inverseDiagonalY[i] = 1.0f / diagonalY;
+        }
+    }, MIN_PARTICLES_PER_THREAD);
+}
+
+void SpringNetwork::multiply(const float* x, const float* y, float* resultX, float* resultY) {
+    // (A p)_i = m_i p_i + sum over springs of the spring block applied to p_i - p_j
+    m_threadPool->parallelFor(0, m_posX.size(), [&](size_t begin, size_t end, size_t) {
+        for (size_t i = begin; i < end; ++i) {
+            float sumX = m_mass[i] * x[i];
+            float sumY = m_mass[i] * y[i];
+            for (uint32_t k = m_adjacencyOffsets[i]; k < m_adjacencyOffsets[i + 1]; ++k) {
+                const uint32_t s = m_adjacencySprings[k];
+                const uint32_t j = m_adjacencyOthers[k];
+                const float nx = m_normalX[s], ny = m_normalY[s];
+                float ux = x[i] - x[j];
+                float uy = y[i] - y[j];
+                float alongU = nx * ux + ny * uy;
+                sumX += m_along[s] * alongU * nx + m_across[s] * (ux - alongU * nx);
+                sumY += m_along[s] * alongU * ny + m_across[s] * (uy - alongU * ny);
+            }
+            resultX[i] = m_free[i] * sumX;
+            resultY[i] = m_free[i] * sumY;
+        }
+    }, MIN_PARTICLES_PER_THREAD);
+}
+
+void SpringNetwork::solve() {
+    PROFILE_SCOPE(m_profiler, "spring_cg");
+    const size_t count = m_posX.size();
+
+    // Warm start from the previous step's dv (the motion is smooth from frame
+    // to frame): r = b - A dv, d = M^-1 r
+    multiply(m_deltaX.data(), m_deltaY.data(), m_productX.data(), m_productY.data());
+    double rhsNormSq, residualNormSq, residualDotPreconditioned, unused;
+    parallelSums(count, [&](size_t begin, size_t end, double& normSq, double& residualSq) {
+        for (size_t i = begin; i < end; ++i) {
+            m_residualX[i] = m_rhsX[i] - m_productX[i];
+            m_residualY[i] = m_rhsY[i] - m_productY[i];
+            normSq += static_cast<double>(m_rhsX[i]) * m_rhsX[i] + static_cast<double>(m_rhsY[i]) * m_rhsY[i];
+            residualSq += static_cast<double>(m_residualX[i]) * m_residualX[i] + static_cast<double>(m_residualY[i]) * m_residualY[i];
+        }
+    }, rhsNormSq, residualNormSq);
+    parallelSums(count, [&](size_t begin, size_t end, double& dot, double&) {
+        for (size_t i = begin; i < end; ++i) {
+            m_directionX[i] = m_inverseDiagonalX[i] * m_residualX[i];
+            m_directionY[i] = m_inverseDiagonalY[i] * m_residualY[i];
+            dot += static_cast<double>(m_residualX[i]) * m_directionX[i] + static_cast<double>(m_residualY[i]) * m_directionY[i];
+        }
+    }, residualDotPreconditioned, unused);
+
+    m_lastIterations = 0;
+    m_lastResidual = 0.0f;
+    if (rhsNormSq == 0.0) {
+        std::fill(m_deltaX.begin(), m_deltaX.end(), 0.0f);
+        std::fill(m_deltaY.begin(), m_deltaY.end(), 0.0f);
+        return;
+    }
+
+    // Near rest b is almost zero; measuring the residual against the gravity
+    // impulse as well keeps CG from chasing digits nobody can see
+    double gravityImpulseSq = 0.0;
+    const double gravitySq = static_cast<double>(m_gravityX) * m_gravityX + static_cast<double>(m_gravityY) * m_gravityY;
+    for (size_t i = 0; i < count; ++i) {
+        gravityImpulseSq += m_free[i] * static_cast<double>(m_mass[i]) * m_mass[i] * gravitySq;
+    }
+    gravityImpulseSq *= static_cast<double>(m_timeStep) * m_timeStep;
+    const double referenceSq = std::max(rhsNormSq, gravityImpulseSq);
+    const double targetSq = static_cast<double>(m_tolerance) * m_tolerance * referenceSq;
+    while (m_lastIterations < m_maxIterations && residualNormSq > targetSq) {
+        multiply(m_directionX.data(), m_directionY.data(), m_productX.data(), m_productY.data());
+        double curvature;
+        parallelSums(count, [&](size_t begin, size_t end, double& dot, double&) {
+            for (size_t i = begin; i < end; ++i) {
+                dot += static_cast<double>(m_directionX[i]) * m_productX[i] + static_cast<double>(m_directionY[i]) * m_productY[i];
+            }
+        }, curvature, unused);
+        if (!(curvature > 0.0)) break;
+
+        // Step along d, update r, and the new r . M^-1 r
+        const float alpha = static_cast<float>(residualDotPreconditioned / curvature);
+        double nextDot;
+        parallelSums(count, [&](size_t begin, size_t end, double& normSq, double& dot) {
+            for (size_t i = begin; i < end; ++i) {
+                m_deltaX[i] += alpha * m_directionX[i];
+                m_deltaY[i] += alpha * m_directionY[i];
+                m_residualX[i] -= alpha * m_productX[i];
+                m_residualY[i] -= alpha * m_productY[i];
+                float zx = m_inverseDiagonalX[i] * m_residualX[i];
+                float zy = m_inverseDiagonalY[i] * m_residualY[i];
+                normSq += static_cast<double>(m_residualX[i]) * m_residualX[i] + static_cast<double>(m_residualY[i]) * m_residualY[i];
+                dot += static_cast<double>(m_residualX[i]) * zx + static_cast<double>(m_residualY[i]) * zy;
+            }
+        }, residualNormSq, nextDot);
+
+        const float beta = static_cast<float>(nextDot / residualDotPreconditioned);
+        residualDotPreconditioned = nextDot;
+        m_threadPool->parallelFor(0, count, [&](size_t begin, size_t end, size_t) {
+            for (size_t i = begin; i < end; ++i) {
+                m_directionX[i] = m_inverseDiagonalX[i] * m_residualX[i] + beta * m_directionX[i];
+                m_directionY[i] = m_inverseDiagonalY[i] * m_residualY[i] + beta * m_directionY[i];
+            }
+        }, MIN_PARTICLES_PER_THREAD);
+        m_lastIterations++;
+    }
+    m_lastResidual = static_cast<float>(std::sqrt(residualNormSq / referenceSq));
+}
+
+void SpringNetwork::step() {
+    if (m_posX.empty()) return;
+    if (!m_adjacencyValid) buildAdjacency();
+
+    computeSpringTerms(true);
+    assembleSystem();
+    solve();
+
+    // v += dv (zero for pinned particles), then x += h v with the new velocity
+    const float h = m_timeStep;
+    m_threadPool->parallelFor(0, m_posX.size(), [&](size_t begin, size_t end, size_t) {
+        for (size_t i = begin; i < end; ++i) {
+            m_velX[i] += m_deltaX[i];
+            m_velY[i] += m_deltaY[i];
+            m_posX[i] += h * m_velX[i];
+            m_posY[i] += h * m_velY[i];
+        }
+    }, MIN_PARTICLES_PER_THREAD);
+}
+
+void SpringNetwork::stepExplicit() {
+    if (m_posX.empty()) return;
+    if (!m_adjacencyValid) buildAdjacency();
+
+    // Accelerations go through the CG product buffers; dv is kept for warm starts
+    computeSpringTerms(false);
+    const float h = m_timeStep;
+    m_threadPool->parallelFor(0, m_posX.size(), [&](size_t begin, size_t end, size_t) {
+        for (size_t i = begin; i < end; ++i) {
+            float forceX = m_mass[i] * m_gravityX;
+            float forceY = m_mass[i] * m_gravityY;
+            for (uint32_t k = m_adjacencyOffsets[i]; k < m_adjacencyOffsets[i + 1]; ++k) {
+                const uint32_t s = m_adjacencySprings[k];
+                const float sign = m_springA[s] == i ? 1.0f : -1.0f;
+                forceX += sign * m_force[s] * m_normalX[s];
+                forceY += sign * m_force[s] * m_normalY[s];
+            }
+            m_productX[i] = m_free[i] * h * forceX / m_mass[i];
+            m_productY[i] = m_free[i] * h * forceY / m_mass[i];
+        }
+    }, MIN_PARTICLES_PER_THREAD);
+
+    for (size_t i = 0; i < m_posX.size(); ++i) {
+        m_velX[i] += m_productX[i];
+        m_velY[i] += m_productY[i];
+        m_posX[i] += h * m_velX[i];
+        m_posY[i] += h * m_velY[i];
+    }
+}
+
+float SpringNetwork::getMaxStrain() const {
+    float maxStrain = 0.0f;
+    for (size_t s = 0; s < m_springA.size(); ++s) {
+        float dx = m_posX[m_springA[s]] - m_posX[m_springB[s]];
+        float dy = m_posY[m_springA[s]] - m_posY[m_springB[s]];
+        float strain = std::fabs(std::sqrt(dx * dx + dy * dy) - m_restLength[s]) / m_restLength[s];
+        // NaN compares false, so a blown-up network reports infinity
+        maxStrain = strain <= maxStrain ? maxStrain : (std::isfinite(strain) ? strain : INFINITY);
+    }
+    return maxStrain;
+}
+
+double SpringNetwork::getKineticEnergy() const {
+    double sum = 0.0;
+    for (size_t i = 0; i < m_velX.size(); ++i) {
+        sum += 0.5 * m_mass[i] * (static_cast<double>(m_velX[i]) * m_velX[i] + static_cast<double>(m_velY[i]) * m_velY[i]);
+    }
+    return sum;
+}
+
+bool SpringNetwork::isFinite() const {
+    for (size_t i = 0; i < m_posX.size(); ++i) {
+        if (!std::isfinite(m_posX[i]) || !std::isfinite(m_posY[i])) return false;
+    }
+    return true;
+}
@@ -1,6 +1,14 @@
 #include "Renderer.h"
 #include <iostream>
 #include <cmath>
+#include <chrono>
+
+namespace {
+double elapsedMs(std::chrono::high_resolution_clock::time_point start) {
+    auto now = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<double, std::milli>(now - start).count();
+}
+}
 
 Renderer::Renderer() 
     : m_window(nullptr)
@@ -11,7 +19,8 @@ Renderer::Renderer()
     , m_fps(0.0f)
     , m_lastFrameTime(0.0)
     , m_frameCount(0)
-    , m_fpsUpdateTime(0.0) {
+    , m_fpsUpdateTime(0.0)
+    , m_startupTimings{0.0, 0.0, 0.0, false} {
 }
 
 Renderer::~Renderer() {
@@ -19,6 +28,8 @@ Renderer::~Renderer() {
 }
 
 bool Renderer::initialize(int width, int height, const std::string& title) {
+    auto phaseStart = std::chrono::high_resolution_clock::now();
+    
     // Set error callback
     glfwSetErrorCallback(errorCallback);
     
@@ -51,12 +62,21 @@ bool Renderer::initialize(int width, int height, const std::string& title) {
     
     // Enable vsync
     glfwSwapInterval(1);
+    m_startupTimings.glfwInitTime = elapsedMs(phaseStart);
     
     // Setup OpenGL
+    phaseStart = std::chrono::high_resolution_clock::now();
     if (!setupOpenGL()) {
         cleanup();
         return false;
     }
+    m_startupTimings.glSetupTime = elapsedMs(phaseStart);
+    
+    // Load shaders (binary cache makes warm starts skip GLSL compilation)
+    phaseStart = std::chrono::high_resolution_clock::now();
+    loadShaders();
+    m_startupTimings.shaderLoadTime = elapsedMs(phaseStart);
+    m_startupTimings.shaderFromCache = m_particleShader.wasLoadedFromCache();
     
     m_lastFrameTime = glfwGetTime();
     m_fpsUpdateTime = m_lastFrameTime;
@@ -66,6 +86,7 @@ bool Renderer::initialize(int width, int height, const std::string& title) {
 
 void Renderer::cleanup() {
     if (m_window) {
+        m_particleShader.destroy();
         glfwDestroyWindow(m_window);
         m_window = nullptr;
     }
@@ -97,12 +118,19 @@ bool Renderer::setupOpenGL() {
     return true;
 }
 
+void Renderer::loadShaders() {
+    if (!m_particleShader.loadFromFiles("shaders/vertex.glsl", "shaders/fragment.glsl")) {
+        std::cout << "[RENDER] Particle shader unavailable, using fixed-function pipeline" << std::endl;
+    }
+}
+
 void Renderer::clear(const glm::vec3& clearColor) {
     glClearColor(clearColor.r, clearColor.g, clearColor.b, 1.0f);
     glClear(GL_COLOR_BUFFER_BIT);
 }
 
-void Renderer::renderParticleSystem(const ParticleSystem& system) {
+template <typename Precision>
+void Renderer::renderParticleSystem(const BasicParticleSystem<Precision>& system) {
     const auto& particles = system.getParticles();
     
     // Debug output every 60 frames (1 second at 60 FPS)
@@ -116,14 +144,17 @@ void Renderer::renderParticleSystem(const ParticleSystem& system) {
     }
     frameCount++;
     
+    m_particleShader.use();
     for (const auto& particle : particles) {
         renderParticle(particle);
     }
+    m_particleShader.release();
 }
 
-void Renderer::renderParticle(const Particle& particle) {
+template <typename Precision>
+void Renderer::renderParticle(const BasicParticle<Precision>& particle) {
     // Color based on velocity for visual interest
-    float speed = glm::length(particle.velocity);
+    float speed = static_cast<float>(glm::length(particle.velocity));
     float normalizedSpeed = std::min(speed / 20.0f, 1.0f); // Normalize to 0-1
     
     glm::vec3 color;
@@ -140,7 +171,77 @@ void Renderer::renderParticle(const Particle& particle) {
     color.g = std::max(color.g, 0.3f);
     color.b = std::max(color.b, 0.3f);
     
-    drawCircle(particle.position, particle.radius, color);
+    // Rendering only needs float precision
+    drawCircle(glm::vec2(particle.position), static_cast<float>(particle.radius), color);
+}
+
+template void Renderer::renderParticleSystem(const BasicParticleSystem<FloatPrecision>&);
+template void Renderer::renderParticleSystem(const BasicParticleSystem<DoublePrecision>&);
+template void Renderer::renderParticleSystem(const BasicParticleSystem<MixedPrecision>&);
+
+void Renderer::renderObstacles(const KinematicObstacleSet& obstacles) {
+    // Capsules are drawn as thick lines through their core segment
+    glColor3f(0.8f, 0.8f, 0.8f);
+    glLineWidth(4.0f);
+    glBegin(GL_LINES);
+    for (const auto& obstacle : obstacles.getObstacles()) {
+        glm::vec2 a = worldToScreen(obstacle.getEndpointA());
+        glm::vec2 b = worldToScreen(obstacle.getEndpointB());
+        glVertex2f(a.x, a.y);
+        glVertex2f(b.x, b.y);
+    }
+    glEnd();
+    glLineWidth(1.0f);
+}
+
+void Renderer::renderStaticGeometry(const SignedDistanceField& field) {
+    // Outlines of the geometry baked into the field
+    glColor3f(0.6f, 0.7f, 0.6f);
+    glLineWidth(2.0f);
+    
+    if (field.hasContainer()) {
+        glm::vec2 lo = worldToScreen(field.getContainerMin());
+        glm::vec2 hi = worldToScreen(field.getContainerMax());
+        glBegin(GL_LINE_LOOP);
+        glVertex2f(lo.x, lo.y);
+        glVertex2f(hi.x, lo.y);
+        glVertex2f(hi.x, hi.y);
+        glVertex2f(lo.x, hi.y);
+        glEnd();
+    }
+    
+    for (const auto& polygon : field.getPolygons()) {
+        glBegin(GL_LINE_LOOP);
+        for (const glm::vec2& vertex : polygon) {
+            glm::vec2 p = worldToScreen(vertex);
+            glVertex2f(p.x, p.y);
+        }
+        glEnd();
+    }
+    
+    for (const auto& circle : field.getCircles()) {
+        const int segments = 32;
+        glBegin(GL_LINE_LOOP);
+        for (int i = 0; i < segments; ++i) {
+            float angle = 2.0f * static_cast<float>(M_PI) * i / segments;
+            glm::vec2 p = worldToScreen(circle.center + circle.radius * glm::vec2(std::cos(angle), std::sin(angle)));
+            glVertex2f(p.x, p.y);
+        }
+        glEnd();
+    }
+    glLineWidth(1.0f);
+    
+    // Capsule walls as thick lines through their core segment, like obstacles
+    glLineWidth(4.0f);
+    glBegin(GL_LINES);
+    for (const auto& segment : field.getSegments()) {
+        glm::vec2 a = worldToScreen(segment.a);
+        glm::vec2 b = worldToScreen(segment.b);
+        glVertex2f(a.x, a.y);
+        glVertex2f(b.x, b.y);
+    }
+    glEnd();
+    glLineWidth(1.0f);
 }
 
 void Renderer::drawCircle(const glm::vec2& center, float radius, const glm::vec3& color, int segments) {
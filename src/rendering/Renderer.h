@@ -2,12 +2,23 @@
 #define RENDERER_H
 
 #include "../particle/ParticleSystem.h"
+#include "../physics/KinematicObstacle.h"
+#include "../physics/SignedDistanceField.h"
+#include "Shader.h"
 #include <GLFW/glfw3.h>
 #include <glm/glm.hpp>
 #include <string>
 
 class Renderer {
 public:
+    // Wall-clock cost of each initialization phase, in milliseconds
+    struct StartupTimings {
+        double glfwInitTime;
+        double glSetupTime;
+        double shaderLoadTime;
+        bool shaderFromCache;
+    };
+    
     Renderer();
     ~Renderer();
     
@@ -17,7 +28,10 @@ public:
     
     // Rendering
     void clear(const glm::vec3& clearColor = glm::vec3(0.2f, 0.3f, 0.3f));
-    void renderParticleSystem(const ParticleSystem& system);
+    template <typename Precision>
+    void renderParticleSystem(const BasicParticleSystem<Precision>& system);
+    void renderObstacles(const KinematicObstacleSet& obstacles);
+    void renderStaticGeometry(const SignedDistanceField& field);
     void present();
     
     // Window management
@@ -31,6 +45,7 @@ public:
     
     // Performance
     float getFPS() const { return m_fps; }
+    const StartupTimings& getStartupTimings() const { return m_startupTimings; }
     
 private:
     GLFWwindow* m_window;
@@ -46,12 +61,18 @@ private:
     double m_lastFrameTime;
     int m_frameCount;
     double m_fpsUpdateTime;
+    StartupTimings m_startupTimings;
+    
+    // Particle shader (falls back to fixed-function when unavailable)
+    Shader m_particleShader;
     
     // OpenGL setup
     bool setupOpenGL();
+    void loadShaders();
     
     // Rendering helpers
-    void renderParticle(const Particle& particle);
+    template <typename Precision>
+    void renderParticle(const BasicParticle<Precision>& particle);
     void drawCircle(const glm::vec2& center, float radius, const glm::vec3& color, int segments = 16);
     
     // Coordinate transformation
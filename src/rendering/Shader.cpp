@@ -0,0 +1,367 @@
+#include "Shader.h"
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+#ifndef APIENTRY
+#define APIENTRY
+#endif
+
+// GL 2.0 / ARB_get_program_binary entry points. The renderer does not use a
+// loader library, so these are resolved through GLFW once a context exists.
+namespace {
+
+const GLenum SHADER_VERTEX = 0x8B31;                 // GL_VERTEX_SHADER
+const GLenum SHADER_FRAGMENT = 0x8B30;               // GL_FRAGMENT_SHADER
+const GLenum SHADER_COMPILE_STATUS = 0x8B81;         // GL_COMPILE_STATUS
+const GLenum SHADER_LINK_STATUS = 0x8B82;            // GL_LINK_STATUS
+const GLenum SHADER_INFO_LOG_LENGTH = 0x8B84;        // GL_INFO_LOG_LENGTH
+const GLenum PROGRAM_BINARY_RETRIEVABLE = 0x8257;    // GL_PROGRAM_BINARY_RETRIEVABLE_HINT
+const GLenum PROGRAM_BINARY_LENGTH = 0x8741;         // GL_PROGRAM_BINARY_LENGTH
+const GLenum NUM_PROGRAM_BINARY_FORMATS = 0x87FE;    // GL_NUM_PROGRAM_BINARY_FORMATS
+
+typedef GLuint (APIENTRY *CreateShaderProc)(GLenum type);
+typedef void (APIENTRY *ShaderSourceProc)(GLuint shader, GLsizei count, const char* const* source, const GLint* length);
+typedef void (APIENTRY *CompileShaderProc)(GLuint shader);
+typedef void (APIENTRY *GetShaderivProc)(GLuint shader, GLenum pname, GLint* params);
+typedef void (APIENTRY *GetShaderInfoLogProc)(GLuint shader, GLsizei maxLength, GLsizei* length, char* infoLog);
+typedef void (APIENTRY *DeleteShaderProc)(GLuint shader);
+typedef GLuint (APIENTRY *CreateProgramProc)(void);
+typedef void (APIENTRY *AttachShaderProc)(GLuint program, GLuint shader);
+typedef void (APIENTRY *DetachShaderProc)(GLuint program, GLuint shader);
+typedef void (APIENTRY *LinkProgramProc)(GLuint program);
+typedef void (APIENTRY *GetProgramivProc)(GLuint program, GLenum pname, GLint* params);
+typedef void (APIENTRY *GetProgramInfoLogProc)(GLuint program, GLsizei maxLength, GLsizei* length, char* infoLog);
+typedef void (APIENTRY *DeleteProgramProc)(GLuint program);
+typedef void (APIENTRY *UseProgramProc)(GLuint program);
+typedef void (APIENTRY *ProgramParameteriProc)(GLuint program, GLenum pname, GLint value);
+typedef void (APIENTRY *GetProgramBinaryProc)(GLuint program, GLsizei bufSize, GLsizei* length, GLenum* binaryFormat, void* binary);
+typedef void (APIENTRY *ProgramBinaryProc)(GLuint program, GLenum binaryFormat, const void* binary, GLsizei length);
+
+struct ShaderFunctions {
+    bool loaded = false;
+    bool binarySupported = false;
+
+    CreateShaderProc createShader = nullptr;
+    ShaderSourceProc shaderSource = nullptr;
+    CompileShaderProc compileShader = nullptr;
+    GetShaderivProc getShaderiv = nullptr;
+    GetShaderInfoLogProc getShaderInfoLog = nullptr;
+    DeleteShaderProc deleteShader = nullptr;
+    CreateProgramProc createProgram = nullptr;
+    AttachShaderProc attachShader = nullptr;
+    DetachShaderProc detachShader = nullptr;
+    LinkProgramProc linkProgram = nullptr;
+    GetProgramivProc getProgramiv = nullptr;
+    GetProgramInfoLogProc getProgramInfoLog = nullptr;
+    DeleteProgramProc deleteProgram = nullptr;
+    UseProgramProc useProgram = nullptr;
+    ProgramParameteriProc programParameteri = nullptr;
+    GetProgramBinaryProc getProgramBinary = nullptr;
+    ProgramBinaryProc programBinary = nullptr;
+};
+
+ShaderFunctions g_gl;
+
+template <typename T>
+void loadProc(T& target, const char* name) {
+    target = reinterpret_cast<T>(glfwGetProcAddress(name));
+}
+
+bool loadShaderFunctions() {
+    if (g_gl.loaded) return g_gl.createShader != nullptr;
+    g_gl.loaded = true;
+
+    loadProc(g_gl.createShader, "glCreateShader");
+    loadProc(g_gl.shaderSource, "glShaderSource");
+    loadProc(g_gl.compileShader, "glCompileShader");
+    loadProc(g_gl.getShaderiv, "glGetShaderiv");
+    loadProc(g_gl.getShaderInfoLog, "glGetShaderInfoLog");
+    loadProc(g_gl.deleteShader, "glDeleteShader");
+    loadProc(g_gl.createProgram, "glCreateProgram");
+    loadProc(g_gl.attachShader, "glAttachShader");
+    loadProc(g_gl.detachShader, "glDetachShader");
+    loadProc(g_gl.linkProgram, "glLinkProgram");
+    loadProc(g_gl.getProgramiv, "glGetProgramiv");
+    loadProc(g_gl.getProgramInfoLog, "glGetProgramInfoLog");
+    loadProc(g_gl.deleteProgram, "glDeleteProgram");
+    loadProc(g_gl.useProgram, "glUseProgram");
+    loadProc(g_gl.programParameteri, "glProgramParameteri");
+    loadProc(g_gl.getProgramBinary, "glGetProgramBinary");
+    loadProc(g_gl.programBinary, "glProgramBinary");
+
+    bool coreAvailable = g_gl.createShader && g_gl.shaderSource && g_gl.compileShader &&
+                         g_gl.getShaderiv && g_gl.getShaderInfoLog && g_gl.deleteShader &&
+                         g_gl.createProgram && g_gl.attachShader && g_gl.detachShader &&
+                         g_gl.linkProgram && g_gl.getProgramiv && g_gl.getProgramInfoLog &&
+                         g_gl.deleteProgram && g_gl.useProgram;
+    if (!coreAvailable) {
+        g_gl.createShader = nullptr;
+        return false;
+    }
+
+    // A driver may export the entry points but offer zero binary formats
+    if (g_gl.programParameteri && g_gl.getProgramBinary && g_gl.programBinary) {
+        GLint formatCount = 0;
+        glGetIntegerv(NUM_PROGRAM_BINARY_FORMATS, &formatCount);
+        g_gl.binarySupported = glGetError() == GL_NO_ERROR && formatCount > 0;
+    }
+
+    return true;
+}
+
+// On-disk cache header, written in front of the driver's program binary
+struct CacheHeader {
+    char magic[4];
+    uint32_t version;
+    uint64_t driverHash;
+    uint64_t sourceHash;
+    uint32_t binaryFormat;
+    uint32_t binaryLength;
+};
+
+const char CACHE_MAGIC[4] = {'P', 'S', 'B', 'C'};
+const uint32_t CACHE_VERSION = 1;
+
+} // namespace
+
+Shader::Shader()
+    : m_program(0)
+    , m_cacheDirectory("cache/shaders")
+    , m_binaryCacheEnabled(true)
+    , m_loadedFromCache(false)
+    , m_loadTimeMs(0.0) {
+}
+
+Shader::~Shader() {
+    destroy();
+}
+
+bool Shader::loadFromFiles(const std::string& vertexPath, const std::string& fragmentPath) {
+    auto startTime = std::chrono::high_resolution_clock::now();
+    destroy();
+    m_loadedFromCache = false;
+
+    if (!loadShaderFunctions()) {
+        std::cerr << "[SHADER] GLSL programs are not supported by this OpenGL context" << std::endl;
+        return false;
+    }
+
+    std::string vertexSource;
+    std::string fragmentSource;
+    if (!readFile(vertexPath, vertexSource) || !readFile(fragmentPath, fragmentSource)) {
+        return false;
+    }
+
+    // Source hash covers both stages, with the vertex length between them so that
+    // moving text from one stage to the other changes the key; the driver hash
+    // invalidates binaries after driver updates
+    uint64_t vertexHash = hashString(std::to_string(vertexSource.size()) + "|", hashString(vertexSource));
+    uint64_t sourceHash = hashString(fragmentSource, vertexHash);
+    uint64_t driverHash = hashDriver();
+    bool useCache = m_binaryCacheEnabled && g_gl.binarySupported;
+    std::string cachePath = getCachePath(sourceHash);
+
+    if (useCache && loadCachedBinary(cachePath, driverHash, sourceHash)) {
+        m_loadedFromCache = true;
+    } else {
+        GLuint vertexShader = compileStage(SHADER_VERTEX, vertexSource, vertexPath);
+        GLuint fragmentShader = compileStage(SHADER_FRAGMENT, fragmentSource, fragmentPath);
+        if (vertexShader != 0 && fragmentShader != 0) {
+            m_program = linkProgram(vertexShader, fragmentShader);
+        }
+        if (vertexShader != 0) g_gl.deleteShader(vertexShader);
+        if (fragmentShader != 0) g_gl.deleteShader(fragmentShader);
+
+        if (m_program != 0 && useCache) {
+            saveCachedBinary(cachePath, driverHash, sourceHash);
+        }
+    }
+
+    auto endTime = std::chrono::high_resolution_clock::now();
+    m_loadTimeMs = std::chrono::duration<double, std::milli>(endTime - startTime).count();
+
+    if (m_program != 0) {
+        std::cout << "[SHADER] Loaded " << vertexPath << " + " << fragmentPath
+                  << (m_loadedFromCache ? " from binary cache" : " (compiled)")
+                  << " in " << std::fixed << std::setprecision(2) << m_loadTimeMs << " ms" << std::endl;
+    }
+
+    return m_program != 0;
+}
+
+void Shader::destroy() {
+    if (m_program != 0 && g_gl.deleteProgram) {
+        g_gl.deleteProgram(m_program);
+    }
+    m_program = 0;
+}
+
+void Shader::use() const {
+    if (m_program != 0) g_gl.useProgram(m_program);
+}
+
+void Shader::release() const {
+    if (m_program != 0) g_gl.useProgram(0);
+}
+
+GLuint Shader::compileStage(GLenum type, const std::string& source, const std::string& path) {
+    GLuint shader = g_gl.createShader(type);
+    const char* sourcePtr = source.c_str();
+    g_gl.shaderSource(shader, 1, &sourcePtr, nullptr);
+    g_gl.compileShader(shader);
+
+    GLint status = GL_FALSE;
+    g_gl.getShaderiv(shader, SHADER_COMPILE_STATUS, &status);
+    if (status != GL_TRUE) {
+        GLint logLength = 0;
+        g_gl.getShaderiv(shader, SHADER_INFO_LOG_LENGTH, &logLength);
+        std::vector<char> log(std::max(logLength, 1));
+        g_gl.getShaderInfoLog(shader, static_cast<GLsizei>(log.size()), nullptr, log.data());
+        std::cerr << "[SHADER] Failed to compile " << path << ": " << log.data() << std::endl;
+        g_gl.deleteShader(shader);
+        return 0;
+    }
+
+    return shader;
+}
+
+GLuint Shader::linkProgram(GLuint vertexShader, GLuint fragmentShader) {
+    GLuint program = g_gl.createProgram();
+    if (m_binaryCacheEnabled && g_gl.binarySupported) {
+        g_gl.programParameteri(program, PROGRAM_BINARY_RETRIEVABLE, GL_TRUE);
+    }
+
+    g_gl.attachShader(program, vertexShader);
+    g_gl.attachShader(program, fragmentShader);
+    g_gl.linkProgram(program);
+    g_gl.detachShader(program, vertexShader);
+    g_gl.detachShader(program, fragmentShader);
+
+    GLint status = GL_FALSE;
+    g_gl.getProgramiv(program, SHADER_LINK_STATUS, &status);
+    if (status != GL_TRUE) {
+        GLint logLength = 0;
+        g_gl.getProgramiv(program, SHADER_INFO_LOG_LENGTH, &logLength);
+        std::vector<char> log(std::max(logLength, 1));
+        g_gl.getProgramInfoLog(program, static_cast<GLsizei>(log.size()), nullptr, log.data());
+        std::cerr << "[SHADER] Failed to link program: " << log.data() << std::endl;
+        g_gl.deleteProgram(program);
+        return 0;
+    }
+
+    return program;
+}
+
+bool Shader::loadCachedBinary(const std::string& cachePath, uint64_t driverHash, uint64_t sourceHash) {
+    std::ifstream file(cachePath, std::ios::binary);
+    if (!file.is_open()) return false;
+
+    CacheHeader header;
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(header))) return false;
+    if (std::string(header.magic, 4) != std::string(CACHE_MAGIC, 4) ||
+        header.version != CACHE_VERSION ||
+        header.driverHash != driverHash ||
+        header.sourceHash != sourceHash ||
+        header.binaryLength == 0) {
+        return false;
+    }
+
+    std::vector<char> binary(header.binaryLength);
+    if (!file.read(binary.data(), binary.size())) return false;
+
+    GLuint program = g_gl.createProgram();
+    g_gl.programBinary(program, header.binaryFormat, binary.data(), static_cast<GLsizei>(binary.size()));
+
+    // Drivers reject stale binaries by failing the link status rather than erroring
+    GLint status = GL_FALSE;
+    g_gl.getProgramiv(program, SHADER_LINK_STATUS, &status);
+    if (status != GL_TRUE) {
+        std::cout << "[SHADER] Cached program binary rejected by driver, recompiling" << std::endl;
+        g_gl.deleteProgram(program);
+        return false;
+    }
+
+    m_program = program;
+    return true;
+}
+
+void Shader::saveCachedBinary(const std::string& cachePath, uint64_t driverHash, uint64_t sourceHash) {
+    GLint length = 0;
+    g_gl.getProgramiv(m_program, PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0) return;
+
+    std::vector<char> binary(length);
+    GLenum format = 0;
+    GLsizei written = 0;
+    g_gl.getProgramBinary(m_program, length, &written, &format, binary.data());
+    if (written <= 0) return;
+
+    std::error_code error;
+    std::filesystem::create_directories(m_cacheDirectory, error);
+
+    // Write to a temporary file first so a crash never leaves a truncated cache entry
+    std::string tempPath = cachePath + ".tmp";
+    std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        std::cerr << "[SHADER] Failed to write program binary cache: " << tempPath << std::endl;
+        return;
+    }
+
+    CacheHeader header;
+    std::copy(CACHE_MAGIC, CACHE_MAGIC + 4, header.magic);
+    header.version = CACHE_VERSION;
+    header.driverHash = driverHash;
+    header.sourceHash = sourceHash;
+    header.binaryFormat = format;
+    header.binaryLength = static_cast<uint32_t>(written);
+
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(binary.data(), written);
+    file.close();
+
+    std::filesystem::rename(tempPath, cachePath, error);
+}
+
+std::string Shader::getCachePath(uint64_t sourceHash) const {
+    std::stringstream ss;
+    ss << m_cacheDirectory << "/program_" << std::hex << std::setw(16) << std::setfill('0') << sourceHash << ".bin";
+    return ss.str();
+}
+
+bool Shader::readFile(const std::string& path, std::string& contents) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        std::cerr << "[SHADER] Failed to open shader file: " << path << std::endl;
+        return false;
+    }
+
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    contents = buffer.str();
+    return true;
+}
+
+uint64_t Shader::hashString(const std::string& text, uint64_t seed) {
+    // FNV-1a, 64-bit
+    uint64_t hash = seed;
+    for (unsigned char c : text) {
+        hash ^= c;
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+uint64_t Shader::hashDriver() {
+    auto glString = [](GLenum name) {
+        const GLubyte* value = glGetString(name);
+        return value ? std::string(reinterpret_cast<const char*>(value)) : std::string();
+    };
+
+    return hashString(glString(GL_VENDOR) + "|" + glString(GL_RENDERER) + "|" + glString(GL_VERSION));
+}
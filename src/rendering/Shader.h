@@ -0,0 +1,53 @@
+#ifndef SHADER_H
+#define SHADER_H
+
+#include <GLFW/glfw3.h>
+#include <cstdint>
+#include <string>
+
+class Shader {
+public:
+    Shader();
+    ~Shader();
+
+    // Loading - tries the program binary cache first, compiles GLSL on a miss
+    bool loadFromFiles(const std::string& vertexPath, const std::string& fragmentPath);
+    void destroy();
+
+    // Binding
+    void use() const;
+    void release() const;
+    bool isValid() const { return m_program != 0; }
+    GLuint getProgram() const { return m_program; }
+
+    // Binary cache configuration
+    void setCacheDirectory(const std::string& directory) { m_cacheDirectory = directory; }
+    void setBinaryCacheEnabled(bool enabled) { m_binaryCacheEnabled = enabled; }
+
+    // Load statistics
+    bool wasLoadedFromCache() const { return m_loadedFromCache; }
+    double getLoadTime() const { return m_loadTimeMs; } // milliseconds
+
+private:
+    GLuint m_program;
+    std::string m_cacheDirectory;
+    bool m_binaryCacheEnabled;
+    bool m_loadedFromCache;
+    double m_loadTimeMs;
+
+    // Compilation
+    GLuint compileStage(GLenum type, const std::string& source, const std::string& path);
+    GLuint linkProgram(GLuint vertexShader, GLuint fragmentShader);
+
+    // Program binary cache (keyed on driver identity and shader source hash)
+    bool loadCachedBinary(const std::string& cachePath, uint64_t driverHash, uint64_t sourceHash);
+    void saveCachedBinary(const std::string& cachePath, uint64_t driverHash, uint64_t sourceHash);
+    std::string getCachePath(uint64_t sourceHash) const;
+
+    // Helpers
+    static bool readFile(const std::string& path, std::string& contents);
+    static uint64_t hashString(const std::string& text, uint64_t seed = 14695981039346656037ULL);
+    static uint64_t hashDriver();
+};
+
+#endif // SHADER_H
@@ -0,0 +1,95 @@
+#include "CounterRNG.h"
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+// Natural log for x in (0, 1]: exponent from the bits, mantissa folded into
+// [sqrt(1/2), sqrt(2)) and an atanh series (|s| < 0.172, five terms)
+inline float logUnit(float x) {
+    uint32_t bits;
+    std::memcpy(&bits, &x, sizeof(bits));
+    int exponent = static_cast<int>(bits >> 23) - 127;
+    uint32_t mantissaBits = (bits & 0x007FFFFFu) | 0x3F800000u;
+    float mantissa;
+    std::memcpy(&mantissa, &mantissaBits, sizeof(mantissa));
+    bool fold = mantissa > 1.41421356f;
+    mantissa = fold ? 0.5f * mantissa : mantissa;
+    exponent += fold ? 1 : 0;
+
+    float s = (mantissa - 1.0f) / (mantissa + 1.0f);
+    float s2 = s * s;
+    float series = 1.0f + s2 * (1.0f / 3.0f + s2 * (1.0f / 5.0f + s2 * (1.0f / 7.0f + s2 * (1.0f / 9.0f))));
+    return static_cast<float>(exponent) * 0.693147181f + 2.0f * s * series;
+}
+
+// Ten Philox rounds on BATCH_SIZE lanes. Separate restrict arrays let the lane
+// loop vectorize (the 32x32->64 products become widening vector multiplies).
+void philoxRounds(uint32_t* __restrict c0, uint32_t* __restrict c1, uint32_t* __restrict c2, uint32_t* __restrict c3,
+                  uint32_t k0, uint32_t k1) {
+    for (int round = 0; round < 10; ++round) {
+        for (int lane = 0; lane < CounterRNG::BATCH_SIZE; ++lane) {
+            uint64_t product0 = static_cast<uint64_t>(PHILOX_MULTIPLIER_0) * c0[lane];
+            uint64_t product1 = static_cast<uint64_t>(PHILOX_MULTIPLIER_1) * c2[lane];
+            uint32_t next0 = static_cast<uint32_t>(product1 >> 32) ^ c1[lane] ^ k0;
+            uint32_t next2 = static_cast<uint32_t>(product0 >> 32) ^ c3[lane] ^ k1;
+            c1[lane] = static_cast<uint32_t>(product1);
+            c3[lane] = static_cast<uint32_t>(product0);
+            c0[lane] = next0;
+            c2[lane] = next2;
+        }
+        k0 += PHILOX_WEYL_0;
+        k1 += PHILOX_WEYL_1;
+    }
+}
+
+} // namespace
+
+void CounterRNG::philoxBatch(uint64_t key, uint64_t stream, uint32_t firstCounter, uint32_t out[4][BATCH_SIZE]) {
+    uint32_t c0[BATCH_SIZE], c1[BATCH_SIZE], c2[BATCH_SIZE], c3[BATCH_SIZE];
+    for (int lane = 0; lane < BATCH_SIZE; ++lane) {
+        c0[lane] = firstCounter + static_cast<uint32_t>(lane);
+        c1[lane] = 0;
+        c2[lane] = static_cast<uint32_t>(stream);
+        c3[lane] = static_cast<uint32_t>(stream >> 32);
+    }
+    philoxRounds(c0, c1, c2, c3, static_cast<uint32_t>(key), static_cast<uint32_t>(key >> 32));
+    for (int lane = 0; lane < BATCH_SIZE; ++lane) {
+        out[0][lane] = c0[lane];
+        out[1][lane] = c1[lane];
+        out[2][lane] = c2[lane];
+        out[3][lane] = c3[lane];
+    }
+}
+
+void CounterRNG::gaussianBatch(uint64_t key, uint64_t stream, uint32_t firstCounter,
+                               float* __restrict first, float* __restrict second) {
+    uint32_t bits[4][BATCH_SIZE];
+    philoxBatch(key, stream, firstCounter, bits);
+
+    const float halfPi = 1.57079633f;
+    for (int lane = 0; lane < BATCH_SIZE; ++lane) {
+        // Radius from a uniform in (0, 1], so the log is finite
+        float uniform = static_cast<float>((bits[0][lane] >> 8) + 1) * (1.0f / 16777216.0f);
+        float radius = std::sqrt(-2.0f * logUnit(uniform));
+
+        // Angle: the top two bits pick a quadrant, the next 22 an offset r in
+        // [-pi/4, pi/4). The pair is rotation invariant, so quadrant q plus r
+        // needs no further shift. Taylor series of sin / cos are exact to
+        // float precision on that interval.
+        uint32_t angleBits = bits[1][lane];
+        uint32_t quadrant = angleBits >> 30;
+        float r = (static_cast<float>((angleBits >> 8) & 0x3FFFFFu) * (1.0f / 4194304.0f) - 0.5f) * halfPi;
+        float r2 = r * r;
+        float sine = r * (1.0f + r2 * (-1.0f / 6.0f + r2 * (1.0f / 120.0f + r2 * (-1.0f / 5040.0f + r2 * (1.0f / 362880.0f)))));
+        float cosine = 1.0f + r2 * (-0.5f + r2 * (1.0f / 24.0f + r2 * (-1.0f / 720.0f + r2 * (1.0f / 40320.0f))));
+
+        // Rotate (cos r, sin r) by quadrant * 90 degrees
+        bool swap = (quadrant & 1u) != 0;
+        float x = swap ? -sine : cosine;
+        float y = swap ? cosine : sine;
+        bool negate = (quadrant & 2u) != 0;
+        first[lane] = radius * (negate ? -x : x);
+        second[lane] = radius * (negate ? -y : y);
+    }
+}
@@ -0,0 +1,93 @@
+#ifndef COUNTER_RNG_H
+#define COUNTER_RNG_H
+
+#include <cstdint>
+
+// Philox4x32 round multipliers and key increments (Weyl sequence)
+const uint32_t PHILOX_MULTIPLIER_0 = 0xD2511F53u;
+const uint32_t PHILOX_MULTIPLIER_1 = 0xCD9E8D57u;
+const uint32_t PHILOX_WEYL_0 = 0x9E3779B9u;
+const uint32_t PHILOX_WEYL_1 = 0xBB67AE85u;
+
+// Counter-based random numbers (Philox4x32-10, Salmon et al., SC'11).
+// Each output block is a pure function of (key, counter): no state is carried
+// from one draw to the next. A stream identified by (key, stream) can
+// therefore be started anywhere without generating what came before. Giving
+// every independent work item its own stream (e.g. (step, cell)) makes
+// parallel results independent of the thread count and of scheduling order.
+//
+// The batch functions evaluate BATCH_SIZE consecutive counters at once with
+// lane-major loops and polynomial log / sin / cos, so they compile to SIMD
+// code (see CounterRNG.cpp).
+class CounterRNG {
+public:
+    struct Block {
+        uint32_t value[4];
+    };
+
+    static const int BATCH_SIZE = 16;
+
+    // Philox blocks for counters {firstCounter + lane, 0, stream, stream >> 32}
+    // under `key`: word w of lane l goes to out[w][l]
+    static void philoxBatch(uint64_t key, uint64_t stream, uint32_t firstCounter, uint32_t out[4][BATCH_SIZE]);
+    // Two standard normals per lane from the same counters (Box-Muller on the
+    // first two words; the polar angle comes straight from integer bits).
+    // Absolute error of the transform is below 1e-6.
+    static void gaussianBatch(uint64_t key, uint64_t stream, uint32_t firstCounter,
+                              float* first, float* second);
+
+    // The Philox4x32-10 bijection
+    static Block philox(const uint32_t counter[4], const uint32_t key[2]) {
+        uint32_t c0 = counter[0], c1 = counter[1], c2 = counter[2], c3 = counter[3];
+        uint32_t k0 = key[0], k1 = key[1];
+        for (int round = 0; round < 10; ++round) {
+            uint64_t product0 = static_cast<uint64_t>(PHILOX_MULTIPLIER_0) * c0;
+            uint64_t product1 = static_cast<uint64_t>(PHILOX_MULTIPLIER_1) * c2;
+            uint32_t hi0 = static_cast<uint32_t>(product0 >> 32), lo0 = static_cast<uint32_t>(product0);
+            uint32_t hi1 = static_cast<uint32_t>(product1 >> 32), lo1 = static_cast<uint32_t>(product1);
+            c0 = hi1 ^ c1 ^ k0;
+            c1 = lo1;
+            c2 = hi0 ^ c3 ^ k1;
+            c3 = lo0;
+            k0 += PHILOX_WEYL_0;
+            k1 += PHILOX_WEYL_1;
+        }
+        return Block{{c0, c1, c2, c3}};
+    }
+
+    // Sequential draws from stream `stream` of generator `key`
+    CounterRNG(uint64_t key, uint64_t stream)
+        : m_key{static_cast<uint32_t>(key), static_cast<uint32_t>(key >> 32)}
+        , m_stream(stream)
+        , m_blockIndex(0)
+        , m_used(4) {
+    }
+
+    uint32_t nextUInt() {
+        if (m_used == 4) {
+            const uint32_t counter[4] = {static_cast<uint32_t>(m_blockIndex), static_cast<uint32_t>(m_blockIndex >> 32),
+                                         static_cast<uint32_t>(m_stream), static_cast<uint32_t>(m_stream >> 32)};
+            m_block = philox(counter, m_key);
+            m_blockIndex++;
+            m_used = 0;
+        }
+        return m_block.value[m_used++];
+    }
+
+    // Uniform in [0, 1), 24 random bits
+    float nextFloat() { return static_cast<float>(nextUInt() >> 8) * (1.0f / 16777216.0f); }
+
+    // Uniform in [0, bound), bound > 0 (multiply-shift, no division)
+    uint32_t nextBelow(uint32_t bound) {
+        return static_cast<uint32_t>((static_cast<uint64_t>(nextUInt()) * bound) >> 32);
+    }
+
+private:
+    uint32_t m_key[2];
+    uint64_t m_stream;
+    uint64_t m_blockIndex;
+    Block m_block;
+    int m_used;
+};
+
+#endif // COUNTER_RNG_H
@@ -0,0 +1,131 @@
+#include "FlightRecorder.h"
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+FlightRecorder::FlightRecorder(size_t maxFrames, size_t maxEvents)
+    : m_events(std::max<size_t>(1, maxEvents))
+    , m_eventCount(0)
+    , m_frames(std::max<size_t>(1, maxFrames))
+    , m_frameCount(0)
+    , m_frameStartEvent(0)
+    , m_spikeFactor(3.0)
+    , m_dumpFrames(60)
+    , m_medianFrameTime(0.0)
+    , m_cooldownUntil(0)
+    , m_outputPrefix("output/flight_recorder")
+    , m_maxDumps(10)
+    , m_dumpCount(0) {
+    m_medianScratch.reserve(MEDIAN_WINDOW);
+}
+
+void FlightRecorder::setTrigger(double spikeFactor, size_t dumpFrames) {
+    m_spikeFactor = spikeFactor;
+    m_dumpFrames = std::max<size_t>(1, std::min(dumpFrames, m_frames.size()));
+}
+
+void FlightRecorder::recordScope(uint32_t scopeId, const std::string& name, size_t threadIndex, double startMs, double durationMs) {
+    // Names are copied once, the first time an id shows up
+    if (scopeId >= m_scopeNames.size()) {
+        m_scopeNames.resize(scopeId + 1);
+    }
+    if (m_scopeNames[scopeId].empty()) {
+        m_scopeNames[scopeId] = name;
+    }
+
+    m_events[m_eventCount % m_events.size()] = {scopeId, static_cast<uint32_t>(threadIndex), startMs, durationMs};
+    m_eventCount++;
+}
+
+bool FlightRecorder::endFrame(int frameNumber, double frameTimeMs, const FrameState& state) {
+    FrameRecord& record = m_frames[m_frameCount % m_frames.size()];
+    record.frameNumber = frameNumber;
+    record.frameTimeMs = frameTimeMs;
+    record.state = state;
+    record.firstEvent = m_frameStartEvent;
+    record.endEvent = m_eventCount;
+    m_frameStartEvent = m_eventCount;
+    m_frameCount++;
+
+    // Median of the frames before this one, so the spike does not raise its own bar
+    if (m_frameCount <= MIN_FRAMES_FOR_TRIGGER) return false;
+    m_medianFrameTime = computeMedian();
+
+    bool spike = frameTimeMs > m_spikeFactor * m_medianFrameTime;
+    if (!spike || m_frameCount < m_cooldownUntil || m_dumpCount >= m_maxDumps) return false;
+
+    // One dump per window: the next spike has to be outside the frames just written
+    m_cooldownUntil = m_frameCount + m_dumpFrames;
+    return dump(record);
+}
+
+double FlightRecorder::computeMedian() {
+    size_t available = std::min<uint64_t>(m_frameCount - 1, std::min(MEDIAN_WINDOW, m_frames.size() - 1));
+    m_medianScratch.clear();
+    for (size_t i = 0; i < available; ++i) {
+        uint64_t frame = m_frameCount - 2 - i;
+        m_medianScratch.push_back(m_frames[frame % m_frames.size()].frameTimeMs);
+    }
+    if (m_medianScratch.empty()) return 0.0;
+
+    auto middle = m_medianScratch.begin() + m_medianScratch.size() / 2;
+    std::nth_element(m_medianScratch.begin(), middle, m_medianScratch.end());
+    return *middle;
+}
+
+bool FlightRecorder::dump(const FrameRecord& spike) {
+    std::ostringstream name;
+    name << m_outputPrefix << "_" << spike.frameNumber << ".json";
+    std::string filename = name.str();
+
+    std::ofstream file(filename);
+    if (!file.is_open()) {
+        std::cerr << "Failed to open flight recorder file: " << filename << std::endl;
+        return false;
+    }
+
+    size_t frameCount = std::min<uint64_t>(m_dumpFrames, m_frameCount);
+    uint64_t firstFrame = m_frameCount - frameCount;
+    uint64_t oldestEvent = m_eventCount > m_events.size() ? m_eventCount - m_events.size() : 0;
+
+    file << std::fixed << std::setprecision(3);
+    file << "{\n";
+    file << "  \"trigger\": {\"frame\": " << spike.frameNumber << ", \"frame_time_ms\": " << spike.frameTimeMs
+         << ", \"median_frame_time_ms\": " << m_medianFrameTime << ", \"spike_factor\": " << m_spikeFactor << "},\n";
+
+    file << "  \"frames\": [\n";
+    for (uint64_t f = firstFrame; f < m_frameCount; ++f) {
+        const FrameRecord& record = m_frames[f % m_frames.size()];
+        file << "    {\"frame\": " << record.frameNumber
+             << ", \"frame_time_ms\": " << record.frameTimeMs
+             << ", \"particles\": " << record.state.particleCount
+             << ", \"contacts\": " << record.state.contactCount
+             << ", \"export_queued_frames\": " << record.state.exportQueuedFrames
+             << ", \"export_queue_capacity\": " << record.state.exportQueueCapacity
+             << ", \"export_bytes\": " << record.state.exportBytes
+             << ", \"events_complete\": " << (record.firstEvent >= oldestEvent ? "true" : "false") << "}"
+             << (f + 1 < m_frameCount ? "," : "") << "\n";
+    }
+    file << "  ],\n";
+
+    // Chrome trace "complete" events, timestamps in microseconds
+    file << "  \"traceEvents\": [";
+    const FrameRecord& first = m_frames[firstFrame % m_frames.size()];
+    bool firstEvent = true;
+    for (uint64_t e = std::max(first.firstEvent, oldestEvent); e < m_eventCount; ++e) {
+        const ScopeEvent& event = m_events[e % m_events.size()];
+        file << (firstEvent ? "\n" : ",\n");
+        file << "    {\"name\": \"" << m_scopeNames[event.scopeId] << "\", \"ph\": \"X\", \"pid\": 0, \"tid\": "
+             << event.threadIndex << ", \"ts\": " << event.startMs * 1000.0 << ", \"dur\": " << event.durationMs * 1000.0 << "}";
+        firstEvent = false;
+    }
+    file << "\n  ]\n";
+    file << "}\n";
+    file.close();
+
+    m_dumpCount++;
+    m_lastDumpFile = filename;
+    return true;
+}
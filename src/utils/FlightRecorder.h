@@ -0,0 +1,91 @@
+#ifndef FLIGHT_RECORDER_H
+#define FLIGHT_RECORDER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Always-on ring of recent profiler scope events and per-frame state. When a
+// frame takes more than spikeFactor x the median of recent frames, the last
+// dumpFrames frames (their scope timeline and state) are written to
+// "<prefix>_<frame>.json" in Chrome trace format (chrome://tracing, Perfetto),
+// so intermittent stalls can be looked at after the run.
+//
+// Events arrive from PerformanceProfiler::flush() (attach with
+// setFlightRecorder()); everything runs on the frame-loop thread.
+class FlightRecorder {
+public:
+    // What the app knew about the frame when it ended
+    struct FrameState {
+        int particleCount;
+        size_t contactCount;
+        size_t exportQueuedFrames;   // JSONExporter frames held in memory
+        size_t exportQueueCapacity;
+        size_t exportBytes;
+    };
+
+    FlightRecorder(size_t maxFrames = 240, size_t maxEvents = 65536);
+
+    // Configuration
+    void setTrigger(double spikeFactor, size_t dumpFrames);
+    void setOutputPrefix(const std::string& prefix) { m_outputPrefix = prefix; }
+    void setMaxDumps(size_t maxDumps) { m_maxDumps = maxDumps; }
+
+    // Recording
+    void recordScope(uint32_t scopeId, const std::string& name, size_t threadIndex, double startMs, double durationMs);
+    // Closes the frame; returns true if it was a spike and a dump was written
+    bool endFrame(int frameNumber, double frameTimeMs, const FrameState& state);
+
+    // Diagnostics
+    double getMedianFrameTime() const { return m_medianFrameTime; }
+    size_t getDumpCount() const { return m_dumpCount; }
+    const std::string& getLastDumpFile() const { return m_lastDumpFile; }
+
+private:
+    struct ScopeEvent {
+        uint32_t scopeId;
+        uint32_t threadIndex;
+        double startMs;
+        double durationMs;
+    };
+
+    struct FrameRecord {
+        int frameNumber;
+        double frameTimeMs;
+        FrameState state;
+        uint64_t firstEvent; // event sequence numbers [firstEvent, endEvent)
+        uint64_t endEvent;
+    };
+
+    // Rings (fixed size, overwritten oldest first)
+    std::vector<ScopeEvent> m_events;
+    uint64_t m_eventCount;
+    std::vector<FrameRecord> m_frames;
+    uint64_t m_frameCount;
+    uint64_t m_frameStartEvent;
+    std::vector<std::string> m_scopeNames; // indexed by profiler scope id
+
+    // Trigger
+    double m_spikeFactor;
+    size_t m_dumpFrames;
+    double m_medianFrameTime;
+    uint64_t m_cooldownUntil;
+    std::vector<double> m_medianScratch;
+
+    // Output
+    std::string m_outputPrefix;
+    size_t m_maxDumps;
+    size_t m_dumpCount;
+    std::string m_lastDumpFile;
+
+    // Frames of history needed before the median is trusted
+    static const size_t MIN_FRAMES_FOR_TRIGGER = 30;
+    // Frames the median is taken over
+    static const size_t MEDIAN_WINDOW = 120;
+
+    double computeMedian();
+    bool dump(const FrameRecord& spike);
+};
+
+#endif // FLIGHT_RECORDER_H
@@ -0,0 +1,106 @@
+#include "HardwareCounters.h"
+#include <iostream>
+
+#ifdef __linux__
+#include <cstring>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace {
+
+int openCounter(uint32_t type, uint64_t config, int groupFd) {
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.disabled = groupFd < 0 ? 1 : 0; // the group leader gates the whole group
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP;
+    return static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, groupFd, 0));
+}
+
+uint64_t l1dConfig(uint64_t result) {
+    return PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (result << 16);
+}
+
+} // namespace
+#endif
+
+HardwareCounters::HardwareCounters()
+    : m_groupFd(-1) {
+    for (int i = 0; i < COUNTER_COUNT; ++i) m_fds[i] = -1;
+}
+
+HardwareCounters::~HardwareCounters() {
+    close();
+}
+
+bool HardwareCounters::open() {
+    if (isAvailable()) return true;
+
+#ifdef __linux__
+    m_fds[0] = openCounter(PERF_TYPE_HW_CACHE, l1dConfig(PERF_COUNT_HW_CACHE_RESULT_ACCESS), -1);
+    if (m_fds[0] < 0) {
+        std::cerr << "[COUNTERS] perf_event_open failed (check /proc/sys/kernel/perf_event_paranoid)" << std::endl;
+        return false;
+    }
+    m_groupFd = m_fds[0];
+    m_fds[1] = openCounter(PERF_TYPE_HW_CACHE, l1dConfig(PERF_COUNT_HW_CACHE_RESULT_MISS), m_groupFd);
+    m_fds[2] = openCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_REFERENCES, m_groupFd);
+    m_fds[3] = openCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES, m_groupFd);
+
+    for (int i = 1; i < COUNTER_COUNT; ++i) {
+        if (m_fds[i] < 0) {
+            std::cerr << "[COUNTERS] Cache counters not supported on this CPU" << std::endl;
+            close();
+            return false;
+        }
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
+void HardwareCounters::close() {
+#ifdef __linux__
+    for (int i = COUNTER_COUNT - 1; i >= 0; --i) {
+        if (m_fds[i] >= 0) ::close(m_fds[i]);
+        m_fds[i] = -1;
+    }
+#endif
+    m_groupFd = -1;
+}
+
+void HardwareCounters::start() {
+#ifdef __linux__
+    if (!isAvailable()) return;
+    ioctl(m_groupFd, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(m_groupFd, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+#endif
+}
+
+HardwareCounters::Sample HardwareCounters::stop() {
+    Sample sample = {0, 0, 0, 0, false};
+
+#ifdef __linux__
+    if (!isAvailable()) return sample;
+    ioctl(m_groupFd, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+
+    // PERF_FORMAT_GROUP layout: { nr, values[nr] }
+    uint64_t buffer[1 + COUNTER_COUNT] = {0};
+    if (read(m_groupFd, buffer, sizeof(buffer)) == static_cast<ssize_t>(sizeof(buffer)) && buffer[0] == COUNTER_COUNT) {
+        sample.l1dAccesses = buffer[1];
+        sample.l1dMisses = buffer[2];
+        sample.cacheReferences = buffer[3];
+        sample.cacheMisses = buffer[4];
+        sample.valid = true;
+    }
+#endif
+
+    return sample;
+}
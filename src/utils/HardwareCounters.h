@@ -0,0 +1,43 @@
+#ifndef HARDWARE_COUNTERS_H
+#define HARDWARE_COUNTERS_H
+
+#include <cstdint>
+
+// Cache-miss counters read through perf_event_open on Linux.
+// On other platforms (or when perf events are not permitted) open() returns
+// false and samples come back with valid == false.
+class HardwareCounters {
+public:
+    struct Sample {
+        uint64_t l1dAccesses;
+        uint64_t l1dMisses;
+        uint64_t cacheReferences; // last-level cache
+        uint64_t cacheMisses;
+        bool valid;
+
+        double l1dMissRate() const { return l1dAccesses ? static_cast<double>(l1dMisses) / l1dAccesses : 0.0; }
+        double cacheMissRate() const { return cacheReferences ? static_cast<double>(cacheMisses) / cacheReferences : 0.0; }
+    };
+
+    HardwareCounters();
+    ~HardwareCounters();
+
+    HardwareCounters(const HardwareCounters&) = delete;
+    HardwareCounters& operator=(const HardwareCounters&) = delete;
+
+    bool open();
+    void close();
+    bool isAvailable() const { return m_groupFd >= 0; }
+
+    // Counts only the calling thread between start() and stop()
+    void start();
+    Sample stop();
+
+private:
+    static const int COUNTER_COUNT = 4;
+
+    int m_groupFd;
+    int m_fds[COUNTER_COUNT];
+};
+
+#endif // HARDWARE_COUNTERS_H
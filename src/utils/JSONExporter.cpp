@@ -17,7 +17,8 @@ JSONExporter::~JSONExporter() {
     }
 }
 
-void JSONExporter::captureFrame(const ParticleSystem& system, double timestamp, int frameNumber, float fps) {
+template <typename Precision>
+void JSONExporter::captureFrame(const BasicParticleSystem<Precision>& system, double timestamp, int frameNumber, float fps) {
     SimulationFrame frame;
     frame.timestamp = timestamp;
     frame.frameNumber = frameNumber;
@@ -57,6 +58,10 @@ void JSONExporter::captureFrame(const ParticleSystem& system, double timestamp,
     }
 }
 
+template void JSONExporter::captureFrame(const BasicParticleSystem<FloatPrecision>&, double, int, float);
+template void JSONExporter::captureFrame(const BasicParticleSystem<DoublePrecision>&, double, int, float);
+template void JSONExporter::captureFrame(const BasicParticleSystem<MixedPrecision>&, double, int, float);
+
 void JSONExporter::addCustomData(const std::string& key, const std::string& value) {
     m_customData.push_back({key, value});
 }
@@ -30,7 +30,8 @@ public:
     ~JSONExporter();
     
     // Data collection
-    void captureFrame(const ParticleSystem& system, double timestamp, int frameNumber, float fps);
+    template <typename Precision>
+    void captureFrame(const BasicParticleSystem<Precision>& system, double timestamp, int frameNumber, float fps);
     void addCustomData(const std::string& key, const std::string& value);
     
     // Export functions
@@ -40,6 +41,7 @@ public:
     // Data management
     void clearData();
     size_t getFrameCount() const { return m_frames.size(); }
+    size_t getMaxFrames() const { return m_maxFrames; }
     
     // Configuration
     void setMaxFrames(size_t maxFrames) { m_maxFrames = maxFrames; }
@@ -1,4 +1,5 @@
 #include "PerformanceProfiler.h"
+#include "FlightRecorder.h"
 #include <iostream>
 #include <fstream>
 #include <iomanip>
@@ -6,37 +7,197 @@
 #include <algorithm>
 #include <numeric>
 
+// Per-thread state. Only the owning thread touches the interned-name caches and
+// open timers; the ring is single-producer (owner) / single-consumer (flush()).
+struct PerformanceProfiler::ThreadBuffer {
+    struct ScopeEvent {
+        uint32_t scopeId;
+        uint64_t startTicks;
+        uint64_t durationTicks; // converted to milliseconds by flush()
+    };
+    
+    static const size_t CAPACITY = 4096; // power of two
+    
+    std::vector<ScopeEvent> events;
+    alignas(64) std::atomic<size_t> head; // next write, advanced by the owner
+    alignas(64) std::atomic<size_t> tail; // next read, advanced by flush()
+    std::atomic<uint64_t> dropped;
+    
+    std::unordered_map<const char*, uint32_t> literalIds;
+    std::unordered_map<std::string, uint32_t> stringIds;
+    std::unordered_map<uint32_t, uint64_t> startTimes; // ticks
+    
+    ThreadBuffer() : events(CAPACITY), head(0), tail(0), dropped(0) {}
+    
+    void push(uint32_t scopeId, uint64_t startTicks, uint64_t durationTicks) {
+        size_t writeIndex = head.load(std::memory_order_relaxed);
+        if (writeIndex - tail.load(std::memory_order_acquire) == CAPACITY) {
+            // Nobody flushed for a long time; count the loss rather than block
+            dropped.store(dropped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            return;
+        }
+        events[writeIndex & (CAPACITY - 1)] = {scopeId, startTicks, durationTicks};
+        head.store(writeIndex + 1, std::memory_order_release);
+    }
+};
+
+namespace {
+
+// This thread's buffer in each live profiler. Instance ids are never reused, so
+// entries left behind by a destroyed profiler can never match a new one.
+struct ThreadBufferSlot {
+    uint64_t instanceId;
+    void* buffer;
+};
+thread_local std::vector<ThreadBufferSlot> t_threadBuffers;
+
+} // namespace
+
+std::atomic<uint64_t> PerformanceProfiler::s_nextInstanceId(1);
+
 PerformanceProfiler::PerformanceProfiler()
-    : m_lastFrameTime(0.0)
+    : m_instanceId(s_nextInstanceId.fetch_add(1))
+    , m_timerSource(TimerSource::Chrono)
+    , m_millisecondsPerTick(1e-6)
+    , m_epochTicks(0)
+    , m_flightRecorder(nullptr)
+    , m_lastFrameTime(0.0)
     , m_currentFPS(0.0f)
     , m_currentParticleCount(0)
     , m_currentPhysicsSteps(0)
+    , m_timeToFirstFrame(0.0)
     , m_targetFPS(60.0f)
-    , m_targetPhysicsSteps(100) {
+    , m_targetPhysicsSteps(100)
+    , m_targetStartupTime(1000.0) {
+    m_epochTicks = now();
+}
+
+bool PerformanceProfiler::setTimerSource(TimerSource source) {
+    if (source == TimerSource::Tsc && !TscClock::isAvailable()) {
+        std::cerr << "Invariant TSC not available, profiler keeps the chrono timer" << std::endl;
+        return false;
+    }
+    
+    // Flush first so events already recorded are converted with their own clock
+    flush();
+    m_timerSource = source;
+    m_millisecondsPerTick = source == TimerSource::Tsc ? TscClock::getMillisecondsPerTick() : 1e-6;
+    m_epochTicks = now();
+    return true;
 }
 
 PerformanceProfiler::~PerformanceProfiler() {
     // Optional: auto-export on destruction
 }
 
+PerformanceProfiler::ThreadBuffer& PerformanceProfiler::getThreadBuffer() {
+    for (const ThreadBufferSlot& slot : t_threadBuffers) {
+        if (slot.instanceId == m_instanceId) {
+            return *static_cast<ThreadBuffer*>(slot.buffer);
+        }
+    }
+    
+    // First use on this thread: register a buffer (once per thread, under the lock)
+    std::lock_guard<std::mutex> lock(m_registryMutex);
+    m_threadBuffers.emplace_back(new ThreadBuffer());
+    m_threadTimings.emplace_back();
+    ThreadBuffer* buffer = m_threadBuffers.back().get();
+    t_threadBuffers.push_back({m_instanceId, buffer});
+    return *buffer;
+}
+
+uint32_t PerformanceProfiler::internScope(const std::string& name) {
+    std::lock_guard<std::mutex> lock(m_registryMutex);
+    auto it = m_scopeIds.find(name);
+    if (it != m_scopeIds.end()) return it->second;
+    
+    uint32_t id = static_cast<uint32_t>(m_scopeNames.size());
+    m_scopeNames.push_back(name);
+    m_scopeIds[name] = id;
+    return id;
+}
+
+void PerformanceProfiler::bindCallSite(CallSite& site, const char* name) {
+    site.buffer = &getThreadBuffer();
+    site.scopeId = getScopeId(name);
+    site.instanceId = m_instanceId;
+}
+
+uint32_t PerformanceProfiler::getScopeId(const char* name) {
+    ThreadBuffer& buffer = getThreadBuffer();
+    auto it = buffer.literalIds.find(name);
+    if (it != buffer.literalIds.end()) return it->second;
+    
+    uint32_t id = internScope(name);
+    buffer.literalIds[name] = id;
+    return id;
+}
+
+void PerformanceProfiler::recordScope(const CallSite& site, uint64_t startTicks, uint64_t endTicks) {
+    site.buffer->push(site.scopeId, startTicks, endTicks - startTicks);
+}
+
+void PerformanceProfiler::recordScope(uint32_t scopeId, uint64_t startTicks, uint64_t endTicks) {
+    getThreadBuffer().push(scopeId, startTicks, endTicks - startTicks);
+}
+
 void PerformanceProfiler::startTimer(const std::string& name) {
-    m_startTimes[name] = std::chrono::high_resolution_clock::now();
+    ThreadBuffer& buffer = getThreadBuffer();
+    auto it = buffer.stringIds.find(name);
+    uint32_t id = it != buffer.stringIds.end() ? it->second : (buffer.stringIds[name] = internScope(name));
+    buffer.startTimes[id] = now();
 }
 
 void PerformanceProfiler::endTimer(const std::string& name) {
-    auto endTime = std::chrono::high_resolution_clock::now();
+    uint64_t endTicks = now();
     
-    auto it = m_startTimes.find(name);
-    if (it != m_startTimes.end()) {
-        auto duration = std::chrono::duration<double, std::milli>(endTime - it->second);
-        m_timingHistory[name].push_back(duration.count());
+    ThreadBuffer& buffer = getThreadBuffer();
+    auto idIt = buffer.stringIds.find(name);
+    if (idIt == buffer.stringIds.end()) return;
+    
+    auto it = buffer.startTimes.find(idIt->second);
+    if (it != buffer.startTimes.end()) {
+        buffer.push(idIt->second, it->second, endTicks - it->second);
+        buffer.startTimes.erase(it);
+    }
+}
+
+void PerformanceProfiler::flush() {
+    std::lock_guard<std::mutex> lock(m_registryMutex);
+    
+    for (size_t t = 0; t < m_threadBuffers.size(); ++t) {
+        ThreadBuffer& buffer = *m_threadBuffers[t];
+        size_t readIndex = buffer.tail.load(std::memory_order_relaxed);
+        size_t writeIndex = buffer.head.load(std::memory_order_acquire);
         
-        // Limit history size
-        if (m_timingHistory[name].size() > MAX_HISTORY_SIZE) {
-            m_timingHistory[name].erase(m_timingHistory[name].begin());
+        for (; readIndex != writeIndex; ++readIndex) {
+            const ThreadBuffer::ScopeEvent& event = buffer.events[readIndex & (ThreadBuffer::CAPACITY - 1)];
+            const std::string& name = m_scopeNames[event.scopeId];
+            double milliseconds = event.durationTicks * m_millisecondsPerTick;
+            
+            m_timingHistory[name].push_back(milliseconds);
+            
+            auto inserted = m_threadTimings[t].insert({name, ThreadScopeData{0.0, 0.0, 0}});
+            ThreadScopeData& data = inserted.first->second;
+            data.totalTime += milliseconds;
+            data.maxTime = std::max(data.maxTime, milliseconds);
+            data.callCount++;
+            
+            if (m_flightRecorder) {
+                // Signed: a scope can start before the epoch was reset by setTimerSource()
+                double startMs = static_cast<double>(static_cast<int64_t>(event.startTicks - m_epochTicks)) * m_millisecondsPerTick;
+                m_flightRecorder->recordScope(event.scopeId, name, t, startMs, milliseconds);
+            }
+        }
+        buffer.tail.store(readIndex, std::memory_order_release);
+    }
+    
+    // Limit history size (once per flush, not per event)
+    for (auto& pair : m_timingHistory) {
+        auto& history = pair.second;
+        if (history.size() > MAX_HISTORY_SIZE) {
+            history.erase(history.begin(), history.end() - MAX_HISTORY_SIZE);
         }
-        
-        m_startTimes.erase(it);
     }
 }
 
@@ -53,6 +214,8 @@ void PerformanceProfiler::endFrame() {
     if (m_frameTimeHistory.size() > MAX_HISTORY_SIZE) {
         m_frameTimeHistory.erase(m_frameTimeHistory.begin());
     }
+    
+    flush();
 }
 
 void PerformanceProfiler::updateFPS(float fps) {
@@ -75,6 +238,29 @@ void PerformanceProfiler::updatePhysicsSteps(int steps) {
     m_currentPhysicsSteps = steps;
 }
 
+void PerformanceProfiler::recordStartupPhase(const std::string& phase, double milliseconds) {
+    m_startupPhases.push_back({phase, milliseconds});
+}
+
+void PerformanceProfiler::recordTimeToFirstFrame(double milliseconds) {
+    m_timeToFirstFrame = milliseconds;
+}
+
+bool PerformanceProfiler::isStartupTargetMet() const {
+    return m_timeToFirstFrame > 0.0 && m_timeToFirstFrame <= m_targetStartupTime;
+}
+
+void PerformanceProfiler::recordCacheCounters(const std::string& name, const HardwareCounters::Sample& sample) {
+    if (!sample.valid) return;
+    
+    auto& total = m_cacheCounters[name];
+    total.l1dAccesses += sample.l1dAccesses;
+    total.l1dMisses += sample.l1dMisses;
+    total.cacheReferences += sample.cacheReferences;
+    total.cacheMisses += sample.cacheMisses;
+    total.valid = true;
+}
+
 PerformanceProfiler::ProfileData PerformanceProfiler::getProfileData(const std::string& name) const {
     ProfileData data;
     data.name = name;
@@ -98,6 +284,27 @@ PerformanceProfiler::ProfileData PerformanceProfiler::getProfileData(const std::
     return data;
 }
 
+size_t PerformanceProfiler::getThreadCount() const {
+    std::lock_guard<std::mutex> lock(m_registryMutex);
+    return m_threadTimings.size();
+}
+
+std::unordered_map<std::string, PerformanceProfiler::ThreadScopeData>
+PerformanceProfiler::getThreadProfileData(size_t threadIndex) const {
+    std::lock_guard<std::mutex> lock(m_registryMutex);
+    if (threadIndex >= m_threadTimings.size()) return {};
+    return m_threadTimings[threadIndex];
+}
+
+uint64_t PerformanceProfiler::getDroppedEventCount() const {
+    std::lock_guard<std::mutex> lock(m_registryMutex);
+    uint64_t dropped = 0;
+    for (const auto& buffer : m_threadBuffers) {
+        dropped += buffer->dropped.load(std::memory_order_relaxed);
+    }
+    return dropped;
+}
+
 float PerformanceProfiler::getAverageFPS() const {
     return calculateAverageFloat(m_fpsHistory);
 }
@@ -128,6 +335,16 @@ std::string PerformanceProfiler::getPerformanceReport() const {
            << calculateMax(m_frameTimeHistory) << " ms\n";
     }
     
+    if (m_timeToFirstFrame > 0.0) {
+        ss << "\n=== Startup ===\n";
+        for (const auto& phase : m_startupPhases) {
+            ss << phase.first << ": " << std::fixed << std::setprecision(2) << phase.second << " ms\n";
+        }
+        ss << "Time to First Frame: " << std::fixed << std::setprecision(2) << m_timeToFirstFrame << " ms\n";
+        ss << "Startup Target: " << m_targetStartupTime << " ms ("
+           << (isStartupTargetMet() ? "MET" : "MISSED") << ")\n";
+    }
+    
     ss << "\n=== Timing Breakdown ===\n";
     for (const auto& pair : m_timingHistory) {
         if (!pair.second.empty()) {
@@ -141,6 +358,36 @@ std::string PerformanceProfiler::getPerformanceReport() const {
         }
     }
     
+    // Only interesting once more than one thread has recorded scopes
+    size_t threadCount = getThreadCount();
+    if (threadCount > 1) {
+        ss << "=== Per-Thread Breakdown ===\n";
+        for (size_t t = 0; t < threadCount; ++t) {
+            ss << "Thread " << t << ":\n";
+            for (const auto& pair : getThreadProfileData(t)) {
+                ss << "  " << pair.first << ": " << pair.second.callCount << " calls, "
+                   << std::fixed << std::setprecision(2) << pair.second.totalTime << " ms total, "
+                   << std::fixed << std::setprecision(3) << pair.second.maxTime << " ms max\n";
+            }
+        }
+        uint64_t dropped = getDroppedEventCount();
+        if (dropped > 0) {
+            ss << "Dropped events (ring full between flushes): " << dropped << "\n";
+        }
+        ss << "\n";
+    }
+    
+    if (!m_cacheCounters.empty()) {
+        ss << "=== Cache Counters ===\n";
+        for (const auto& pair : m_cacheCounters) {
+            ss << pair.first << ":\n";
+            ss << "  L1D Miss Rate: " << std::fixed << std::setprecision(2) << pair.second.l1dMissRate() * 100.0 << "% ("
+               << pair.second.l1dMisses << " / " << pair.second.l1dAccesses << ")\n";
+            ss << "  LLC Miss Rate: " << std::fixed << std::setprecision(2) << pair.second.cacheMissRate() * 100.0 << "% ("
+               << pair.second.cacheMisses << " / " << pair.second.cacheReferences << ")\n\n";
+        }
+    }
+    
     return ss.str();
 }
 
@@ -156,7 +403,15 @@ void PerformanceProfiler::clearHistory() {
     m_frameTimeHistory.clear();
     m_fpsHistory.clear();
     m_particleCountHistory.clear();
-    m_startTimes.clear();
+    m_cacheCounters.clear();
+    
+    // Merge pending events, then discard them with the rest of the history
+    flush();
+    m_timingHistory.clear();
+    std::lock_guard<std::mutex> lock(m_registryMutex);
+    for (auto& timings : m_threadTimings) {
+        timings.clear();
+    }
 }
 
 bool PerformanceProfiler::exportToFile(const std::string& filename) const {
@@ -177,6 +432,15 @@ bool PerformanceProfiler::exportToFile(const std::string& filename) const {
     file << "      \"last_frame_time_ms\": " << m_lastFrameTime << "\n";
     file << "    },\n";
     
+    file << "    \"startup\": {\n";
+    for (const auto& phase : m_startupPhases) {
+        file << "      \"" << phase.first << "_ms\": " << phase.second << ",\n";
+    }
+    file << "      \"time_to_first_frame_ms\": " << m_timeToFirstFrame << ",\n";
+    file << "      \"target_ms\": " << m_targetStartupTime << ",\n";
+    file << "      \"target_met\": " << (isStartupTargetMet() ? "true" : "false") << "\n";
+    file << "    },\n";
+    
     file << "    \"timing_data\": {\n";
     size_t count = 0;
     for (const auto& pair : m_timingHistory) {
@@ -194,6 +458,41 @@ bool PerformanceProfiler::exportToFile(const std::string& filename) const {
             file << "\n";
         }
     }
+    file << "    },\n";
+    
+    file << "    \"threads\": [\n";
+    size_t threadCount = getThreadCount();
+    for (size_t t = 0; t < threadCount; ++t) {
+        const auto timings = getThreadProfileData(t);
+        file << "      {\n";
+        file << "        \"thread_index\": " << t << ",\n";
+        file << "        \"scopes\": {";
+        count = 0;
+        for (const auto& pair : timings) {
+            file << (count++ ? ",\n" : "\n");
+            file << "          \"" << pair.first << "\": {\"call_count\": " << pair.second.callCount
+                 << ", \"total_ms\": " << pair.second.totalTime << ", \"max_ms\": " << pair.second.maxTime << "}";
+        }
+        file << (count ? "\n        }\n" : "}\n");
+        file << "      }" << (t + 1 < threadCount ? "," : "") << "\n";
+    }
+    file << "    ],\n";
+    file << "    \"dropped_timer_events\": " << getDroppedEventCount() << ",\n";
+    
+    file << "    \"cache_counters\": {\n";
+    count = 0;
+    for (const auto& pair : m_cacheCounters) {
+        file << "      \"" << pair.first << "\": {\n";
+        file << "        \"l1d_accesses\": " << pair.second.l1dAccesses << ",\n";
+        file << "        \"l1d_misses\": " << pair.second.l1dMisses << ",\n";
+        file << "        \"l1d_miss_rate\": " << pair.second.l1dMissRate() << ",\n";
+        file << "        \"llc_references\": " << pair.second.cacheReferences << ",\n";
+        file << "        \"llc_misses\": " << pair.second.cacheMisses << ",\n";
+        file << "        \"llc_miss_rate\": " << pair.second.cacheMissRate() << "\n";
+        file << "      }";
+        if (++count < m_cacheCounters.size()) file << ",";
+        file << "\n";
+    }
     file << "    }\n";
     file << "  }\n";
     file << "}\n";
@@ -1,11 +1,24 @@
 #ifndef PERFORMANCE_PROFILER_H
 #define PERFORMANCE_PROFILER_H
 
+#include "HardwareCounters.h"
+#include "TscClock.h"
+#include <atomic>
 #include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 #include <unordered_map>
 
+class FlightRecorder;
+
+// Timers may be used from any thread. Each thread records into its own buffer
+// (registered with the profiler on first use) through a single-producer ring,
+// so the hot path takes no locks; endFrame()/flush() drains all rings into the
+// aggregated history and the per-thread breakdown. Everything else (frame, FPS,
+// startup, counters, reports) belongs to the thread that drives the frame loop.
 class PerformanceProfiler {
 public:
     struct ProfileData {
@@ -17,24 +30,86 @@ public:
         std::string name;
     };
     
+    // Merged totals for one scope on one thread
+    struct ThreadScopeData {
+        double totalTime;
+        double maxTime;
+        int callCount;
+    };
+    
+    // Clock behind the timers: std::chrono (vDSO clock_gettime, tens of ns per
+    // read) or the invariant TSC (a few ns; see TscClock)
+    enum class TimerSource {
+        Chrono,
+        Tsc
+    };
+    
     PerformanceProfiler();
     ~PerformanceProfiler();
     
-    // Timing functions
+    // Select before timing anything; returns false (and keeps Chrono) when the TSC is not usable
+    bool setTimerSource(TimerSource source);
+    TimerSource getTimerSource() const { return m_timerSource; }
+    
+    // Current time in timer ticks
+    uint64_t now() const {
+        if (m_timerSource == TimerSource::Tsc) return TscClock::now();
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::high_resolution_clock::now().time_since_epoch()).count());
+    }
+    
+    // Timing functions (any thread; start and end on the same thread)
     void startTimer(const std::string& name);
     void endTimer(const std::string& name);
     
-    // Frame timing
+private:
+    struct ThreadBuffer; // per-thread ring, interned names and open timers
+    
+public:
+    // What one PROFILE_SCOPE call site caches per thread: the scope id and this
+    // thread's buffer in the profiler it last ran with. Zero-initialized, so a
+    // thread_local instance needs no guard; a different profiler rebinds it.
+    struct CallSite {
+        uint64_t instanceId;
+        uint32_t scopeId;
+        ThreadBuffer* buffer;
+    };
+    
+    // Hot path used by ScopedTimer: `name` must outlive the profiler (a literal)
+    void bindCallSite(CallSite& site, const char* name);
+    bool isBound(const CallSite& site) const { return site.instanceId == m_instanceId; }
+    void recordScope(const CallSite& site, uint64_t startTicks, uint64_t endTicks);
+    uint32_t getScopeId(const char* name);
+    void recordScope(uint32_t scopeId, uint64_t startTicks, uint64_t endTicks);
+    
+    // Merged scope events are also forwarded here (optional, not owned)
+    void setFlightRecorder(FlightRecorder* recorder) { m_flightRecorder = recorder; }
+    
+    // Frame timing; endFrame() also merges the per-thread buffers
     void beginFrame();
     void endFrame();
+    void flush();
     
     // System metrics
     void updateFPS(float fps);
     void updateParticleCount(int count);
     void updatePhysicsSteps(int steps);
     
-    // Data access
+    // Startup timing (time-to-first-frame breakdown)
+    void recordStartupPhase(const std::string& phase, double milliseconds);
+    void recordTimeToFirstFrame(double milliseconds);
+    double getTimeToFirstFrame() const { return m_timeToFirstFrame; }
+    bool isStartupTargetMet() const;
+    
+    // Hardware counter samples, accumulated per scope name
+    void recordCacheCounters(const std::string& name, const HardwareCounters::Sample& sample);
+    
+    // Data access (timings as of the last endFrame()/flush())
     ProfileData getProfileData(const std::string& name) const;
+    size_t getThreadCount() const;
+    // A copy: flush() and threads registering their buffers modify the originals
+    std::unordered_map<std::string, ThreadScopeData> getThreadProfileData(size_t threadIndex) const;
+    uint64_t getDroppedEventCount() const;
     float getCurrentFPS() const { return m_currentFPS; }
     float getAverageFPS() const;
     int getCurrentParticleCount() const { return m_currentParticleCount; }
@@ -47,6 +122,7 @@ public:
     // Configuration
     void setTargetFPS(float target) { m_targetFPS = target; }
     void setTargetPhysicsSteps(int target) { m_targetPhysicsSteps = target; }
+    void setTargetStartupTime(double milliseconds) { m_targetStartupTime = milliseconds; }
     
     // Reset and cleanup
     void reset();
@@ -56,9 +132,22 @@ public:
     bool exportToFile(const std::string& filename) const;
     
 private:
-    // Timer data
-    std::unordered_map<std::string, std::chrono::high_resolution_clock::time_point> m_startTimes;
+    // Thread registration and scope names (cold path only)
+    const uint64_t m_instanceId;
+    mutable std::mutex m_registryMutex;
+    std::vector<std::unique_ptr<ThreadBuffer>> m_threadBuffers;
+    std::vector<std::string> m_scopeNames;
+    std::unordered_map<std::string, uint32_t> m_scopeIds;
+    
+    TimerSource m_timerSource;
+    double m_millisecondsPerTick;
+    uint64_t m_epochTicks; // scope start times are relative to this
+    FlightRecorder* m_flightRecorder;
+    
+    // Aggregated timer data (written by flush())
     std::unordered_map<std::string, std::vector<double>> m_timingHistory;
+    std::vector<std::unordered_map<std::string, ThreadScopeData>> m_threadTimings;
+    std::unordered_map<std::string, HardwareCounters::Sample> m_cacheCounters;
     
     // Frame timing
     std::chrono::high_resolution_clock::time_point m_frameStartTime;
@@ -72,9 +161,14 @@ private:
     std::vector<int> m_particleCountHistory;
     int m_currentPhysicsSteps;
     
+    // Startup metrics (phases kept in the order they were recorded)
+    std::vector<std::pair<std::string, double>> m_startupPhases;
+    double m_timeToFirstFrame;
+    
     // Targets
     float m_targetFPS;
     int m_targetPhysicsSteps;
+    double m_targetStartupTime;
     
     // History limits
     static const size_t MAX_HISTORY_SIZE = 1000;
@@ -86,26 +180,59 @@ private:
     float calculateAverageFloat(const std::vector<float>& values) const;
     
     void trimHistory();
+    
+    ThreadBuffer& getThreadBuffer();
+    uint32_t internScope(const std::string& name);
+    
+    static std::atomic<uint64_t> s_nextInstanceId;
 };
 
 // RAII Timer class for automatic timing
 class ScopedTimer {
 public:
-    ScopedTimer(PerformanceProfiler& profiler, const std::string& name)
-        : m_profiler(profiler), m_name(name) {
-        m_profiler.startTimer(m_name);
+    ScopedTimer(PerformanceProfiler& profiler, const char* name)
+        : ScopedTimer(&profiler, name) {
+    }
+    
+    // Optional profiler (e.g. one attached to an engine); a null profiler times nothing
+    ScopedTimer(PerformanceProfiler* profiler, const char* name)
+        : m_profiler(profiler), m_site(), m_start(0) {
+        if (m_profiler) {
+            m_profiler->bindCallSite(m_site, name);
+            m_start = m_profiler->now();
+        }
+    }
+    
+    // With a call-site cache (PROFILE_SCOPE): after the first entry on a thread
+    // the id and buffer lookups reduce to one comparison
+    ScopedTimer(PerformanceProfiler& profiler, PerformanceProfiler::CallSite& site, const char* name)
+        : ScopedTimer(&profiler, site, name) {
+    }
+    
+    ScopedTimer(PerformanceProfiler* profiler, PerformanceProfiler::CallSite& site, const char* name)
+        : m_profiler(profiler), m_site(), m_start(0) {
+        if (m_profiler) {
+            if (!m_profiler->isBound(site)) m_profiler->bindCallSite(site, name);
+            m_site = site;
+            m_start = m_profiler->now();
+        }
     }
     
     ~ScopedTimer() {
-        m_profiler.endTimer(m_name);
+        if (m_profiler) {
+            m_profiler->recordScope(m_site, m_start, m_profiler->now());
+        }
     }
     
 private:
-    PerformanceProfiler& m_profiler;
-    std::string m_name;
+    PerformanceProfiler* m_profiler;
+    PerformanceProfiler::CallSite m_site;
+    uint64_t m_start; // profiler ticks
 };
 
-// Macro for easy profiling
-#define PROFILE_SCOPE(profiler, name) ScopedTimer _timer(profiler, name)
+// Macro for easy profiling; each use keeps its own per-thread call-site cache
+#define PROFILE_SCOPE(profiler, name) \
+    static thread_local PerformanceProfiler::CallSite _timerSite; \
+    ScopedTimer _timer(profiler, _timerSite, name)
 
 #endif // PERFORMANCE_PROFILER_H
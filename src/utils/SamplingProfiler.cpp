@@ -0,0 +1,280 @@
+#include "SamplingProfiler.h"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <unordered_map>
+
+#ifdef __linux__
+#include <cerrno>
+#include <csignal>
+#include <cstdlib>
+#include <cxxabi.h>
+#include <dlfcn.h>
+#include <execinfo.h>
+#include <sys/time.h>
+#include <time.h>
+#include <ucontext.h>
+
+namespace {
+
+uint64_t readClock(clockid_t clock) {
+    timespec now;
+    clock_gettime(clock, &now); // async-signal-safe
+    return static_cast<uint64_t>(now.tv_sec) * 1000000000ULL + static_cast<uint64_t>(now.tv_nsec);
+}
+
+// Instruction the signal interrupted, from the saved register state; nullptr
+// on architectures not listed here
+void* interruptedInstruction(void* context) {
+    const ucontext_t* state = static_cast<const ucontext_t*>(context);
+#if defined(__x86_64__)
+    return reinterpret_cast<void*>(state->uc_mcontext.gregs[REG_RIP]);
+#elif defined(__i386__)
+    return reinterpret_cast<void*>(state->uc_mcontext.gregs[REG_EIP]);
+#elif defined(__aarch64__)
+    return reinterpret_cast<void*>(state->uc_mcontext.pc);
+#else
+    (void)state;
+    return nullptr;
+#endif
+}
+
+// Folded-stack frame name: demangled symbol, else module+offset
+std::string symbolize(void* address) {
+    Dl_info info;
+    if (dladdr(address, &info) && info.dli_sname) {
+        int status = 0;
+        char* demangled = abi::__cxa_demangle(info.dli_sname, nullptr, nullptr, &status);
+        std::string name = (status == 0 && demangled) ? demangled : info.dli_sname;
+        std::free(demangled);
+        return name;
+    }
+
+    std::string module = "??";
+    uintptr_t offset = reinterpret_cast<uintptr_t>(address);
+    if (dladdr(address, &info) && info.dli_fname) {
+        module = info.dli_fname;
+        module = module.substr(module.find_last_of('/') + 1);
+        offset -= reinterpret_cast<uintptr_t>(info.dli_fbase);
+    }
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "+0x%zx", static_cast<size_t>(offset));
+    return module + buffer;
+}
+
+// Folded format uses ';' between frames and ' ' before the count
+std::string sanitizeFrame(std::string name) {
+    std::replace(name.begin(), name.end(), ';', ':');
+    std::replace(name.begin(), name.end(), ' ', '_');
+    return name;
+}
+
+struct sigaction s_previousAction;
+
+} // namespace
+#endif
+
+std::atomic<SamplingProfiler*> SamplingProfiler::s_active(nullptr);
+std::atomic<int> SamplingProfiler::s_handlersInFlight(0);
+
+SamplingProfiler::SamplingProfiler(size_t maxSamples)
+    : m_samples(maxSamples)
+    , m_writeIndex(0)
+    , m_dropped(0)
+    , m_handlerNanoseconds(0)
+    , m_running(false)
+    , m_frequencyHz(0)
+    , m_cpuStartNanoseconds(0)
+    , m_cpuNanoseconds(0) {
+}
+
+SamplingProfiler::~SamplingProfiler() {
+    stop();
+}
+
+bool SamplingProfiler::start(int frequencyHz) {
+#ifdef __linux__
+    if (m_running) return true;
+    if (frequencyHz <= 0 || frequencyHz > 100000) {
+        std::cerr << "Invalid sampling frequency: " << frequencyHz << " Hz" << std::endl;
+        return false;
+    }
+
+    SamplingProfiler* expected = nullptr;
+    if (!s_active.compare_exchange_strong(expected, this)) {
+        std::cerr << "Another sampling profiler is already running" << std::endl;
+        return false;
+    }
+
+    // backtrace() loads libgcc on first use, which allocates; do that here, not in the handler
+    void* warmup[4];
+    backtrace(warmup, 4);
+
+    m_writeIndex = 0;
+    m_dropped = 0;
+    m_handlerNanoseconds = 0;
+    m_frequencyHz = frequencyHz;
+
+    struct sigaction action;
+    action.sa_sigaction = &SamplingProfiler::handleSignal;
+    sigemptyset(&action.sa_mask);
+    action.sa_flags = SA_RESTART | SA_SIGINFO;
+    if (sigaction(SIGPROF, &action, &s_previousAction) != 0) {
+        std::cerr << "Failed to install SIGPROF handler" << std::endl;
+        s_active = nullptr;
+        return false;
+    }
+
+    // ITIMER_PROF counts CPU time of the whole process, so busy threads get sampled
+    itimerval timer;
+    timer.it_interval.tv_sec = 0;
+    timer.it_interval.tv_usec = std::max(1, 1000000 / frequencyHz);
+    timer.it_value = timer.it_interval;
+    m_cpuStartNanoseconds = readClock(CLOCK_PROCESS_CPUTIME_ID);
+    if (setitimer(ITIMER_PROF, &timer, nullptr) != 0) {
+        std::cerr << "Failed to start profiling timer" << std::endl;
+        sigaction(SIGPROF, &s_previousAction, nullptr);
+        s_active = nullptr;
+        return false;
+    }
+
+    m_running = true;
+    return true;
+#else
+    (void)frequencyHz;
+    std::cerr << "Sampling profiler is only available on Linux" << std::endl;
+    return false;
+#endif
+}
+
+void SamplingProfiler::stop() {
+#ifdef __linux__
+    if (!m_running) return;
+
+    itimerval timer = {};
+    setitimer(ITIMER_PROF, &timer, nullptr);
+    m_cpuNanoseconds = readClock(CLOCK_PROCESS_CPUTIME_ID) - m_cpuStartNanoseconds;
+
+    // Let handlers already running on other threads finish before anyone reads
+    // the buffer. A handler that entered before this store is counted in
+    // s_handlersInFlight; one that enters after it sees nullptr.
+    s_active = nullptr;
+    while (s_handlersInFlight.load() > 0) {
+    }
+    sigaction(SIGPROF, &s_previousAction, nullptr);
+    m_running = false;
+#endif
+}
+
+void SamplingProfiler::handleSignal(int signal, siginfo_t* info, void* context) {
+    (void)signal;
+    (void)info;
+#ifdef __linux__
+    int savedErrno = errno;
+    s_handlersInFlight.fetch_add(1);
+    SamplingProfiler* profiler = s_active.load();
+    if (profiler) {
+        profiler->recordSample(interruptedInstruction(context));
+    }
+    s_handlersInFlight.fetch_sub(1);
+    errno = savedErrno;
+#endif
+}
+
+void SamplingProfiler::recordSample(void* interruptedPc) {
+#ifdef __linux__
+    uint64_t begin = readClock(CLOCK_MONOTONIC);
+
+    size_t index = m_writeIndex.fetch_add(1, std::memory_order_relaxed);
+    if (index < m_samples.size()) {
+        Sample& sample = m_samples[index];
+        int depth = backtrace(sample.frames, MAX_DEPTH);
+
+        // The stack starts at the interrupted instruction: the unwinder reports it
+        // right after the handler frames and the kernel's signal trampoline. If it
+        // is missing (no unwind info past the trampoline), it leads the stack anyway.
+        int leaf = std::min(depth, SKIPPED_FRAMES);
+        bool found = false;
+        for (int i = 0; i < depth && interruptedPc; ++i) {
+            if (sample.frames[i] == interruptedPc) {
+                leaf = i;
+                found = true;
+                break;
+            }
+        }
+        // Compacted in place: the write slot never passes the read slot
+        int kept = 0;
+        if (interruptedPc && !found) {
+            sample.frames[kept++] = interruptedPc;
+        }
+        for (int i = leaf; i < depth; ++i) {
+            sample.frames[kept++] = sample.frames[i];
+        }
+        sample.depth = kept;
+    } else {
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    m_handlerNanoseconds.fetch_add(readClock(CLOCK_MONOTONIC) - begin, std::memory_order_relaxed);
+#endif
+}
+
+size_t SamplingProfiler::getSampleCount() const {
+    return std::min(m_writeIndex.load(), m_samples.size());
+}
+
+double SamplingProfiler::getOverheadPercent() const {
+    uint64_t cpu = m_running ? 0 : m_cpuNanoseconds;
+    return cpu ? 100.0 * static_cast<double>(m_handlerNanoseconds.load()) / cpu : 0.0;
+}
+
+bool SamplingProfiler::writeFoldedStacks(const std::string& filename) const {
+#ifdef __linux__
+    if (m_running) {
+        std::cerr << "Stop the sampling profiler before writing " << filename << std::endl;
+        return false;
+    }
+
+    // Identical stacks are merged first, so each distinct address is symbolized once
+    std::map<std::vector<void*>, size_t> stackCounts;
+    size_t sampleCount = getSampleCount();
+    for (size_t i = 0; i < sampleCount; ++i) {
+        const Sample& sample = m_samples[i];
+        if (sample.depth <= 0) continue;
+        std::vector<void*> stack(sample.frames, sample.frames + sample.depth);
+        stackCounts[stack]++;
+    }
+
+    std::unordered_map<void*, std::string> symbols;
+    std::ofstream file(filename);
+    if (!file.is_open()) {
+        std::cerr << "Failed to open folded stack file: " << filename << std::endl;
+        return false;
+    }
+
+    for (const auto& entry : stackCounts) {
+        const std::vector<void*>& stack = entry.first;
+        std::string line;
+        // Root first; the leaf is the interrupted instruction itself, but callers
+        // are return addresses that point past the call, so look up address - 1
+        for (size_t i = stack.size(); i-- > 0;) {
+            void* lookup = i == 0 ? stack[i] : static_cast<char*>(stack[i]) - 1;
+            auto it = symbols.find(lookup);
+            if (it == symbols.end()) {
+                it = symbols.emplace(lookup, sanitizeFrame(symbolize(lookup))).first;
+            }
+            if (!line.empty()) line += ';';
+            line += it->second;
+        }
+        file << line << ' ' << entry.second << '\n';
+    }
+
+    file.close();
+    return true;
+#else
+    std::cerr << "Sampling profiler is only available on Linux (" << filename << " not written)" << std::endl;
+    return false;
+#endif
+}
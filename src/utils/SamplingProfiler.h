@@ -0,0 +1,76 @@
+#ifndef SAMPLING_PROFILER_H
+#define SAMPLING_PROFILER_H
+
+#include <atomic>
+#include <csignal>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Statistical CPU profiler: a SIGPROF timer interrupts whichever thread is
+// running, and the signal handler copies that thread's call stack into a
+// preallocated buffer (one atomic slot claim, no locks, no allocation). Each
+// stack starts at the interrupted instruction, taken from the signal context,
+// so neither the handler nor the kernel's signal trampoline appears in it.
+// Symbolization (dladdr + demangling) happens after stop(), and the result is
+// written as folded stacks ("main;update;handleCollisions 42") for flamegraph.pl
+// or speedscope. Functions with internal linkage show up as module+offset, and
+// executable symbols need -rdynamic (ENABLE_EXPORTS in CMake) to resolve.
+//
+// Linux only; start() returns false elsewhere. One profiler can run at a time.
+// Profiling timers tick with the kernel (CONFIG_HZ), so rates above it are
+// delivered at the tick rate. The handler costs a few microseconds (a
+// backtrace), about 0.3% of CPU time at 997 Hz; see getOverheadPercent().
+class SamplingProfiler {
+public:
+    explicit SamplingProfiler(size_t maxSamples = 65536);
+    ~SamplingProfiler();
+
+    SamplingProfiler(const SamplingProfiler&) = delete;
+    SamplingProfiler& operator=(const SamplingProfiler&) = delete;
+
+    // Sampling rate in CPU-time Hz; a prime default avoids lockstep with 60 Hz / 1 kHz loops
+    bool start(int frequencyHz = 997);
+    void stop();
+    bool isRunning() const { return m_running; }
+
+    // Offline symbolization and export (call after stop())
+    bool writeFoldedStacks(const std::string& filename) const;
+
+    size_t getSampleCount() const;
+    uint64_t getDroppedSampleCount() const { return m_dropped.load(); }
+    // Time spent in the signal handler as a share of process CPU time while sampling
+    double getOverheadPercent() const;
+
+private:
+    static const int MAX_DEPTH = 32;
+    // recordSample, the handler and the signal trampoline; only used when the
+    // interrupted instruction is not in the backtrace
+    static const int SKIPPED_FRAMES = 3;
+
+    struct Sample {
+        void* frames[MAX_DEPTH]; // leaf (interrupted instruction) first
+        int depth;
+    };
+
+    std::vector<Sample> m_samples;
+    std::atomic<size_t> m_writeIndex;
+    std::atomic<uint64_t> m_dropped;
+    std::atomic<uint64_t> m_handlerNanoseconds;
+    bool m_running;
+    int m_frequencyHz;
+    uint64_t m_cpuStartNanoseconds;
+    uint64_t m_cpuNanoseconds;
+
+    void recordSample(void* interruptedPc);
+    static void handleSignal(int signal, siginfo_t* info, void* context);
+
+    static std::atomic<SamplingProfiler*> s_active;
+    // Handlers between entry and exit. Raised before s_active is loaded, so
+    // stop() can clear s_active and then wait for every handler that may
+    // still hold the old pointer.
+    static std::atomic<int> s_handlersInFlight;
+};
+
+#endif // SAMPLING_PROFILER_H
@@ -0,0 +1,101 @@
+#include "ThreadPool.h"
+#include <algorithm>
+
+size_t ThreadPool::s_sharedThreadCount = 0;
+
+ThreadPool::ThreadPool(size_t threadCount)
+    : m_function(nullptr)
+    , m_begin(0)
+    , m_chunkSize(0)
+    , m_chunkCount(0)
+    , m_end(0)
+    , m_generation(0)
+    , m_pendingChunks(0)
+    , m_stopping(false) {
+    if (threadCount == 0) {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    // The calling thread always runs chunk 0, so spawn one fewer worker
+    for (size_t i = 1; i < threadCount; ++i) {
+        m_workers.emplace_back(&ThreadPool::workerLoop, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_workAvailable.notify_all();
+    for (auto& worker : m_workers) {
+        worker.join();
+    }
+}
+
+void ThreadPool::parallelFor(size_t begin, size_t end, const RangeFunction& function, size_t minChunkSize) {
+    if (end <= begin) return;
+
+    size_t count = end - begin;
+    size_t chunkCount = std::min(getThreadCount(), std::max<size_t>(1, count / std::max<size_t>(1, minChunkSize)));
+    if (chunkCount <= 1) {
+        function(begin, end, 0);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_function = &function;
+        m_begin = begin;
+        m_end = end;
+        m_chunkCount = chunkCount;
+        m_chunkSize = (count + chunkCount - 1) / chunkCount;
+        m_pendingChunks.store(chunkCount - 1);
+        m_generation++;
+    }
+    m_workAvailable.notify_all();
+
+    runChunk(0);
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_workDone.wait(lock, [this] { return m_pendingChunks.load() == 0; });
+    m_function = nullptr;
+}
+
+void ThreadPool::workerLoop(size_t threadIndex) {
+    size_t seenGeneration = 0;
+
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_workAvailable.wait(lock, [&] { return m_stopping || m_generation != seenGeneration; });
+            if (m_stopping) return;
+            seenGeneration = m_generation;
+            if (threadIndex >= m_chunkCount) continue; // not needed for this job
+        }
+
+        runChunk(threadIndex);
+
+        if (m_pendingChunks.fetch_sub(1) == 1) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_workDone.notify_one();
+        }
+    }
+}
+
+void ThreadPool::runChunk(size_t chunkIndex) const {
+    size_t chunkBegin = m_begin + chunkIndex * m_chunkSize;
+    size_t chunkEnd = std::min(m_end, chunkBegin + m_chunkSize);
+    if (chunkBegin < chunkEnd) {
+        (*m_function)(chunkBegin, chunkEnd, chunkIndex);
+    }
+}
+
+ThreadPool& ThreadPool::shared() {
+    static ThreadPool pool(s_sharedThreadCount);
+    return pool;
+}
+
+void ThreadPool::setSharedThreadCount(size_t threadCount) {
+    s_sharedThreadCount = threadCount;
+}
@@ -0,0 +1,85 @@
+#include "TscClock.h"
+#include <fstream>
+#include <string>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#endif
+
+namespace {
+
+// CPUID.80000007H:EDX[8], or a Linux kernel that itself chose the TSC as its
+// clocksource (it only does so after verifying the TSC is stable; VMs often
+// hide the CPUID bit but still pass this check)
+bool detectInvariantCounter() {
+#if defined(__x86_64__) || defined(__i386__)
+    unsigned int eax, ebx, ecx, edx;
+    if (__get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx) && (edx & (1u << 8))) {
+        return true;
+    }
+    std::ifstream clocksource("/sys/devices/system/clocksource/clocksource0/current_clocksource");
+    std::string name;
+    return clocksource >> name && name == "tsc";
+#elif defined(__aarch64__)
+    return true; // the generic timer has a fixed frequency by architecture
+#else
+    return false;
+#endif
+}
+
+} // namespace
+
+TscClock::Calibration TscClock::calibrate() {
+    Calibration result;
+    result.invariant = detectInvariantCounter();
+    result.ticksPerSecond = 0.0;
+    if (!result.invariant) return result;
+
+#if defined(__aarch64__)
+    uint64_t frequency;
+    asm volatile("mrs %0, cntfrq_el0" : "=r"(frequency));
+    result.ticksPerSecond = static_cast<double>(frequency);
+#else
+    // Count ticks across a ~20 ms busy wait on the steady clock. Bracketing each
+    // clock read with counter reads keeps the error to a few ticks per end.
+    using Clock = std::chrono::steady_clock;
+    uint64_t tickStart = now();
+    Clock::time_point clockStart = Clock::now();
+    uint64_t tickStartAfter = now();
+
+    Clock::time_point clockEnd;
+    uint64_t tickEnd, tickEndAfter;
+    do {
+        tickEnd = now();
+        clockEnd = Clock::now();
+        tickEndAfter = now();
+    } while (clockEnd - clockStart < std::chrono::milliseconds(20));
+
+    double seconds = std::chrono::duration<double>(clockEnd - clockStart).count();
+    double ticks = 0.5 * static_cast<double>(tickEnd + tickEndAfter) - 0.5 * static_cast<double>(tickStart + tickStartAfter);
+    result.ticksPerSecond = ticks / seconds;
+#endif
+    return result;
+}
+
+const TscClock::Calibration& TscClock::calibration() {
+    static const Calibration result = calibrate();
+    return result;
+}
+
+bool TscClock::isAvailable() {
+    return calibration().invariant && calibration().ticksPerSecond > 0.0;
+}
+
+bool TscClock::isInvariant() {
+    return calibration().invariant;
+}
+
+double TscClock::getTicksPerSecond() {
+    return calibration().ticksPerSecond;
+}
+
+double TscClock::getMillisecondsPerTick() {
+    double ticksPerSecond = calibration().ticksPerSecond;
+    return ticksPerSecond > 0.0 ? 1000.0 / ticksPerSecond : 0.0;
+}
@@ -0,0 +1,50 @@
+#ifndef TSC_CLOCK_H
+#define TSC_CLOCK_H
+
+#include <chrono>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+// Raw cycle-counter clock for fine-grained instrumentation: RDTSC on x86,
+// the generic timer (CNTVCT_EL0) on AArch64. A read costs a few ns against
+// tens of ns for a clock_gettime vDSO call, but ticks have to be converted with
+// a frequency measured at startup, and the counter is only usable as a clock
+// when it runs at a constant rate on every core (invariant TSC).
+// isAvailable() is false where that cannot be established; callers fall back to
+// std::chrono then.
+class TscClock {
+public:
+    static uint64_t now() {
+#if defined(__x86_64__) || defined(__i386__)
+        return __rdtsc();
+#elif defined(__aarch64__)
+        uint64_t ticks;
+        asm volatile("mrs %0, cntvct_el0" : "=r"(ticks));
+        return ticks;
+#else
+        return static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+    }
+
+    // Invariant counter present and calibrated (calibrates on first call, ~20 ms)
+    static bool isAvailable();
+    static bool isInvariant();
+
+    static double getTicksPerSecond();
+    static double ticksToMilliseconds(uint64_t ticks) { return ticks * getMillisecondsPerTick(); }
+    static double getMillisecondsPerTick();
+
+private:
+    struct Calibration {
+        bool invariant;
+        double ticksPerSecond;
+    };
+
+    static const Calibration& calibration();
+    static Calibration calibrate();
+};
+
+#endif // TSC_CLOCK_H